@@ -3344,6 +3344,8 @@ typedef struct stats_info_response_msg {
 	uint32_t *schedule_exit;
 	uint32_t schedule_exit_cnt;
 	uint32_t schedule_queue_len;
+	uint64_t schedule_arena_alloc_cnt; /* last cycle arena allocations */
+	uint64_t schedule_arena_alloc_bytes; /* last cycle arena bytes */
 
 	uint32_t jobs_submitted;
 	uint32_t jobs_started;
@@ -3374,6 +3376,22 @@ typedef struct stats_info_response_msg {
 	uint32_t bf_table_size_sum;
 	time_t   bf_when_last_cycle;
 	uint32_t bf_active;
+	uint64_t bf_arena_alloc_cnt; /* last cycle arena allocations */
+	uint64_t bf_arena_alloc_bytes; /* last cycle arena bytes */
+
+	uint64_t avail_cache_hits; /* node selection results reused */
+	uint64_t avail_cache_misses; /* node selection results computed */
+
+	uint32_t dbd_agent_batch_cnt; /* RPCs sent to the SlurmDBD */
+	uint32_t dbd_agent_batch_max; /* most messages sent in one RPC */
+	uint64_t dbd_agent_msg_cnt; /* messages sent to the SlurmDBD */
+	uint64_t dbd_agent_usec; /* usec sending RPCs to the SlurmDBD */
+	uint64_t dbd_agent_usec_max; /* longest usec for one RPC */
+
+	uint32_t lock_stats_cnt; /* slurmctld lock types * {read, write} */
+	uint64_t *lock_wait_cnt; /* lock requests which had to wait */
+	uint64_t *lock_wait_time; /* usec spent waiting */
+	uint64_t *lock_wait_max; /* max usec spent waiting */
 
 	uint32_t rpc_type_size;
 	uint16_t *rpc_type_id;
@@ -3384,6 +3402,7 @@ typedef struct stats_info_response_msg {
 	uint64_t *rpc_type_dropped;
 	uint16_t *rpc_type_cycle_last;
 	uint16_t *rpc_type_cycle_max;
+	uint64_t *rpc_type_coalesced;
 
 	uint32_t rpc_user_size;
 	uint32_t *rpc_user_id;
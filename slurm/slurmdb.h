@@ -660,6 +660,8 @@ struct slurmdb_assoc_usage {
 					 * (DON'T PACK) */
 	uint16_t *grp_node_job_cnt;	/* Count of jobs allocated on each node
 					 * (DON'T PACK) */
+	bool grp_tres_unlimited; /* No GrpTRES, GrpTRESMins or GrpTRESRunMins
+				  * limit is set (DON'T PACK) */
 	uint64_t *grp_used_tres; /* array of active tres counts
 				  * (DON'T PACK for state file) */
 	uint64_t *grp_used_tres_run_secs; /* array of running tres secs
@@ -670,6 +672,8 @@ struct slurmdb_assoc_usage {
 				 * (DON'T PACK for state file) */
 	uint32_t level_shares;  /* number of shares on this level of
 				 * the tree (DON'T PACK for state file) */
+	bool max_tres_unlimited; /* No MaxTRES, MaxTRESPerNode or MaxTRESMins
+				  * limit is set (DON'T PACK) */
 
 	slurmdb_assoc_rec_t *parent_assoc_ptr; /* ptr to direct
 						* parent assoc
@@ -711,6 +715,9 @@ struct slurmdb_assoc_usage {
 	long double level_fs;	/* (FAIR_TREE) Result of fairshare equation
 				 * compared to the association's siblings
 				 * (DON'T PACK for state file) */
+	bool fs_dirty;		/* (FAIR_TREE) Usage of this association
+				 * changed since its children were last
+				 * sorted by level_fs (DON'T PACK) */
 
 	bitstr_t *valid_qos;    /* qos available for this association
 				 * derived from the qos_list.
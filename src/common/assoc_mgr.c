@@ -75,6 +75,7 @@ uint32_t g_assoc_max_priority = 0;
 uint32_t g_qos_count = 0;
 uint32_t g_user_assoc_count = 0;
 uint32_t g_tres_count = 0;
+uint32_t g_assoc_mgr_update_gen = 0;
 
 list_t *assoc_mgr_tres_list = NULL;
 slurmdb_tres_rec_t **assoc_mgr_tres_array = NULL;
@@ -1022,6 +1023,38 @@ static int _set_assoc_parent_and_user(slurmdb_assoc_rec_t *assoc)
 	return SLURM_SUCCESS;
 }
 
+static bool _tres_cnt_unlimited(uint64_t *tres_cnt)
+{
+	if (!tres_cnt)
+		return false;
+
+	for (int i = 0; i < g_tres_count; i++) {
+		if (tres_cnt[i] != INFINITE64)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Remember if the association has no TRES limits at all so the scheduler's
+ * limit checks can skip it instead of comparing every TRES.
+ */
+static void _set_assoc_tres_unlimited(slurmdb_assoc_rec_t *assoc)
+{
+	if (!assoc->usage)
+		return;
+
+	assoc->usage->grp_tres_unlimited =
+		(_tres_cnt_unlimited(assoc->grp_tres_ctld) &&
+		 _tres_cnt_unlimited(assoc->grp_tres_mins_ctld) &&
+		 _tres_cnt_unlimited(assoc->grp_tres_run_mins_ctld));
+	assoc->usage->max_tres_unlimited =
+		(_tres_cnt_unlimited(assoc->max_tres_ctld) &&
+		 _tres_cnt_unlimited(assoc->max_tres_pn_ctld) &&
+		 _tres_cnt_unlimited(assoc->max_tres_mins_ctld));
+}
+
 static void _set_assoc_norm_priority(slurmdb_assoc_rec_t *assoc)
 {
 	if (!assoc)
@@ -1147,6 +1180,7 @@ static int _post_assoc_list(void)
 
 	//START_TIMER;
 	g_user_assoc_count = 0;
+	g_assoc_mgr_update_gen++;
 	while ((assoc = list_next(itr))) {
 		_set_assoc_parent_and_user(assoc);
 		_add_assoc_hash(assoc);
@@ -1247,6 +1281,7 @@ static int _post_qos_list(list_t *qos_list)
 
 	g_qos_count = 0;
 	g_qos_max_priority = 0;
+	g_assoc_mgr_update_gen++;
 
 	while ((qos = list_next(itr))) {
 		if (qos->flags & QOS_FLAG_NOTSET)
@@ -4244,6 +4279,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 
 			/* info("now rec has def of %d", rec->def_qos_id); */
 
+			_set_assoc_tres_unlimited(rec);
+
 			if (update_jobs && init_setup.update_assoc_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -4395,6 +4432,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 		slurmdb_destroy_assoc_rec(object);
 	}
 
+	g_assoc_mgr_update_gen++;
+
 	if (redo_priority)
 		_calculate_assoc_norm_priorities(redo_priority == 2);
 
@@ -5243,6 +5282,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 		_post_qos_list(assoc_mgr_qos_list);
 
 	list_iterator_destroy(itr);
+	g_assoc_mgr_update_gen++;
 
 	if (!locked)
 		assoc_mgr_unlock(&locks);
@@ -6781,6 +6821,8 @@ extern void assoc_mgr_set_assoc_tres_cnt(slurmdb_assoc_rec_t *assoc)
 	assoc_mgr_set_tres_cnt_array(&assoc->max_tres_run_mins_ctld,
 				     assoc->max_tres_run_mins, INFINITE64, 1,
 				     false, NULL);
+
+	_set_assoc_tres_unlimited(assoc);
 }
 
 /* tres read and qos write locks need to be locked before this is called. */
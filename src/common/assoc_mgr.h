@@ -124,6 +124,9 @@ extern uint32_t g_user_assoc_count; /* Number of associations which are users */
 extern uint32_t g_tres_count; /* Number of TRES from the database
 			       * which also is the number of elements
 			       * in the assoc_mgr_tres_array */
+extern uint32_t g_assoc_mgr_update_gen; /* Bumped whenever association or
+					* qos records are loaded or
+					* modified */
 
 extern int assoc_mgr_init(void *db_conn, assoc_init_args_t *args,
 			  int db_conn_errno);
@@ -137,6 +137,7 @@ strong_alias(bit_not,		slurm_bit_not);
 strong_alias(bit_or,		slurm_bit_or);
 strong_alias(bit_set_count,	slurm_bit_set_count);
 strong_alias(bit_set_count_range, slurm_bit_set_count_range);
+strong_alias(bit_set_count_range_not, slurm_bit_set_count_range_not);
 strong_alias(bit_clear_count,	slurm_bit_clear_count);
 strong_alias(bit_rotate_copy,	slurm_bit_rotate_copy);
 strong_alias(bit_rotate,	slurm_bit_rotate);
@@ -153,10 +154,15 @@ strong_alias(bit_fill_gaps,	slurm_bit_fill_gaps);
 strong_alias(bit_super_set,	slurm_bit_super_set);
 strong_alias(bit_overlap,	slurm_bit_overlap);
 strong_alias(bit_overlap_any,	slurm_bit_overlap_any);
+strong_alias(bit_overlap_not,	slurm_bit_overlap_not);
+strong_alias(bit_overlap_not_any, slurm_bit_overlap_not_any);
 strong_alias(bit_equal,		slurm_bit_equal);
 strong_alias(bit_copy,		slurm_bit_copy);
+strong_alias(bit_alloc_arena,	slurm_bit_alloc_arena);
+strong_alias(bit_copy_arena,	slurm_bit_copy_arena);
 strong_alias(bit_pick_cnt,	slurm_bit_pick_cnt);
 strong_alias(bit_copybits,	slurm_bit_copybits);
+strong_alias(bit_copybits_and_not, slurm_bit_copybits_and_not);
 strong_alias(bit_get_bit_num,	slurm_bit_get_bit_num);
 
 #ifdef SLURM_BIGENDIAN
@@ -331,6 +337,22 @@ static bitstr_t *bit_alloc_nz(bitoff_t nbits)
 	return new;
 }
 
+bitstr_t *bit_alloc_arena(xarena_t *arena, bitoff_t nbits)
+{
+	bitstr_t *new;
+
+	if (!arena)
+		return bit_alloc(nbits);
+
+	_assert_valid_size(nbits);
+
+	new = xcalloc_arena(arena, _bitstr_words(nbits), sizeof(bitstr_t));
+	_bitstr_magic(new) = BITSTR_MAGIC;
+	_bitstr_bits(new) = nbits;
+
+	return new;
+}
+
 /*
  * Reallocate a bitstring (expand or contract size).
  *   b (IN)		pointer to old bitstring
@@ -361,7 +383,10 @@ void slurm_bit_free(bitstr_t **b)
 
 	_bitstr_magic(*b) = 0;
 
-	if (_bitstr_bits(*b) == cached_bitstr_len) {
+	if (xarena_item(*b)) {
+		/* Released with the rest of the arena */
+		*b = NULL;
+	} else if (_bitstr_bits(*b) == cached_bitstr_len) {
 		_cache_push(*b);
 		*b = NULL;
 	} else
@@ -848,6 +873,34 @@ void bit_or_not(bitstr_t *b1, bitstr_t *b2)
 	}
 }
 
+/*
+ * b1 |= (b2 & ~b3) in a single pass, without a temporary bitmap
+ * b1 (IN/OUT)
+ * b2 (IN)
+ * b3 (IN)
+ */
+void bit_or_and_not(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3)
+{
+	bitoff_t bit, bit_cnt;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	_assert_bitstr_valid(b3);
+	xassert(_bitstr_bits(b2) == _bitstr_bits(b3));
+
+	bit_cnt = MIN(_bitstr_bits(b1), _bitstr_bits(b2));
+	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
+	     bit += BITSTR_WORD_SIZE)
+		b1[_bit_word(bit)] |= (b2[_bit_word(bit)] &
+				       ~b3[_bit_word(bit)]);
+
+	if (bit < bit_cnt) {
+		uint64_t mask = _bit_nmask(bit_cnt);
+		b1[_bit_word(bit)] |= (b2[_bit_word(bit)] &
+				       ~b3[_bit_word(bit)] & mask);
+	}
+}
+
 /*
  * return a copy of the supplied bitmap
  */
@@ -868,6 +921,28 @@ bit_copy(bitstr_t *b)
 	return new;
 }
 
+bitstr_t *bit_copy_arena(xarena_t *arena, bitstr_t *b)
+{
+	bitstr_t *new;
+	int32_t newsize_bits;
+	size_t len = 0;  /* Number of bytes to memcpy() */
+
+	if (!arena)
+		return bit_copy(b);
+
+	_assert_bitstr_valid(b);
+
+	newsize_bits = bit_size(b);
+	len = (_bitstr_words(newsize_bits) - BITSTR_OVERHEAD)*sizeof(bitstr_t);
+	new = xcalloc_nz_arena(arena, _bitstr_words(newsize_bits),
+			       sizeof(bitstr_t));
+	_bitstr_magic(new) = BITSTR_MAGIC;
+	_bitstr_bits(new) = newsize_bits;
+	memcpy(&new[BITSTR_OVERHEAD], &b[BITSTR_OVERHEAD], len);
+
+	return new;
+}
+
 void
 bit_copybits(bitstr_t *dest, bitstr_t *src)
 {
@@ -881,8 +956,41 @@ bit_copybits(bitstr_t *dest, bitstr_t *src)
 	memcpy(&dest[BITSTR_OVERHEAD], &src[BITSTR_OVERHEAD], len);
 }
 
+/*
+ * dest = src & ~mask in a single pass, reusing dest rather than allocating a
+ * new bitmap through bit_copy()
+ */
+void
+bit_copybits_and_not(bitstr_t *dest, bitstr_t *src, bitstr_t *mask)
+{
+	bitoff_t bit, bit_cnt;
+
+	_assert_bitstr_valid(dest);
+	_assert_bitstr_valid(src);
+	_assert_bitstr_valid(mask);
+	xassert(bit_size(src) == bit_size(dest));
+	xassert(bit_size(src) == bit_size(mask));
+
+	bit_cnt = _bitstr_bits(src);
+	for (bit = 0; bit < bit_cnt; bit += BITSTR_WORD_SIZE)
+		dest[_bit_word(bit)] = (src[_bit_word(bit)] &
+					~mask[_bit_word(bit)]);
+}
+
 #ifdef HAVE___BUILTIN_POPCOUNTLL
 #define hweight __builtin_popcountll
+/*
+ * Unless the whole build targets CPUs with the popcnt instruction,
+ * __builtin_popcountll() is a call to a generic bit counting routine. Also
+ * build the loops that count bits of whole bitstrings with popcnt and select
+ * a version when the library is loaded (through ifunc).
+ */
+#if defined(__x86_64__) && defined(__GLIBC__) && !defined(__POPCNT__) && \
+    defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define BITSTR_POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#endif
+#endif
 #else
 /*
  * Returns the hamming weight (i.e. the number of bits set) in a word.
@@ -898,19 +1006,16 @@ hweight(uint64_t w)
 }
 #endif
 
-/*
- * Count the number of bits set in bitstring.
- *   b (IN)		bitstring to check
- *   RETURN		count of set bits
- */
-int32_t
-bit_set_count(bitstr_t *b)
+#ifndef BITSTR_POPCNT_CLONES
+#define BITSTR_POPCNT_CLONES
+#endif
+
+BITSTR_POPCNT_CLONES
+static int32_t _bit_set_count_internal(bitstr_t *b)
 {
 	int32_t count = 0;
 	bitoff_t bit, bit_cnt;
 
-	_assert_bitstr_valid(b);
-
 	bit_cnt = _bitstr_bits(b);
 	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
 	     bit += BITSTR_WORD_SIZE) {
@@ -924,21 +1029,34 @@ bit_set_count(bitstr_t *b)
 }
 
 /*
- * Count the number of bits set in a range of bitstring.
+ * Count the number of bits set in bitstring.
  *   b (IN)		bitstring to check
- *   start (IN) first bit to check
- *   end (IN)	last bit to check+1
  *   RETURN		count of set bits
  */
 int32_t
-bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
+bit_set_count(bitstr_t *b)
+{
+	_assert_bitstr_valid(b);
+
+	return _bit_set_count_internal(b);
+}
+
+/*
+ * Word of b1 at bit with the bits set in b2 cleared, if b2 is given
+ */
+static inline uint64_t _bit_word_not(bitstr_t *b1, bitstr_t *b2, bitoff_t bit)
+{
+	if (b2)
+		return b1[_bit_word(bit)] & ~b2[_bit_word(bit)];
+	return b1[_bit_word(bit)];
+}
+
+static int32_t _bit_set_count_range_internal(bitstr_t *b, bitstr_t *nb,
+					     int32_t start, int32_t end)
 {
 	int32_t count = 0, eow;
 	bitoff_t bit;
 
-	_assert_bitstr_valid(b);
-	_assert_bit_valid(b,start);
-
 	end = MIN(end, _bitstr_bits(b));
 	/* end of word */
 	eow = (((start + BITSTR_MAXPOS) >> BITSTR_SHIFT) << BITSTR_SHIFT);
@@ -946,25 +1064,62 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 	bit = start;
 	if ((start < eow) && (eow <= end)) {
 		uint64_t mask = ~_bit_nmask(start);
-		count += hweight(b[_bit_word(bit)] & mask);
+		count += hweight(_bit_word_not(b, nb, bit) & mask);
 		bit = eow;
 	} else if (eow > start) {
 		uint64_t mask = ~_bit_nmask(start);
 		mask &= _bit_nmask(end);
-		count += hweight(b[_bit_word(bit)] & mask);
+		count += hweight(_bit_word_not(b, nb, bit) & mask);
 		bit = eow;
 	}
 	for (; (bit + BITSTR_WORD_SIZE) <= end ; bit += BITSTR_WORD_SIZE) {
-		count += hweight(b[_bit_word(bit)]);
+		count += hweight(_bit_word_not(b, nb, bit));
 	}
 	if (bit < end) {
 		uint64_t mask = _bit_nmask(end);
-		count += hweight(b[_bit_word(bit)] & mask);
+		count += hweight(_bit_word_not(b, nb, bit) & mask);
 	}
 
 	return count;
 }
 
+/*
+ * Count the number of bits set in a range of bitstring.
+ *   b (IN)		bitstring to check
+ *   start (IN) first bit to check
+ *   end (IN)	last bit to check+1
+ *   RETURN		count of set bits
+ */
+int32_t
+bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
+{
+	_assert_bitstr_valid(b);
+	_assert_bit_valid(b,start);
+
+	return _bit_set_count_range_internal(b, NULL, start, end);
+}
+
+/*
+ * Count the number of bits set in a range of b1 that are not set in b2,
+ * without building (b1 & ~b2) in a temporary bitmap.
+ *   b1 (IN)		bitstring to check
+ *   b2 (IN)		bitstring of bits to ignore
+ *   start (IN) first bit to check
+ *   end (IN)	last bit to check+1
+ *   RETURN		count of set bits
+ */
+int32_t
+bit_set_count_range_not(bitstr_t *b1, bitstr_t *b2, int32_t start, int32_t end)
+{
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	_assert_bit_valid(b1,start);
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
+
+	return _bit_set_count_range_internal(b1, b2, start, end);
+}
+
+BITSTR_POPCNT_CLONES
 static int32_t _bit_overlap_internal(bitstr_t *b1, bitstr_t *b2, bool count_it)
 {
 	int32_t count = 0;
@@ -1015,6 +1170,62 @@ extern int32_t bit_overlap_any(bitstr_t *b1, bitstr_t *b2)
 	return _bit_overlap_internal(b1, b2, 0);
 }
 
+BITSTR_POPCNT_CLONES
+static int32_t _bit_overlap_not_internal(bitstr_t *b1, bitstr_t *b2,
+					 bitstr_t *b3, bool count_it)
+{
+	int32_t count = 0;
+	uint64_t word;
+	bitoff_t bit, bit_cnt;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	_assert_bitstr_valid(b3);
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b2));
+	xassert(_bitstr_bits(b1) == _bitstr_bits(b3));
+
+	bit_cnt = _bitstr_bits(b1);
+	for (bit = 0; (bit + BITSTR_WORD_SIZE) <= bit_cnt;
+	     bit += BITSTR_WORD_SIZE) {
+		word = b1[_bit_word(bit)] & b2[_bit_word(bit)] &
+		       ~b3[_bit_word(bit)];
+		if (count_it)
+			count += hweight(word);
+		else if (word)
+			return 1;
+	}
+
+	if (bit < bit_cnt) {
+		uint64_t mask = _bit_nmask(bit_cnt);
+		word = b1[_bit_word(bit)] & b2[_bit_word(bit)] &
+		       ~b3[_bit_word(bit)] & mask;
+		if (count_it)
+			count += hweight(word);
+		else if (word)
+			return 1;
+	}
+
+	return count;
+}
+
+/*
+ * return number of bits set in both b1 and b2 that are not set in b3, the
+ * same as bit_set_count() of (b1 & b2 & ~b3) without the temporary bitmaps
+ */
+extern int32_t bit_overlap_not(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3)
+{
+	return _bit_overlap_not_internal(b1, b2, b3, true);
+}
+
+/*
+ * return 1 if there is at least one bit set in both b1 and b2 that is not set
+ * in b3, 0 otherwise
+ */
+extern int32_t bit_overlap_not_any(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3)
+{
+	return _bit_overlap_not_internal(b1, b2, b3, false);
+}
+
 /*
  * Count the number of bits clear in bitstring.
  *   b (IN)		bitstring to check
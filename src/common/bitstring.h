@@ -58,6 +58,8 @@
 
 #include <inttypes.h>
 
+#include "src/common/xmalloc.h"
+
 #define BITSTR_FMT		PRId64
 
 /* Below are also defined in src/slurm/slurm.h.in.  If it changes please update
@@ -112,8 +114,11 @@ void	bit_and_not(bitstr_t *b1, bitstr_t *b2);
 void	bit_not(bitstr_t *b);
 void	bit_or(bitstr_t *b1, bitstr_t *b2);
 void	bit_or_not(bitstr_t *b1, bitstr_t *b2);
+void	bit_or_and_not(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3);
 int32_t	bit_set_count(bitstr_t *b);
 int32_t	bit_set_count_range(bitstr_t *b, int32_t start, int32_t end);
+int32_t	bit_set_count_range_not(bitstr_t *b1, bitstr_t *b2, int32_t start,
+				int32_t end);
 int32_t	bit_clear_count(bitstr_t *b);
 bitstr_t *bit_rotate_copy(bitstr_t *b1, int32_t n, bitoff_t nbits);
 void	bit_rotate(bitstr_t *b1, int32_t n);
@@ -134,9 +139,19 @@ void	bit_fill_gaps(bitstr_t *b);
 int	bit_super_set(bitstr_t *b1, bitstr_t *b2);
 int     bit_overlap(bitstr_t *b1, bitstr_t *b2);
 int     bit_overlap_any(bitstr_t *b1, bitstr_t *b2);
+int     bit_overlap_not(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3);
+int     bit_overlap_not_any(bitstr_t *b1, bitstr_t *b2, bitstr_t *b3);
 int     bit_equal(bitstr_t *b1, bitstr_t *b2);
 void    bit_copybits(bitstr_t *dest, bitstr_t *src);
+void    bit_copybits_and_not(bitstr_t *dest, bitstr_t *src, bitstr_t *mask);
 bitstr_t *bit_copy(bitstr_t *b);
+
+/*
+ * bit_alloc() and bit_copy() out of a cycle scoped arena, see xarena_create().
+ * bit_free() of the result is allowed but does not release the memory.
+ */
+bitstr_t *bit_alloc_arena(xarena_t *arena, bitoff_t nbits);
+bitstr_t *bit_copy_arena(xarena_t *arena, bitstr_t *b);
 bitoff_t bit_nth_set(bitstr_t *b, bitoff_t n);
 void bit_pick_firstn(bitstr_t *b, bitoff_t n);
 bitstr_t *bit_pick_cnt(bitstr_t *b, bitoff_t nbits);
@@ -163,4 +178,12 @@ do {					\
 		_X = bit_copy(_Y);	\
 } while (0)
 
+#define COPY_BITMAP_ARENA(_A, _X, _Y)		\
+do {						\
+	if (_X)					\
+		bit_copybits(_X, _Y);		\
+	else					\
+		_X = bit_copy_arena(_A, _Y);	\
+} while (0)
+
 #endif /* !_BITSTRING_H_ */
@@ -354,16 +354,16 @@ struct job_record {
 	void *hres_select; /* DON'T PACK. */
 	uint32_t job_id;		/* job ID */
 	identity_t *id;			/* job identity */
-	job_record_t *job_next;		/* next entry with same hash index */
 	job_record_t *job_array_next_j;	/* job array linked list by job_id */
 	job_record_t *job_array_next_t;	/* job array linked list by task_id */
-	job_record_t *job_next_sluid; /* next entry with same sluid hash */
 	job_record_t *job_preempt_comp; /* het job preempt component */
 	job_resources_t *job_resrcs;	/* details of allocated cores */
 	uint32_t job_state;		/* state of the job */
 	uint16_t kill_on_node_fail;	/* 1 if job should be killed on
 					 * node failure */
 	time_t last_sched_eval;		/* last time job was evaluated for scheduling */
+	time_t last_update;		/* time of last change to the record,
+					 * set along with last_job_update */
 	char *licenses;			/* licenses required by the job */
 	char *licenses_allocated;	/* licenses allocated to the job */
 	list_t *license_list;		/* structure with license info; when
@@ -666,6 +666,7 @@ typedef struct {
 } step_record_t;
 
 typedef struct {
+	xarena_t *arena; /* allocate job_queue_rec_t out of this, or NULL */
 	job_record_t *job_ptr;
 	list_t *job_queue;
 	part_record_t *part_ptr;
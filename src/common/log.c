@@ -73,6 +73,7 @@
 #include "src/common/fd.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
 #include "src/common/sluid.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_time.h"
@@ -90,6 +91,11 @@
 
 #define NAMELEN 16
 
+/* Max messages queued for the async writer before dropping new messages */
+#define LOG_ASYNC_RING_SIZE 8192
+/* Max messages written by the async writer with a single write */
+#define LOG_ASYNC_BATCH 256
+
 #define LOG_MACRO(level, sched, fmt) {				\
 	if ((level <= highest_log_level) ||			\
 	    (sched && (level <= highest_sched_log_level))) {	\
@@ -140,6 +146,15 @@ typedef struct {
 	uint16_t fmt;            /* Flag for specifying timestamp format */
 }	log_t;
 
+/*
+** message queued for the async writer thread
+*/
+typedef struct {
+	char *line;              /* logfile line (with newline) or NULL  */
+	char *sys_msg;           /* syslog message or NULL               */
+	int priority;            /* syslog priority                      */
+}	log_async_msg_t;
+
 /* static variables */
 static pthread_mutex_t  log_lock = PTHREAD_MUTEX_INITIALIZER;
 static log_t            *log = NULL;
@@ -148,6 +163,22 @@ static bool syslog_open = false;
 static volatile log_level_t highest_log_level = LOG_LEVEL_END;
 static volatile log_level_t highest_sched_log_level = LOG_LEVEL_QUIET;
 
+/*
+ * Async logging: _log_msg() queues formatted logfile and syslog output in
+ * async_ring while holding log_lock, a writer thread writes it in batches
+ * without log_lock. async_write_lock serializes the writers (the thread and
+ * log_flush()) and must be held (before log_lock) by anything that changes
+ * log->logfp while the writer could be using it.
+ */
+static pthread_mutex_t async_write_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static mpmc_ring_t *async_ring = NULL;
+static pthread_t async_tid = 0;
+static bool async_shutdown = false;
+static bool async_enabled = false; /* protected by log_lock */
+static uint64_t async_dropped = 0; /* protected by log_lock */
+
 #define LOG_INITIALIZED ((log != NULL) && (log->initialized))
 #define SCHED_LOG_INITIALIZED ((sched_log != NULL) && (sched_log->initialized))
 /* define a default argv0 */
@@ -160,13 +191,38 @@ extern char * program_invocation_name;
 #  define default_name ""
 #endif
 
+static void _log_flush(log_t *log);
+static int _async_write(int max);
+static void _async_update(void);
 
 /*
  * pthread_atfork handlers:
  */
-static void _atfork_prep()   { slurm_mutex_lock(&log_lock);   }
-static void _atfork_parent() { slurm_mutex_unlock(&log_lock); }
-static void _atfork_child()  { slurm_mutex_unlock(&log_lock); }
+static void _atfork_prep()
+{
+	slurm_mutex_lock(&async_write_lock);
+	slurm_mutex_lock(&log_lock);
+	/*
+	 * The child drops the ring and a daemonizing parent _exit()s without
+	 * running _async_atexit(), so write queued messages now.
+	 */
+	_async_write(0);
+}
+static void _atfork_parent()
+{
+	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
+}
+static void _atfork_child()
+{
+	/* The writer thread does not exist in the child */
+	async_enabled = false;
+	async_tid = 0;
+	/* Ring was drained before fork, later messages are the parent's */
+	async_ring = NULL;
+	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
+}
 static bool at_forked = false;
 #define atfork_install_handlers()					\
 	while (!at_forked) {						\
@@ -174,8 +230,6 @@ static bool at_forked = false;
 		at_forked = true;					\
 	}
 
-static void _log_flush(log_t *log);
-
 static log_level_t _highest_level(log_level_t a, log_level_t b, log_level_t c)
 {
 	if (a >= b) {
@@ -385,6 +439,10 @@ _log_init(char *prog, log_options_t opt, log_facility_t fac, char *logfile )
 					   log->opt.logfile_level,
 					   log->opt.stderr_level);
 
+	async_enabled = log->opt.async;
+	if (async_enabled && !async_ring)
+		async_ring = mpmc_ring_create(LOG_ASYNC_RING_SIZE);
+
 	log->initialized = 1;
  out:
 	return rc;
@@ -496,9 +554,13 @@ int log_init(char *prog, log_options_t opt, log_facility_t fac, char *logfile)
 {
 	int rc = 0;
 
+	slurm_mutex_lock(&async_write_lock);
 	slurm_mutex_lock(&log_lock);
+	_async_write(0);
 	rc = _log_init(prog, opt, fac, logfile);
 	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
+	_async_update();
 	return rc;
 }
 
@@ -522,6 +584,14 @@ void log_fini(void)
 		return;
 
 	slurm_mutex_lock(&log_lock);
+	async_enabled = false;
+	slurm_mutex_unlock(&log_lock);
+	_async_update();
+
+	slurm_mutex_lock(&async_write_lock);
+	slurm_mutex_lock(&log_lock);
+	_async_write(0);
+	FREE_NULL_MPMC_RING(async_ring);
 	_log_flush(log);
 	if (syslog_open) {
 		closelog();
@@ -537,6 +607,7 @@ void log_fini(void)
 		fclose(log->logfp);
 	xfree(log);
 	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
 }
 
 void sched_log_fini(void)
@@ -561,6 +632,7 @@ void sched_log_fini(void)
 void log_reinit(void)
 {
 	slurm_mutex_init(&log_lock);
+	slurm_mutex_init(&async_write_lock);
 }
 
 void log_set_prefix(char **prefix)
@@ -598,9 +670,14 @@ void log_set_argv0(char *argv0)
 int log_alter(log_options_t opt, log_facility_t fac, char *logfile)
 {
 	int rc = 0;
+	slurm_mutex_lock(&async_write_lock);
 	slurm_mutex_lock(&log_lock);
+	/* Write queued messages before the logfile can change */
+	_async_write(0);
 	rc = _log_init(NULL, opt, fac, logfile);
 	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
+	_async_update();
 	return rc;
 }
 
@@ -610,7 +687,10 @@ int log_alter(log_options_t opt, log_facility_t fac, char *logfile)
 int log_alter_with_fp(log_options_t opt, log_facility_t fac, FILE *fp_in)
 {
 	int rc = 0;
+	slurm_mutex_lock(&async_write_lock);
 	slurm_mutex_lock(&log_lock);
+	/* Write queued messages before the logfile can change */
+	_async_write(0);
 	rc = _log_init(NULL, opt, fac, NULL);
 	if (log->logfp)
 		fclose(log->logfp); /* Ignore errors */
@@ -623,6 +703,8 @@ int log_alter_with_fp(log_options_t opt, log_facility_t fac, FILE *fp_in)
 		 * outside of the logger */
 	}
 	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
+	_async_update();
 	return rc;
 }
 
@@ -1312,6 +1394,160 @@ static void _log_printf(log_t *log, cbuf_t *cb, FILE *stream,
 
 }
 
+static void _async_msg_free(log_async_msg_t *msg)
+{
+	xfree(msg->line);
+	xfree(msg->sys_msg);
+	xfree(msg);
+}
+
+static void _async_msg_syslog(log_async_msg_t *msg)
+{
+	/* Avoid changing errno if syslog fails */
+	int orig_errno = errno;
+
+	syslog(msg->priority, "%s", msg->sys_msg);
+	errno = orig_errno;
+}
+
+/*
+ * Write queued messages with a single write to the logfile
+ * IN max - max messages to write or 0 for all currently queued
+ * RET number of messages written
+ * NOTE: async_write_lock must be locked
+ */
+static int _async_write(int max)
+{
+	log_async_msg_t *msg;
+	char *lines = NULL;
+	int cnt = 0;
+
+	if (!async_ring)
+		return 0;
+
+	if (!max)
+		max = mpmc_ring_count(async_ring);
+
+	while ((cnt < max) && (msg = mpmc_ring_pop(async_ring))) {
+		if (msg->line)
+			xstrcat(lines, msg->line);
+		if (msg->sys_msg)
+			_async_msg_syslog(msg);
+		_async_msg_free(msg);
+		cnt++;
+	}
+
+	if (lines && log && log->logfp) {
+		_log_printf(log, log->fbuf, log->logfp, "%s", lines);
+		fflush(log->logfp);
+	}
+	xfree(lines);
+
+	return cnt;
+}
+
+static void *_async_writer(void *arg)
+{
+	uint64_t dropped, dropped_reported = 0;
+	int cnt;
+
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "log", NULL, NULL, NULL) < 0)
+		error("%s: cannot set my name to %s %m", __func__, "log");
+#endif
+
+	slurm_mutex_lock(&async_mutex);
+	while (!async_shutdown) {
+		slurm_mutex_unlock(&async_mutex);
+
+		slurm_mutex_lock(&async_write_lock);
+		cnt = _async_write(LOG_ASYNC_BATCH);
+		slurm_mutex_unlock(&async_write_lock);
+
+		if (cnt) {
+			slurm_mutex_lock(&log_lock);
+			dropped = async_dropped;
+			slurm_mutex_unlock(&log_lock);
+
+			if (dropped != dropped_reported) {
+				error("%s: dropped %"PRIu64" log messages, writer could not keep up",
+				      __func__, (dropped - dropped_reported));
+				dropped_reported = dropped;
+			}
+		}
+
+		slurm_mutex_lock(&async_mutex);
+		if (!cnt && !async_shutdown) {
+			/* Producers signal without async_mutex, so never wait long */
+			timespec_t abs = timespec_add(timespec_now(),
+						      (timespec_t) {
+							      .tv_sec = 1,
+						      });
+
+			slurm_cond_timedwait(&async_cond, &async_mutex, &abs);
+		}
+	}
+	slurm_mutex_unlock(&async_mutex);
+
+	return NULL;
+}
+
+/* Write anything still queued when exit() is called without fatal() */
+static void _async_atexit(void)
+{
+	slurm_mutex_lock(&async_write_lock);
+	_async_write(0);
+	slurm_mutex_unlock(&async_write_lock);
+}
+
+/* Start or stop the async writer thread to match async_enabled */
+static void _async_update(void)
+{
+	static bool atexit_set = false;
+	pthread_t tid = 0;
+	bool enabled;
+
+	slurm_mutex_lock(&log_lock);
+	enabled = async_enabled;
+	slurm_mutex_unlock(&log_lock);
+
+	slurm_mutex_lock(&async_mutex);
+	if (enabled && !async_tid) {
+		async_shutdown = false;
+		/*
+		 * Not using slurm_thread_create() since the threadpool logs
+		 * and must not be required by the logger.
+		 */
+		if ((errno = pthread_create(&async_tid, NULL, _async_writer,
+					    NULL))) {
+			fprintf(stderr, "%s: pthread_create() failed, logging synchronously: %s\n",
+				__func__, slurm_strerror(errno));
+			async_tid = 0;
+			slurm_mutex_lock(&log_lock);
+			async_enabled = false;
+			slurm_mutex_unlock(&log_lock);
+		} else if (!atexit_set) {
+			(void) atexit(_async_atexit);
+			atexit_set = true;
+		}
+	} else if (!enabled && async_tid) {
+		async_shutdown = true;
+		slurm_cond_signal(&async_cond);
+		tid = async_tid;
+		async_tid = 0;
+	}
+	slurm_mutex_unlock(&async_mutex);
+
+	if (tid) {
+		pthread_join(tid, NULL);
+
+		/* Nothing is queued after async_enabled is cleared */
+		slurm_mutex_lock(&async_write_lock);
+		_async_write(0);
+		slurm_mutex_unlock(&async_write_lock);
+	}
+}
+
 /*
  * log a message at the specified level to facilities that have been
  * configured to receive messages at that level
@@ -1324,6 +1560,7 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 	char *msgbuf = NULL;
 	char *eol = "\n";
 	int priority = LOG_INFO;
+	log_async_msg_t *amsg = NULL;
 
 	/*
 	 * Construct the message outside the lock as this can be slow.
@@ -1454,11 +1691,20 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 					   SER_FLAGS_COMPACT);
 		FREE_NULL_DATA(out);
 
-		if (json)
+		if (json && async_enabled) {
+			amsg = xmalloc(sizeof(*amsg));
+			amsg->line = xstrdup_printf("%s\n", json);
+		} else if (json) {
 			_log_printf(log, log->fbuf, log->logfp, "%s\n", json);
+		}
 
 		xfree(json);
-		fflush(log->logfp);
+		if (!amsg)
+			fflush(log->logfp);
+	} else if (async_enabled) {
+		xassert(log->opt.logfile_fmt == LOG_FILE_FMT_TIMESTAMP);
+		amsg = xmalloc(sizeof(*amsg));
+		xlogfmtcat(&amsg->line, "[%M] %s%s%s\n", log->prefix, pfx, buf);
 	} else {
 		xassert(log->opt.logfile_fmt == LOG_FILE_FMT_TIMESTAMP);
 		xlogfmtcat(&msgbuf, "[%M] %s%s", log->prefix, pfx);
@@ -1468,7 +1714,12 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 		xfree(msgbuf);
 	}
 
-	if (level <=  log->opt.syslog_level) {
+	if ((level <= log->opt.syslog_level) && async_enabled) {
+		if (!amsg)
+			amsg = xmalloc(sizeof(*amsg));
+		amsg->sys_msg = xstrdup_printf("%s%s%s", log->prefix, pfx, buf);
+		amsg->priority = priority;
+	} else if (level <=  log->opt.syslog_level) {
 
 		/* Avoid changing errno if syslog fails */
 		int orig_errno = errno;
@@ -1476,6 +1727,25 @@ static void _log_msg(log_level_t level, bool sched, bool spank, bool warn,
 		errno = orig_errno;
 	}
 
+	if (!amsg) {
+		/* nothing queued */
+	} else if (mpmc_ring_push(async_ring, amsg)) {
+		slurm_cond_signal(&async_cond);
+	} else if (level <= LOG_LEVEL_FATAL) {
+		/* Never drop the reason for exiting */
+		if (amsg->line && log->logfp) {
+			_log_printf(log, log->fbuf, log->logfp, "%s",
+				    amsg->line);
+			fflush(log->logfp);
+		}
+		if (amsg->sys_msg)
+			_async_msg_syslog(amsg);
+		_async_msg_free(amsg);
+	} else {
+		async_dropped++;
+		_async_msg_free(amsg);
+	}
+
 	slurm_mutex_unlock(&log_lock);
 
 	xfree(buf);
@@ -1507,9 +1777,12 @@ _log_flush(log_t *log)
 void
 log_flush()
 {
+	slurm_mutex_lock(&async_write_lock);
 	slurm_mutex_lock(&log_lock);
+	_async_write(0);
 	_log_flush(log);
 	slurm_mutex_unlock(&log_lock);
+	slurm_mutex_unlock(&async_write_lock);
 }
 
 /*
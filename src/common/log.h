@@ -106,6 +106,7 @@ typedef struct {
 	bool buffered;              /* use internal buffer to never block    */
 	bool raw;                   /* output is to a raw terminal           */
 	log_file_fmt_t logfile_fmt; /* format of logfile output */
+	bool async;                 /* logfile and syslog written by thread  */
 } 	log_options_t;
 
 typedef struct {
@@ -241,7 +242,8 @@ bool log_has_data(void);
 
 /*
  * log_flush() attempts to flush all data in the internal
- * log buffer to the appropriate output stream.
+ * log buffer to the appropriate output stream. Messages queued for the
+ * async writer thread are written before returning.
  */
 void log_flush(void);
 
@@ -0,0 +1,313 @@
+/*****************************************************************************\
+ *  mpmc_ring.c - Bounded multi-producer multi-consumer ring of pointers
+ *****************************************************************************
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <pthread.h>
+
+#include "src/common/atomic.h"
+#include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+
+#define MAGIC_MPMC_RING 0xa9b4c1d2
+#define MPMC_RING_MIN_SIZE 2
+#define MPMC_RING_MAX_SIZE (1U << 31)
+/* Keep head and tail counters on separate cache lines */
+#define CACHE_LINE_BYTES 64
+
+#ifndef __STDC_NO_ATOMICS__
+
+typedef struct {
+	/*
+	 * Slot position the slot is ready for:
+	 *	== pos: empty and ready for producer at pos
+	 *	== pos + 1: full and ready for consumer at pos
+	 */
+	_Atomic uint64_t seq;
+	void *ptr;
+} slot_t;
+
+struct mpmc_ring_s {
+	int magic; /* MAGIC_MPMC_RING */
+	uint64_t mask;
+	slot_t *slots;
+	char pad_tail[CACHE_LINE_BYTES];
+	_Atomic uint64_t tail; /* next position to push */
+	char pad_head[CACHE_LINE_BYTES];
+	_Atomic uint64_t head; /* next position to pop */
+	char pad_end[CACHE_LINE_BYTES];
+};
+
+#else /* __STDC_NO_ATOMICS__ */
+
+struct mpmc_ring_s {
+	int magic; /* MAGIC_MPMC_RING */
+	uint64_t mask;
+	void **slots;
+	pthread_mutex_t mutex;
+	uint64_t tail; /* next position to push */
+	uint64_t head; /* next position to pop */
+};
+
+#endif /* __STDC_NO_ATOMICS__ */
+
+static uint32_t _round_size(uint32_t size)
+{
+	uint32_t rounded = MPMC_RING_MIN_SIZE;
+
+	if (size >= MPMC_RING_MAX_SIZE)
+		return MPMC_RING_MAX_SIZE;
+
+	while (rounded < size)
+		rounded <<= 1;
+
+	return rounded;
+}
+
+#ifndef __STDC_NO_ATOMICS__
+
+extern mpmc_ring_t *mpmc_ring_create(uint32_t size)
+{
+	mpmc_ring_t *ring = xmalloc(sizeof(*ring));
+
+	size = _round_size(size);
+
+	ring->magic = MAGIC_MPMC_RING;
+	ring->mask = (size - 1);
+	ring->slots = xcalloc(size, sizeof(*ring->slots));
+
+	for (uint64_t i = 0; i < size; i++)
+		atomic_init(&ring->slots[i].seq, i);
+
+	atomic_init(&ring->tail, 0);
+	atomic_init(&ring->head, 0);
+
+	return ring;
+}
+
+extern void mpmc_ring_destroy(mpmc_ring_t *ring)
+{
+	xassert(ring->magic == MAGIC_MPMC_RING);
+	ring->magic = ~MAGIC_MPMC_RING;
+	xfree(ring->slots);
+	xfree(ring);
+}
+
+extern bool mpmc_ring_push(mpmc_ring_t *ring, void *ptr)
+{
+	uint64_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	slot_t *slot;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+	xassert(ptr);
+
+	while (true) {
+		uint64_t seq;
+		int64_t diff;
+
+		slot = &ring->slots[pos & ring->mask];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		diff = (int64_t) (seq - pos);
+
+		if (!diff) {
+			/* slot is empty: try to claim it */
+			if (atomic_compare_exchange_weak_explicit(
+				    &ring->tail, &pos, (pos + 1),
+				    memory_order_relaxed,
+				    memory_order_relaxed))
+				break;
+			/* pos was reloaded by failed compare */
+		} else if (diff < 0) {
+			/* slot still holds ptr from last lap: full */
+			return false;
+		} else {
+			/* another producer claimed pos first */
+			pos = atomic_load_explicit(&ring->tail,
+						   memory_order_relaxed);
+		}
+	}
+
+	slot->ptr = ptr;
+	atomic_store_explicit(&slot->seq, (pos + 1), memory_order_release);
+
+	return true;
+}
+
+extern void *mpmc_ring_pop(mpmc_ring_t *ring)
+{
+	uint64_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	slot_t *slot;
+	void *ptr;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+
+	while (true) {
+		uint64_t seq;
+		int64_t diff;
+
+		slot = &ring->slots[pos & ring->mask];
+		seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+		diff = (int64_t) (seq - (pos + 1));
+
+		if (!diff) {
+			/* slot is full: try to claim it */
+			if (atomic_compare_exchange_weak_explicit(
+				    &ring->head, &pos, (pos + 1),
+				    memory_order_relaxed,
+				    memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			/* slot not yet filled: empty */
+			return NULL;
+		} else {
+			/* another consumer claimed pos first */
+			pos = atomic_load_explicit(&ring->head,
+						   memory_order_relaxed);
+		}
+	}
+
+	ptr = slot->ptr;
+	slot->ptr = NULL;
+	/* mark slot empty for producer on the next lap */
+	atomic_store_explicit(&slot->seq, (pos + ring->mask + 1),
+			      memory_order_release);
+
+	return ptr;
+}
+
+extern uint32_t mpmc_ring_count(mpmc_ring_t *ring)
+{
+	uint64_t head, tail;
+
+	if (!ring)
+		return 0;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+
+	head = atomic_load_explicit(&ring->head, memory_order_acquire);
+	tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+	/* head may pass a stale tail while racing consumers */
+	if (tail <= head)
+		return 0;
+
+	return MIN((tail - head), (ring->mask + 1));
+}
+
+#else /* __STDC_NO_ATOMICS__ */
+
+extern mpmc_ring_t *mpmc_ring_create(uint32_t size)
+{
+	mpmc_ring_t *ring = xmalloc(sizeof(*ring));
+
+	size = _round_size(size);
+
+	ring->magic = MAGIC_MPMC_RING;
+	ring->mask = (size - 1);
+	ring->slots = xcalloc(size, sizeof(*ring->slots));
+	slurm_mutex_init(&ring->mutex);
+
+	return ring;
+}
+
+extern void mpmc_ring_destroy(mpmc_ring_t *ring)
+{
+	xassert(ring->magic == MAGIC_MPMC_RING);
+	ring->magic = ~MAGIC_MPMC_RING;
+	slurm_mutex_destroy(&ring->mutex);
+	xfree(ring->slots);
+	xfree(ring);
+}
+
+extern bool mpmc_ring_push(mpmc_ring_t *ring, void *ptr)
+{
+	bool pushed = false;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+	xassert(ptr);
+
+	slurm_mutex_lock(&ring->mutex);
+	if ((ring->tail - ring->head) <= ring->mask) {
+		ring->slots[ring->tail & ring->mask] = ptr;
+		ring->tail++;
+		pushed = true;
+	}
+	slurm_mutex_unlock(&ring->mutex);
+
+	return pushed;
+}
+
+extern void *mpmc_ring_pop(mpmc_ring_t *ring)
+{
+	void *ptr = NULL;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+
+	slurm_mutex_lock(&ring->mutex);
+	if (ring->head != ring->tail) {
+		ptr = ring->slots[ring->head & ring->mask];
+		ring->slots[ring->head & ring->mask] = NULL;
+		ring->head++;
+	}
+	slurm_mutex_unlock(&ring->mutex);
+
+	return ptr;
+}
+
+extern uint32_t mpmc_ring_count(mpmc_ring_t *ring)
+{
+	uint32_t count;
+
+	if (!ring)
+		return 0;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+
+	slurm_mutex_lock(&ring->mutex);
+	count = (ring->tail - ring->head);
+	slurm_mutex_unlock(&ring->mutex);
+
+	return count;
+}
+
+#endif /* __STDC_NO_ATOMICS__ */
+
+extern uint32_t mpmc_ring_size(mpmc_ring_t *ring)
+{
+	if (!ring)
+		return 0;
+
+	xassert(ring->magic == MAGIC_MPMC_RING);
+
+	return (ring->mask + 1);
+}
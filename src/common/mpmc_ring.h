@@ -0,0 +1,102 @@
+/*****************************************************************************\
+ *  mpmc_ring.h - Bounded multi-producer multi-consumer ring of pointers
+ *****************************************************************************
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _MPMC_RING_H
+#define _MPMC_RING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Fixed size FIFO of pointers that any number of threads may push to and pop
+ * from concurrently without a lock. Each slot carries a sequence number that
+ * tells producers and consumers whether the slot is ready for them, so
+ * threads only contend on the head or tail counter with a single
+ * compare-and-swap per operation.
+ *
+ * The ring never grows. Callers must handle mpmc_ring_push() failing when the
+ * ring is full (usually by falling back to an unbounded list).
+ *
+ * When the compiler lacks C11 atomics, the same API is provided by a ring
+ * protected by a mutex.
+ */
+typedef struct mpmc_ring_s mpmc_ring_t;
+
+/*
+ * Create new ring
+ * IN size - minimum number of pointers ring can hold. Rounded up to the next
+ *	power of 2.
+ * RET ring ptr (must be released with FREE_NULL_MPMC_RING())
+ */
+extern mpmc_ring_t *mpmc_ring_create(uint32_t size);
+
+/*
+ * Release ring
+ * NOTE: any pointers still in the ring are not released
+ */
+extern void mpmc_ring_destroy(mpmc_ring_t *ring);
+
+#define FREE_NULL_MPMC_RING(_X)			\
+	do {					\
+		if (_X)				\
+			mpmc_ring_destroy(_X);	\
+		_X = NULL;			\
+	} while (0)
+
+/*
+ * Add pointer to tail of ring
+ * IN ring - ring to add to
+ * IN ptr - pointer to add (must not be NULL)
+ * RET true if added or false if ring is full
+ */
+extern bool mpmc_ring_push(mpmc_ring_t *ring, void *ptr);
+
+/*
+ * Remove pointer from head of ring
+ * IN ring - ring to pop from
+ * RET pointer or NULL if ring is empty
+ */
+extern void *mpmc_ring_pop(mpmc_ring_t *ring);
+
+/*
+ * Get number of pointers in ring
+ * NOTE: only a snapshot when other threads are pushing or popping
+ * IN ring - ring to count (may be NULL)
+ * RET number of pointers in ring
+ */
+extern uint32_t mpmc_ring_count(mpmc_ring_t *ring);
+
+/* Get number of pointers ring can hold or 0 if ring is NULL */
+extern uint32_t mpmc_ring_size(mpmc_ring_t *ring);
+
+#endif
@@ -100,6 +100,13 @@ uint32_t *cr_node_cores_offset = NULL;
 bool spec_cores_first = false;
 time_t slurmd_start_time = 0;
 
+/* Nodes grouped by weight, see node_conf_get_weight_index() */
+static pthread_mutex_t weight_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static node_weight_bucket_t *weight_index = NULL;
+static int weight_index_cnt = 0;
+static int weight_index_node_cnt = 0;
+static bool weight_index_valid = false;
+
 /* Local function definitions */
 static void _delete_config_record(void);
 static void _delete_node_config_ptr(node_record_t *node_ptr);
@@ -123,6 +130,15 @@ static void _delete_config_record(void)
 	list_flush(config_list);
 }
 
+static void _free_weight_index(void)
+{
+	for (int b = 0; b < weight_index_cnt; b++)
+		FREE_NULL_BITMAP(weight_index[b].node_bitmap);
+	xfree(weight_index);
+	weight_index_cnt = 0;
+	weight_index_valid = false;
+}
+
 #if _DEBUG
 /*
  * helper function used by _dump_hash to print the hash table elements
@@ -688,6 +704,7 @@ extern void node_conf_convert_cpu_spec_list(node_record_t *node_ptr)
 static void _init_node_record(node_record_t *node_ptr,
 			      config_record_t *config_ptr)
 {
+	node_conf_weight_changed();
 	/*
 	 * Some of these vars will be overwritten when the node actually
 	 * registers.
@@ -938,6 +955,7 @@ extern void delete_node_record(node_record_t *node_ptr)
 			last_node_index = -1;
 	}
 	active_node_record_count--;
+	node_conf_weight_changed();
 
 	_free_node_select_stats(node_select_stats_array[node_ptr->index]);
 	node_select_stats_array[node_ptr->index] = NULL;
@@ -1087,6 +1105,7 @@ extern void node_fini2(void)
 
 	xfree(node_record_table_ptr);
 	xfree(node_select_stats_array);
+	_free_weight_index();
 	/*
 	 * Don't clear node_record_count because other plugins are relying on
 	 * node_record_count to free arrays on cleanup -- e.g.
@@ -1625,6 +1644,63 @@ extern void node_conf_set_all_active_bits(bitstr_t *b)
 		bit_set(b, i);
 }
 
+static int _sort_weight_bucket(const void *x, const void *y)
+{
+	const node_weight_bucket_t *b1 = x, *b2 = y;
+
+	return slurm_sort_uint32_list_asc(&b1->weight, &b2->weight);
+}
+
+static void _build_weight_index(void)
+{
+	node_record_t *node_ptr;
+
+	_free_weight_index();
+
+	for (int i = 0; (node_ptr = next_node(&i)); i++) {
+		node_weight_bucket_t *bucket = NULL;
+
+		for (int b = 0; b < weight_index_cnt; b++) {
+			if (weight_index[b].weight == node_ptr->weight) {
+				bucket = &weight_index[b];
+				break;
+			}
+		}
+		if (!bucket) {
+			xrecalloc(weight_index, (weight_index_cnt + 1),
+				  sizeof(*weight_index));
+			bucket = &weight_index[weight_index_cnt++];
+			bucket->weight = node_ptr->weight;
+			bucket->node_bitmap = bit_alloc(node_record_count);
+		}
+		bit_set(bucket->node_bitmap, i);
+	}
+
+	if (weight_index_cnt > 1)
+		qsort(weight_index, weight_index_cnt, sizeof(*weight_index),
+		      _sort_weight_bucket);
+
+	weight_index_node_cnt = node_record_count;
+	weight_index_valid = true;
+}
+
+extern node_weight_bucket_t *node_conf_get_weight_index(int *count)
+{
+	slurm_mutex_lock(&weight_index_mutex);
+	if (!weight_index_valid ||
+	    (weight_index_node_cnt != node_record_count))
+		_build_weight_index();
+	slurm_mutex_unlock(&weight_index_mutex);
+
+	*count = weight_index_cnt;
+	return weight_index;
+}
+
+extern void node_conf_weight_changed(void)
+{
+	weight_index_valid = false;
+}
+
 extern char *node_conf_nodestr_tokenize(char *s, char **save_ptr)
 {
 	char *end;
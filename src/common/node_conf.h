@@ -518,6 +518,28 @@ extern bitstr_t *node_conf_get_active_bitmap(void);
  */
 extern void node_conf_set_all_active_bits(bitstr_t *b);
 
+/* Nodes sharing the same configured Weight */
+typedef struct {
+	bitstr_t *node_bitmap;	/* nodes with this weight */
+	uint32_t weight;	/* configured node weight */
+} node_weight_bucket_t;
+
+/*
+ * Get all nodes grouped by configured Weight, in order of increasing weight.
+ * The index is rebuilt by the first call after node_conf_weight_changed() or
+ * a change in node_record_count.
+ *
+ * OUT count - number of buckets returned
+ * RET array of buckets, owned by node_conf. Do not modify or free.
+ *
+ * NOTE: Caller must hold the node read lock. Node weights must only change
+ * while holding the node write lock.
+ */
+extern node_weight_bucket_t *node_conf_get_weight_index(int *count);
+
+/* Rebuild the node weight index the next time it is used */
+extern void node_conf_weight_changed(void);
+
 /*
  * Tokenize node string on comma not followed by a digit. Return pointer to next
  * token or NULL if there are no more.
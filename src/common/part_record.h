@@ -43,6 +43,7 @@
 typedef struct {
 	slurmdb_bf_usage_t *job_usage;
 	slurmdb_bf_usage_t *resv_usage;
+	slurmdb_bf_usage_t *time_usage; /* count is msec spent testing jobs */
 	xhash_t *user_usage;
 } bf_part_data_t;
 
@@ -2424,6 +2424,9 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 	int i;
 	if (msg) {
 		xfree(msg->bf_exit);
+		xfree(msg->lock_wait_cnt);
+		xfree(msg->lock_wait_time);
+		xfree(msg->lock_wait_max);
 		xfree(msg->schedule_exit);
 		xfree(msg->rpc_type_id);
 		xfree(msg->rpc_type_cnt);
@@ -2432,6 +2435,7 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 		xfree(msg->rpc_type_dropped);
 		xfree(msg->rpc_type_cycle_last);
 		xfree(msg->rpc_type_cycle_max);
+		xfree(msg->rpc_type_coalesced);
 		xfree(msg->rpc_user_id);
 		xfree(msg->rpc_user_cnt);
 		xfree(msg->rpc_user_time);
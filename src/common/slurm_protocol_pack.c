@@ -12694,6 +12694,33 @@ static int _unpack_stats_response_msg(slurm_msg_t *smsg, buf_t *buffer)
 		safe_unpack32(&msg->bf_backfilled_het_jobs, buffer);
 		safe_unpack32_array(&msg->bf_exit, &msg->bf_exit_cnt, buffer);
 
+		if (smsg->protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+			safe_unpack64_array(&msg->lock_wait_cnt,
+					    &msg->lock_stats_cnt, buffer);
+			safe_unpack64_array(&msg->lock_wait_time, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+			safe_unpack64_array(&msg->lock_wait_max, &uint32_tmp,
+					    buffer);
+			if (uint32_tmp != msg->lock_stats_cnt)
+				goto unpack_error;
+
+			safe_unpack64(&msg->schedule_arena_alloc_cnt, buffer);
+			safe_unpack64(&msg->schedule_arena_alloc_bytes, buffer);
+			safe_unpack64(&msg->bf_arena_alloc_cnt, buffer);
+			safe_unpack64(&msg->bf_arena_alloc_bytes, buffer);
+
+			safe_unpack64(&msg->avail_cache_hits, buffer);
+			safe_unpack64(&msg->avail_cache_misses, buffer);
+
+			safe_unpack32(&msg->dbd_agent_batch_cnt, buffer);
+			safe_unpack32(&msg->dbd_agent_batch_max, buffer);
+			safe_unpack64(&msg->dbd_agent_msg_cnt, buffer);
+			safe_unpack64(&msg->dbd_agent_usec, buffer);
+			safe_unpack64(&msg->dbd_agent_usec_max, buffer);
+		}
+
 		safe_unpack32(&msg->rpc_type_size, buffer);
 		safe_unpack16_array(&msg->rpc_type_id, &uint32_tmp, buffer);
 		safe_unpack32_array(&msg->rpc_type_cnt, &uint32_tmp, buffer);
@@ -12709,6 +12736,10 @@ static int _unpack_stats_response_msg(slurm_msg_t *smsg, buf_t *buffer)
 					    &uint32_tmp, buffer);
 			safe_unpack16_array(&msg->rpc_type_cycle_max,
 					    &uint32_tmp, buffer);
+			if (smsg->protocol_version >=
+			    SLURM_26_05_PROTOCOL_VERSION)
+				safe_unpack64_array(&msg->rpc_type_coalesced,
+						    &uint32_tmp, buffer);
 		}
 
 		safe_unpack32(&msg->rpc_user_size, buffer);
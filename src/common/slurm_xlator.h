@@ -86,6 +86,7 @@
 #define	bit_or			slurm_bit_or
 #define	bit_set_count		slurm_bit_set_count
 #define	bit_set_count_range	slurm_bit_set_count_range
+#define	bit_set_count_range_not	slurm_bit_set_count_range_not
 #define	bit_clear_count		slurm_bit_clear_count
 #define	bit_rotate_copy		slurm_bit_rotate_copy
 #define	bit_rotate		slurm_bit_rotate
@@ -102,10 +103,15 @@
 #define	bit_super_set		slurm_bit_super_set
 #define	bit_overlap		slurm_bit_overlap
 #define	bit_overlap_any		slurm_bit_overlap_any
+#define	bit_overlap_not		slurm_bit_overlap_not
+#define	bit_overlap_not_any	slurm_bit_overlap_not_any
 #define	bit_copy		slurm_bit_copy
+#define	bit_alloc_arena		slurm_bit_alloc_arena
+#define	bit_copy_arena		slurm_bit_copy_arena
 #define	bit_equal		slurm_bit_equal
 #define	bit_pick_cnt		slurm_bit_pick_cnt
 #define bit_copybits		slurm_bit_copybits
+#define bit_copybits_and_not	slurm_bit_copybits_and_not
 #define	bit_get_bit_num		slurm_bit_get_bit_num
 
 /* fd.[ch] functions */
@@ -354,6 +360,7 @@
 #define lock_state_files	slurm_lock_state_files
 #define unlock_state_files	slurm_unlock_state_files
 #define save_buf_to_state	slurm_save_buf_to_state
+#define append_buf_to_state	slurm_append_buf_to_state
 
 /* strlcpy.[ch] functions */
 #ifndef HAVE_STRLCPY
@@ -370,6 +377,11 @@
 /* xmalloc.[ch] functions */
 #define xsize			slurm_xsize
 #define xfree_ptr		slurm_xfree_ptr
+#define xfree_arena_ptr		slurm_xfree_arena_ptr
+#define xarena_create		slurm_xarena_create
+#define xarena_reset		slurm_xarena_reset
+#define xarena_destroy		slurm_xarena_destroy
+#define xarena_item		slurm_xarena_item
 
 /* xsignal.[ch] functions */
 #define	xsignal			slurm_xsignal
@@ -47,6 +47,7 @@
 strong_alias(lock_state_files, slurm_lock_state_files);
 strong_alias(unlock_state_files, slurm_unlock_state_files);
 strong_alias(save_buf_to_state, slurm_save_buf_to_state);
+strong_alias(append_buf_to_state, slurm_append_buf_to_state);
 
 /* global variables */
 int clustername_existed = -1;
@@ -136,6 +137,44 @@ fail:
 	return rc;
 }
 
+extern int append_buf_to_state(const char *target_file, buf_t *buf)
+{
+	int rc = 0, fd = -1;
+	char *reg_file;
+
+	if (target_file[0] == '/')
+		reg_file = xstrdup(target_file);
+	else
+		reg_file = xstrdup_printf("%s/%s",
+					  slurm_conf.state_save_location,
+					  target_file);
+
+	lock_state_files();
+	fd = open(reg_file, O_WRONLY|O_APPEND|O_CLOEXEC);
+	if (fd < 0) {
+		rc = errno ? errno : SLURM_ERROR;
+		error("Can't append state, error opening file %s: %m",
+		      reg_file);
+		goto fail;
+	}
+
+	if ((rc = _write_file(fd, buf)) != SLURM_SUCCESS) {
+		error("Can't append state, error writing file %s: %m",
+		      reg_file);
+		(void) close(fd);
+		goto fail;
+	}
+
+	/* provides own logging on error */
+	rc = fsync_and_close(fd, reg_file);
+
+fail:
+	unlock_state_files();
+	xfree(reg_file);
+
+	return rc;
+}
+
 extern buf_t *state_save_open(const char *target_file, char **state_file)
 {
 	buf_t *buf;
@@ -57,6 +57,17 @@ extern void unlock_state_files(void);
 extern int save_buf_to_state(const char *target_file, buf_t *buf,
 			     uint32_t *high_buffer_size);
 
+/*
+ * Append buffer data to existing state file
+ *
+ * IN target_file - Path to state file in slurm_conf.state_save_location,
+ *                  or absolute path to state file.
+ * IN buf - Data to append to target_file
+ *
+ * RET SLURM_SUCCESS or error. On error, target_file may end with part of buf.
+ */
+extern int append_buf_to_state(const char *target_file, buf_t *buf);
+
 /*
  * Open buffer to state file
  *
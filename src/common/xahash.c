@@ -69,6 +69,22 @@
  *
  * Hash collisions are slow and break the O(1) design and should be avoided.
  *
+ * Dynamic size hash table: xahash_table_t
+ * The dynamic xahash_table_t keeps the header and state blob in one xmalloc()
+ * and the entries in a separate array that is found by linear probing (open
+ * addressing). The array doubles in size whenever it would become more than
+ * half full, which keeps probe sequences short without any per entry
+ * xmalloc(). Releasing an entry shifts the following entries of its probe
+ * sequence back instead of leaving tombstones.
+ *
+ * |----------------|----------------|     |----------------|
+ * | entry header   | entry header   |     | entry header   |
+ * |     flags, hash|     flags, hash| ... |     flags, hash|
+ * |----------------|----------------|     |----------------|
+ * | entry blob     | entry blob     |     | entry blob     |
+ * |----------------|----------------|     |----------------|
+ *   _get_dentry(0)   _get_dentry(1)         _get_dentry(count - 1)
+ *
  */
 
 #include "src/common/log.h"
@@ -88,6 +104,10 @@
 
 #define HASH_TABLE_MAGIC 0x131e1aff
 #define HASH_FENTRY_MAGIC(index) (((uint32_t) 0xffff0000) ^ ((uint32_t) index))
+#define HASH_DENTRY_MAGIC 0x1ade1fff
+
+/* Initial number of entries in a dynamic table (must be power of 2) */
+#define DYNAMIC_MIN_BITS 4
 
 typedef enum {
 	HT_FLAG_STATE_MASK = 0xff,
@@ -113,6 +133,13 @@ typedef struct {
 		struct {
 			size_t count;
 		} fixed;
+		struct {
+			int bits; /* log2 of count */
+			size_t count; /* number of entries allocated */
+			size_t used; /* number of entries set */
+			size_t bytes_per_dentry; /* header and blob, aligned */
+			void *dentries; /* array of entries */
+		} dynamic;
 	} type;
 } xahash_table_header_t;
 
@@ -132,6 +159,18 @@ struct fentry_header_s {
 	fentry_header_t *next;
 };
 
+/* Dynamic size entry struct */
+typedef struct {
+	ONLY_DEBUG(int magic); /* HASH_DENTRY_MAGIC */
+	fentry_flags_t flags;
+	/* cached hash of key to avoid calling match_func() on mismatches */
+	xahash_hash_t hash;
+} dentry_header_t;
+
+/* Offset of entry blob, padded to keep pointers in the blob aligned */
+#define DENTRY_BLOB_OFFSET \
+	((sizeof(dentry_header_t) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
 static const struct {
 	const char *str;
 	xahash_foreach_control_t value;
@@ -173,6 +212,41 @@ static int _fixed_hash_to_index(const xahash_table_t *ht,
 	return hash % hth->type.fixed.count;
 }
 
+static bool _is_dynamic(const xahash_table_t *ht,
+			const xahash_table_header_t *hth)
+{
+	_check_magic(ht);
+
+	return ((hth->flags & HT_FLAG_STATE_MASK) == HT_FLAG_DYNAMIC_SIZE);
+}
+
+/*
+ * Spread hash over the table with Fibonacci hashing so that sequential hashes
+ * (such as numeric IDs) do not form long runs of adjacent entries.
+ */
+static size_t _dynamic_hash_to_index(const xahash_table_header_t *hth,
+				     const xahash_hash_t hash)
+{
+	return ((uint32_t) (hash * 0x9e3779b9U)) >> (32 - hth->type.dynamic.bits);
+}
+
+static dentry_header_t *_get_dentry(const xahash_table_header_t *hth,
+				    const size_t index)
+{
+	xassert(index < hth->type.dynamic.count);
+
+	return hth->type.dynamic.dentries +
+		(hth->type.dynamic.bytes_per_dentry * index);
+}
+
+static void *_get_dentry_blob(const dentry_header_t *de)
+{
+	xassert(de->magic == HASH_DENTRY_MAGIC);
+	xassert(de->flags & FENTRY_FLAG_SET);
+
+	return ((void *) de) + DENTRY_BLOB_OFFSET;
+}
+
 static void *_get_state(const xahash_table_t *ht)
 {
 	return ((void *) ht) + sizeof(xahash_table_header_t);
@@ -353,6 +427,75 @@ static xahash_table_t *_new_fixed_table(xahash_func_t hash_func,
 	return ht;
 }
 
+static void *_new_dentries(const xahash_table_header_t *hth, const int bits)
+{
+	const size_t count = ((size_t) 1) << bits;
+	void *dentries = xmalloc_nz(hth->type.dynamic.bytes_per_dentry * count);
+
+	for (size_t i = 0; i < count; i++) {
+		dentry_header_t *de =
+			dentries + (hth->type.dynamic.bytes_per_dentry * i);
+
+		*de = (dentry_header_t) {
+			ONLY_DEBUG(.magic = HASH_DENTRY_MAGIC,)
+			.flags = FENTRY_FLAG_UNSET,
+		};
+	}
+
+	return dentries;
+}
+
+static xahash_table_t *_new_dynamic_table(
+	xahash_func_t hash_func, const char *hash_func_string,
+	xahash_match_func_t match_func, const char *match_func_string,
+	xahash_on_insert_func_t on_insert_func,
+	const char *on_insert_func_string, xahash_on_free_func_t on_free_func,
+	const char *on_free_func_string, const size_t state_bytes,
+	const size_t bytes_per_entry)
+{
+	xahash_table_t *ht;
+	xahash_table_header_t *hth;
+	size_t bytes_per_dentry = DENTRY_BLOB_OFFSET + bytes_per_entry;
+
+	xassert(bytes_per_entry > 0);
+
+	/* keep every entry header aligned */
+	bytes_per_dentry = (bytes_per_dentry + sizeof(void *) - 1) &
+		~(sizeof(void *) - 1);
+
+	log_flag(DATA, "%s: initializing dynamic xahash_table_t with %zu bytes per entry and %zu state bytes. Callbacks: hash_func=%s()@0x%"PRIxPTR" match_func=%s()@0x%"PRIxPTR" on_insert_func=%s()@0x%"PRIxPTR" on_free_func=%s()@0x%"PRIxPTR,
+		__func__, bytes_per_entry, state_bytes, hash_func_string,
+		(uintptr_t) hash_func, match_func_string,
+		(uintptr_t) match_func, on_insert_func_string,
+		(uintptr_t) on_insert_func, on_free_func_string,
+		(uintptr_t) on_free_func);
+
+	hth = ht = xmalloc_nz(sizeof(*hth) + state_bytes);
+	*hth = (xahash_table_header_t){
+		ONLY_DEBUG(.magic = HASH_TABLE_MAGIC,)
+		.flags = HT_FLAG_DYNAMIC_SIZE,
+		.hash_func = hash_func,
+		.match_func = match_func,
+		.match_func_string = match_func_string,
+		.on_insert_func = on_insert_func,
+		.on_insert_func_string = on_insert_func_string,
+		.on_free_func = on_free_func,
+		.on_free_func_string = on_free_func_string,
+		.state_blob_bytes = state_bytes,
+		.bytes_per_entry_blob = bytes_per_entry,
+		.type.dynamic = {
+			.bits = DYNAMIC_MIN_BITS,
+			.count = ((size_t) 1) << DYNAMIC_MIN_BITS,
+			.bytes_per_dentry = bytes_per_dentry,
+		},
+	};
+	hth->type.dynamic.dentries = _new_dentries(hth, DYNAMIC_MIN_BITS);
+
+	ONLY_DEBUG(memset(_get_state(ht), 0, state_bytes));
+
+	return ht;
+}
+
 extern xahash_table_t *xahash_new_table_funcname(
 	xahash_func_t hash_func, const char *hash_func_string,
 	xahash_match_func_t match_func, const char *match_func_string,
@@ -368,8 +511,11 @@ extern xahash_table_t *xahash_new_table_funcname(
 					on_free_func_string, state_bytes,
 					bytes_per_entry, fixed_table_size);
 
-	/* TODO: dynamic sizing not implemented yet */
-	fatal_abort("should never execute");
+	return _new_dynamic_table(hash_func, hash_func_string, match_func,
+				  match_func_string, on_insert_func,
+				  on_insert_func_string, on_free_func,
+				  on_free_func_string, state_bytes,
+				  bytes_per_entry);
 }
 
 static void _free_fentry(xahash_table_t *ht, xahash_table_header_t *hth,
@@ -447,6 +593,20 @@ static void _free_fixed_table_members(xahash_table_t *ht,
 	}
 }
 
+static void _free_dynamic_table_members(xahash_table_t *ht,
+					xahash_table_header_t *hth)
+{
+	for (size_t i = 0; hth->on_free_func && (i < hth->type.dynamic.count);
+	     i++) {
+		dentry_header_t *de = _get_dentry(hth, i);
+
+		if (de->flags & FENTRY_FLAG_SET)
+			hth->on_free_func(_get_dentry_blob(de), _get_state(ht));
+	}
+
+	xfree(hth->type.dynamic.dentries);
+}
+
 extern void xahash_free_table(xahash_table_t *ht)
 {
 	xahash_table_header_t *hth;
@@ -462,6 +622,8 @@ extern void xahash_free_table(xahash_table_t *ht)
 
 	if (_is_fixed(ht, hth))
 		_free_fixed_table_members(ht, hth);
+	else if (_is_dynamic(ht, hth))
+		_free_dynamic_table_members(ht, hth);
 
 	ONLY_DEBUG(hth->magic = ~HASH_TABLE_MAGIC);
 	xfree(ht);
@@ -571,6 +733,59 @@ static void *_find_fixed_entry_blob(const xahash_table_t *ht,
 	return _get_fentry_blob(ht, hth, fe);
 }
 
+/*
+ * Find entry matching key in dynamic table
+ * OUT index_ptr - index of entry (if found) or of the empty entry ending the
+ *	probe sequence
+ * RET entry or NULL if not found
+ */
+static dentry_header_t *_find_dentry(const xahash_table_t *ht,
+				     const xahash_table_header_t *hth,
+				     const xahash_hash_t hash, const void *key,
+				     const size_t key_bytes, size_t *index_ptr)
+{
+	const size_t mask = hth->type.dynamic.count - 1;
+	size_t index = _dynamic_hash_to_index(hth, hash);
+
+	/* table is never more than half full so there is always an end */
+	while (true) {
+		dentry_header_t *de = _get_dentry(hth, index);
+
+		xassert(de->magic == HASH_DENTRY_MAGIC);
+
+		if (!(de->flags & FENTRY_FLAG_SET))
+			break;
+
+		if ((de->hash == hash) &&
+		    hth->match_func(_get_dentry_blob(de), key, key_bytes,
+				    _get_state(ht))) {
+			*index_ptr = index;
+			return de;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	*index_ptr = index;
+	return NULL;
+}
+
+static void *_find_dynamic_entry_blob(const xahash_table_t *ht,
+				      const xahash_table_header_t *hth,
+				      const void *key, const size_t key_bytes)
+{
+	const xahash_hash_t hash =
+		hth->hash_func(key, key_bytes, _get_state(ht));
+	size_t index;
+	dentry_header_t *de =
+		_find_dentry(ht, hth, hash, key, key_bytes, &index);
+
+	if (!de)
+		return NULL;
+
+	return _get_dentry_blob(de);
+}
+
 extern void *xahash_find_entry(const xahash_table_t *ht, const void *key,
 			       const size_t key_bytes)
 {
@@ -592,6 +807,8 @@ extern void *xahash_find_entry(const xahash_table_t *ht, const void *key,
 
 	if (_is_fixed(ht, hth))
 		ptr = _find_fixed_entry_blob(ht, hth, key, key_bytes);
+	else if (_is_dynamic(ht, hth))
+		ptr = _find_dynamic_entry_blob(ht, hth, key, key_bytes);
 	else
 		fatal_abort("should never execute");
 
@@ -693,6 +910,81 @@ static void *_insert_fixed_entry(xahash_table_t *ht, xahash_table_header_t *hth,
 	return _get_fentry_blob(ht, hth, fe);
 }
 
+/* Double the number of entries and move every set entry to its new place */
+static void _grow_dynamic_table(xahash_table_t *ht, xahash_table_header_t *hth)
+{
+	void *old_dentries = hth->type.dynamic.dentries;
+	const size_t old_count = hth->type.dynamic.count;
+	const size_t bytes_per_dentry = hth->type.dynamic.bytes_per_dentry;
+	size_t mask;
+
+	hth->type.dynamic.bits++;
+	hth->type.dynamic.count = ((size_t) 1) << hth->type.dynamic.bits;
+	hth->type.dynamic.dentries = _new_dentries(hth,
+						   hth->type.dynamic.bits);
+	mask = hth->type.dynamic.count - 1;
+
+	log_flag(DATA, "%s: [hashtable@0x%"PRIxPTR"] growing from %zu to %zu entries with %zu set",
+		 __func__, (uintptr_t) ht, old_count, hth->type.dynamic.count,
+		 hth->type.dynamic.used);
+
+	for (size_t i = 0; i < old_count; i++) {
+		dentry_header_t *old = old_dentries + (bytes_per_dentry * i);
+		size_t index;
+
+		if (!(old->flags & FENTRY_FLAG_SET))
+			continue;
+
+		index = _dynamic_hash_to_index(hth, old->hash);
+		while (_get_dentry(hth, index)->flags & FENTRY_FLAG_SET)
+			index = (index + 1) & mask;
+
+		memcpy(_get_dentry(hth, index), old, bytes_per_dentry);
+	}
+
+	xfree(old_dentries);
+}
+
+static void *_insert_dynamic_entry(xahash_table_t *ht,
+				   xahash_table_header_t *hth, const void *key,
+				   const size_t key_bytes)
+{
+	const xahash_hash_t hash =
+		hth->hash_func(key, key_bytes, _get_state(ht));
+	size_t index;
+	dentry_header_t *de =
+		_find_dentry(ht, hth, hash, key, key_bytes, &index);
+
+	if (de) {
+		log_flag(DATA, "%s: [hashtable@0x%"PRIxPTR"] ignoring duplicate insert on existing dentry[%zu]@0x%"PRIxPTR,
+			 __func__, (uintptr_t) ht, index, (uintptr_t) de);
+		return _get_dentry_blob(de);
+	}
+
+	if (((hth->type.dynamic.used + 1) * 2) > hth->type.dynamic.count) {
+		_grow_dynamic_table(ht, hth);
+		(void) _find_dentry(ht, hth, hash, key, key_bytes, &index);
+	}
+
+	de = _get_dentry(hth, index);
+
+	/* check for clobbering */
+	xassert(de->flags == FENTRY_FLAG_UNSET);
+
+	de->flags = FENTRY_FLAG_SET;
+	de->hash = hash;
+	hth->type.dynamic.used++;
+
+	if (hth->on_insert_func)
+		hth->on_insert_func(_get_dentry_blob(de), key, key_bytes,
+				    _get_state(ht));
+
+	log_flag(DATA, "%s: [hashtable@0x%"PRIxPTR"] inserted dentry[%zu]@0x%"PRIxPTR"=#0x%x",
+		 __func__, (uintptr_t) ht, index, (uintptr_t) de, hash);
+
+	return _get_dentry_blob(de);
+}
+
 extern void *xahash_insert_entry(xahash_table_t *ht, const void *key,
 				 const size_t key_bytes)
 {
@@ -715,8 +1007,10 @@ extern void *xahash_insert_entry(xahash_table_t *ht, const void *key,
 
 	if (_is_fixed(ht, hth))
 		ptr = _insert_fixed_entry(ht, hth, key, key_bytes);
+	else if (_is_dynamic(ht, hth))
+		ptr = _insert_dynamic_entry(ht, hth, key, key_bytes);
 	else
-	fatal_abort("should never execute");
+		fatal_abort("should never execute");
 
 	END_DEBUG_TIMER;
 
@@ -765,6 +1059,61 @@ static bool _find_and_free_fentry(xahash_table_t *ht,
 	return true;
 }
 
+static bool _find_and_free_dentry(xahash_table_t *ht,
+				  xahash_table_header_t *hth, const void *key,
+				  const size_t key_bytes)
+{
+	const xahash_hash_t hash =
+		hth->hash_func(key, key_bytes, _get_state(ht));
+	const size_t mask = hth->type.dynamic.count - 1;
+	const size_t bytes_per_dentry = hth->type.dynamic.bytes_per_dentry;
+	size_t index, next;
+	dentry_header_t *de =
+		_find_dentry(ht, hth, hash, key, key_bytes, &index);
+
+	if (!de)
+		return false;
+
+	log_flag(DATA, "%s: [hashtable@0x%"PRIxPTR"] releasing dentry[%zu]@0x%"PRIxPTR,
+		 __func__, (uintptr_t) ht, index, (uintptr_t) de);
+
+	if (hth->on_free_func)
+		hth->on_free_func(_get_dentry_blob(de), _get_state(ht));
+
+	/*
+	 * Shift back any following entries of the probe sequence that would
+	 * no longer be found once this entry is empty.
+	 */
+	next = index;
+	while (true) {
+		dentry_header_t *nde;
+		size_t home;
+
+		next = (next + 1) & mask;
+		nde = _get_dentry(hth, next);
+
+		if (!(nde->flags & FENTRY_FLAG_SET))
+			break;
+
+		/* Leave entry if its home is cyclically in (index, next] */
+		home = _dynamic_hash_to_index(hth, nde->hash);
+		if ((index <= next) ? ((index < home) && (home <= next)) :
+				      ((index < home) || (home <= next)))
+			continue;
+
+		memcpy(_get_dentry(hth, index), nde, bytes_per_dentry);
+		index = next;
+	}
+
+	*_get_dentry(hth, index) = (dentry_header_t) {
+		ONLY_DEBUG(.magic = HASH_DENTRY_MAGIC,)
+		.flags = FENTRY_FLAG_UNSET,
+	};
+	hth->type.dynamic.used--;
+
+	return true;
+}
+
 extern bool xahash_free_entry(xahash_table_t *ht, const void *key,
 			      const size_t key_bytes)
 {
@@ -787,6 +1136,8 @@ extern bool xahash_free_entry(xahash_table_t *ht, const void *key,
 
 	if (_is_fixed(ht, hth)) {
 		rc = _find_and_free_fentry(ht, hth, key, key_bytes);
+	} else if (_is_dynamic(ht, hth)) {
+		rc = _find_and_free_dentry(ht, hth, key, key_bytes);
 	} else {
 		fatal_abort("should never execute");
 	}
@@ -864,6 +1215,48 @@ static int _foreach_fentry(xahash_table_t *ht, xahash_table_header_t *hth,
 	return count;
 }
 
+static int _foreach_dentry(xahash_table_t *ht, xahash_table_header_t *hth,
+			   xahash_foreach_func_t callback,
+			   const char *callback_string, void *arg)
+{
+	uint32_t count = 0;
+
+	for (size_t i = 0; i < hth->type.dynamic.count; i++) {
+		dentry_header_t *de = _get_dentry(hth, i);
+		xahash_foreach_control_t rc;
+
+		if (!(de->flags & FENTRY_FLAG_SET))
+			continue;
+
+		count++;
+
+		rc = callback(_get_dentry_blob(de), _get_state(ht), arg);
+
+		log_flag(DATA, "%s: [hashtable@0x%"PRIxPTR"] called after %s()@0x%"PRIxPTR"=%s for dentry[%zu]@0x%"PRIxPTR,
+			 __func__, (uintptr_t) ht, callback_string,
+			 (uintptr_t) callback, _foreach_control_string(rc), i,
+			 (uintptr_t) de);
+
+		xassert(rc > XAHASH_FOREACH_INVALID);
+		xassert(rc < XAHASH_FOREACH_INVALID_MAX);
+
+		switch (rc) {
+		case XAHASH_FOREACH_CONT:
+			/* do nothing */
+			break;
+		case XAHASH_FOREACH_STOP:
+			return count;
+		case XAHASH_FOREACH_FAIL:
+			return (count * -1);
+		case XAHASH_FOREACH_INVALID:
+		case XAHASH_FOREACH_INVALID_MAX:
+			fatal_abort("should never execute");
+		}
+	}
+
+	return count;
+}
+
 extern int xahash_foreach_entry_funcname(xahash_table_t *ht,
 					 xahash_foreach_func_t callback,
 					 const char *callback_string, void *arg)
@@ -885,6 +1278,8 @@ extern int xahash_foreach_entry_funcname(xahash_table_t *ht,
 
 	if (_is_fixed(ht, hth))
 		rc = _foreach_fentry(ht, hth, callback, callback_string, arg);
+	else if (_is_dynamic(ht, hth))
+		rc = _foreach_dentry(ht, hth, callback, callback_string, arg);
 	else
 		fatal_abort("should never execute");
 
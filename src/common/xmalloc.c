@@ -54,9 +54,44 @@
 #include "src/common/xmalloc.h"
 
 strong_alias(xfree_ptr, slurm_xfree_ptr);
+strong_alias(xfree_arena_ptr, slurm_xfree_arena_ptr);
 strong_alias(xsize, slurm_xsize);
+strong_alias(xarena_create, slurm_xarena_create);
+strong_alias(xarena_reset, slurm_xarena_reset);
+strong_alias(xarena_destroy, slurm_xarena_destroy);
+strong_alias(xarena_item, slurm_xarena_item);
 
 #define XMALLOC_MAGIC 0x42
+#define XMALLOC_ARENA_MAGIC 0x43	/* item carved out of an xarena_t */
+
+#define XARENA_MAGIC 0x2c7a1e5b
+/*
+ * Disable arenas in MEMORY_LEAK_DEBUG so valgrind tracks every item on its
+ * own, same as the bitstring cache.
+ */
+#ifdef MEMORY_LEAK_DEBUG
+#define XARENA_ENABLED false
+#else
+#define XARENA_ENABLED true
+#endif
+#define XARENA_ALIGN 16
+#define XARENA_ROUNDUP(x) (((x) + XARENA_ALIGN - 1) & ~(XARENA_ALIGN - 1))
+#define XARENA_CHUNK_HDR XARENA_ROUNDUP(sizeof(xarena_chunk_t))
+#define XARENA_CHUNK_DATA(c) ((char *) (c) + XARENA_CHUNK_HDR)
+
+typedef struct xarena_chunk {
+	struct xarena_chunk *next;
+	size_t size;		/* bytes available after the header */
+	size_t used;		/* bytes handed out */
+} xarena_chunk_t;
+
+struct xarena {
+	int magic;		/* XARENA_MAGIC */
+	size_t chunk_size;	/* size of regular chunks */
+	xarena_chunk_t *chunks;	/* chunks in use, current chunk first */
+	xarena_chunk_t *spare;	/* regular chunks kept over xarena_reset() */
+	xarena_stats_t stats;
+};
 
 /*
  * "Safe" version of malloc().
@@ -146,7 +181,23 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 	count_size = count * size;
 	total_size = count_size + 2 * sizeof(size_t);
 
-	if (*item != NULL) {
+	if (*item && (((size_t *) *item)[-2] == XMALLOC_ARENA_MAGIC)) {
+		size_t *old_p = (size_t *) *item - 2;
+
+		/*
+		 * Arena items can not grow in place, move the item to the heap
+		 * where it is an ordinary xmalloc() item from now on.
+		 */
+		if (clear)
+			p = calloc(1, total_size);
+		else
+			p = malloc(total_size);
+		if (p == NULL)
+			goto error;
+		memcpy(&p[2], &old_p[2], MIN(old_p[1], count_size));
+		old_p[0] = 0;
+		p[0] = XMALLOC_MAGIC;
+	} else if (*item != NULL) {
 		size_t old_size;
 		p = (size_t *)*item - 2;
 
@@ -194,7 +245,8 @@ size_t xsize(void *item)
 {
 	size_t *p = (size_t *)item - 2;
 	xassert(item != NULL);
-	xassert(p[0] == XMALLOC_MAGIC); /* CLANG false positive here */
+	/* CLANG false positive here */
+	xassert((p[0] == XMALLOC_MAGIC) || (p[0] == XMALLOC_ARENA_MAGIC));
 	return p[1];
 }
 
@@ -207,6 +259,16 @@ void slurm_xfree(void **item)
 {
 	if (*item != NULL) {
 		size_t *p = (size_t *)*item - 2;
+
+		/* Arena items must be released with xfree_arena() */
+		xassert(p[0] != XMALLOC_ARENA_MAGIC);
+		if (p[0] == XMALLOC_ARENA_MAGIC) {
+			error("%s: arena item %p passed to xfree()",
+			      __func__, *item);
+			*item = NULL;
+			return;
+		}
+
 		/* magic cookie still there? */
 		xassert(p[0] == XMALLOC_MAGIC);
 		p[0] = 0;	/* make sure xfree isn't called twice */
@@ -215,6 +277,22 @@ void slurm_xfree(void **item)
 	}
 }
 
+/*
+ * Free an item that may have been allocated out of an xarena_t. Arena items
+ * are left to xarena_reset(), other items are xfree()'d.
+ *   item (IN/OUT)	double-pointer to allocated space
+ */
+void slurm_xfree_arena(void **item)
+{
+	if (*item && xarena_item(*item)) {
+		((size_t *) *item)[-2] = 0;
+		*item = NULL;
+		return;
+	}
+
+	slurm_xfree(item);
+}
+
 /*
  * Free a NULL-terminated xmalloc()'d array of pointers to further xmalloc()'d
  * elements, and NULL the original pointer to prevent accidental reuse.
@@ -238,3 +316,156 @@ void xfree_ptr(void *ptr)
 {
 	slurm_xfree(&ptr);
 }
+
+/* List destructor for items that may have been allocated out of an arena */
+void xfree_arena_ptr(void *ptr)
+{
+	slurm_xfree_arena(&ptr);
+}
+
+extern xarena_t *xarena_create(size_t chunk_size)
+{
+	xarena_t *arena = xmalloc(sizeof(*arena));
+
+	arena->magic = XARENA_MAGIC;
+	arena->chunk_size = MAX(chunk_size, XARENA_CHUNK_MIN);
+
+	return arena;
+}
+
+static xarena_chunk_t *_add_chunk(xarena_t *arena, size_t total_size,
+				  const char *file, int line, const char *func)
+{
+	xarena_chunk_t *chunk;
+
+	if (total_size > arena->chunk_size) {
+		/*
+		 * Give large items a chunk of their own. Keep it behind the
+		 * current chunk so the space left there is still used.
+		 */
+		if (!(chunk = malloc(XARENA_CHUNK_HDR + total_size))) {
+			log_oom(file, line, func);
+			abort();
+		}
+		chunk->size = total_size;
+		chunk->used = 0;
+		if (arena->chunks) {
+			chunk->next = arena->chunks->next;
+			arena->chunks->next = chunk;
+		} else {
+			chunk->next = NULL;
+			arena->chunks = chunk;
+		}
+		arena->stats.chunk_cnt++;
+		return chunk;
+	}
+
+	if ((chunk = arena->spare)) {
+		arena->spare = chunk->next;
+	} else {
+		if (!(chunk = malloc(XARENA_CHUNK_HDR + arena->chunk_size))) {
+			log_oom(file, line, func);
+			abort();
+		}
+		chunk->size = arena->chunk_size;
+		arena->stats.chunk_cnt++;
+	}
+	chunk->used = 0;
+	chunk->next = arena->chunks;
+	arena->chunks = chunk;
+
+	return chunk;
+}
+
+extern void *slurm_xarena_xcalloc(xarena_t *arena, size_t count, size_t size,
+				  bool clear, const char *file, int line,
+				  const char *func)
+{
+	size_t count_size, total_size;
+	xarena_chunk_t *chunk;
+	size_t *p;
+
+	if (!arena)
+		return slurm_xcalloc(count, size, clear, false, file, line,
+				     func);
+
+	xassert(arena->magic == XARENA_MAGIC);
+
+	if (!size || !count)
+		return NULL;
+
+	/* Same limit as slurm_xcalloc() */
+	if ((count != 1) && (count > SIZE_MAX / size / 4)) {
+		log_oom(file, line, func);
+		abort();
+	}
+
+	count_size = count * size;
+	arena->stats.alloc_cnt++;
+	arena->stats.alloc_bytes += count_size;
+
+	if (!XARENA_ENABLED)
+		return slurm_xcalloc(count, size, clear, false, file, line,
+				     func);
+
+	total_size = XARENA_ROUNDUP(count_size + 2 * sizeof(size_t));
+
+	chunk = arena->chunks;
+	if (!chunk || ((chunk->size - chunk->used) < total_size))
+		chunk = _add_chunk(arena, total_size, file, line, func);
+
+	p = (size_t *) (XARENA_CHUNK_DATA(chunk) + chunk->used);
+	chunk->used += total_size;
+
+	if (clear)
+		memset(&p[2], 0, count_size);
+	p[0] = XMALLOC_ARENA_MAGIC;
+	p[1] = count_size;
+
+	return &p[2];
+}
+
+extern void xarena_reset(xarena_t *arena, xarena_stats_t *stats)
+{
+	xarena_chunk_t *chunk;
+
+	if (!arena)
+		return;
+
+	xassert(arena->magic == XARENA_MAGIC);
+
+	if (stats)
+		*stats = arena->stats;
+	memset(&arena->stats, 0, sizeof(arena->stats));
+
+	while ((chunk = arena->chunks)) {
+		arena->chunks = chunk->next;
+		if (chunk->size == arena->chunk_size) {
+			chunk->next = arena->spare;
+			arena->spare = chunk;
+		} else {
+			free(chunk);
+		}
+	}
+}
+
+extern void xarena_destroy(xarena_t **arena)
+{
+	xarena_chunk_t *chunk;
+
+	if (!*arena)
+		return;
+
+	xarena_reset(*arena, NULL);
+	while ((chunk = (*arena)->spare)) {
+		(*arena)->spare = chunk->next;
+		free(chunk);
+	}
+	(*arena)->magic = ~XARENA_MAGIC;
+	xfree(*arena);
+}
+
+extern bool xarena_item(void *item)
+{
+	return (item && (((size_t *) item)[-2] == XMALLOC_ARENA_MAGIC));
+}
@@ -63,12 +63,20 @@
  * p. The memory must have been allocated with [try_]xmalloc() or
  * [try_]xrealloc().
  *
+ * xmalloc_arena(a, size) allocates size bytes out of the arena a, see
+ * xarena_create() below. The memory is set to zero and is released by
+ * xarena_reset(). It must not be passed to xfree(). Code handling items
+ * that may come from either an arena or the heap releases them with
+ * xfree_arena(p), which only frees heap memory. xrealloc() moves an arena
+ * item to the heap, from where it is an ordinary xmalloc() item.
+ *
 \*****************************************************************************/
 
 #ifndef _XMALLOC_H
 #define _XMALLOC_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #define xcalloc(__cnt, __sz) \
@@ -89,8 +97,21 @@
 #define xmalloc_nz(__sz) \
 	slurm_xcalloc(1, __sz, false, false, __FILE__, __LINE__, __func__)
 
+#define xmalloc_arena(__a, __sz) \
+	slurm_xarena_xcalloc(__a, 1, __sz, true, __FILE__, __LINE__, __func__)
+
+#define xcalloc_arena(__a, __cnt, __sz) \
+	slurm_xarena_xcalloc(__a, __cnt, __sz, true, __FILE__, __LINE__, \
+			     __func__)
+
+#define xcalloc_nz_arena(__a, __cnt, __sz) \
+	slurm_xarena_xcalloc(__a, __cnt, __sz, false, __FILE__, __LINE__, \
+			     __func__)
+
 #define xfree(__p) slurm_xfree((void **)&(__p))
 
+#define xfree_arena(__p) slurm_xfree_arena((void **)&(__p))
+
 #define xfree_array(__p) slurm_xfree_array((void ***)&(__p))
 
 #define xrecalloc(__p, __cnt, __sz) \
@@ -110,11 +131,57 @@
 
 void *slurm_xcalloc(size_t, size_t, bool, bool, const char *, int, const char *);
 void slurm_xfree(void **);
+void slurm_xfree_arena(void **);
 void slurm_xfree_array(void ***);
 void *slurm_xrecalloc(void **, size_t, size_t, bool, bool, const char *, int, const char *);
 
 size_t xsize(void *item);
 
 void xfree_ptr(void *);
+void xfree_arena_ptr(void *);
+
+/*
+ * Arena for short-lived allocations that all die at the same time, such as
+ * the temporaries of one scheduling cycle. Items are carved sequentially out
+ * of large chunks and all of them are released at once by xarena_reset(),
+ * which keeps the chunks for the next round instead of returning them to
+ * malloc.
+ *
+ * An arena is not thread safe, it is meant to be owned by a single thread.
+ * Nothing allocated from it may outlive the next xarena_reset().
+ * Passing a NULL arena to the *_arena() macros allocates from the heap.
+ */
+#define XARENA_CHUNK_MIN (64 * 1024)
+
+typedef struct xarena xarena_t;
+
+typedef struct {
+	uint64_t alloc_cnt;	/* items allocated since last reset */
+	uint64_t alloc_bytes;	/* bytes requested since last reset */
+	uint32_t chunk_cnt;	/* chunks malloc()'d since last reset */
+} xarena_stats_t;
+
+/*
+ * Create an arena
+ * IN chunk_size - bytes per chunk, at least XARENA_CHUNK_MIN is used
+ * RET arena, free with xarena_destroy()
+ */
+extern xarena_t *xarena_create(size_t chunk_size);
+
+/*
+ * Release every item allocated out of arena
+ * IN arena - arena to reset, may be NULL
+ * OUT stats - allocation statistics since the previous reset, may be NULL
+ */
+extern void xarena_reset(xarena_t *arena, xarena_stats_t *stats);
+
+/* Release all memory of arena and set it to NULL */
+extern void xarena_destroy(xarena_t **arena);
+
+/* Return true if item was allocated out of an arena */
+extern bool xarena_item(void *item);
+
+void *slurm_xarena_xcalloc(xarena_t *, size_t, size_t, bool, const char *,
+			   int, const char *);
 
 #endif /* !_XMALLOC_H */
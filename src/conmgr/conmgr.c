@@ -41,6 +41,7 @@
 #include "src/common/atomic.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
 #include "src/common/probes.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_time.h"
@@ -60,6 +61,8 @@
 
 #define MAX_CONNECTIONS_DEFAULT 150
 #define CTIME_STR_LEN 72
+/* Work slots in ring before overflowing into mgr.work list */
+#define WORK_RING_SIZE 4096
 
 conmgr_t mgr = CONMGR_DEFAULT;
 
@@ -225,6 +228,7 @@ extern void conmgr_init(int thread_count, int default_thread_count,
 	mgr.listen_conns = list_create(NULL);
 	mgr.complete_conns = list_create(NULL);
 	mgr.work = list_create(NULL);
+	mgr.work_ring = mpmc_ring_create(WORK_RING_SIZE);
 	init_delayed_work();
 
 	pollctl_init(mgr.max_connections);
@@ -299,6 +303,8 @@ extern void conmgr_fini(void)
 	/* work should have been cleared by workers_fini() */
 	xassert(list_is_empty(mgr.work));
 	FREE_NULL_LIST(mgr.work);
+	xassert(!mpmc_ring_count(mgr.work_ring));
+	FREE_NULL_MPMC_RING(mgr.work_ring);
 
 	pollctl_fini();
 
@@ -50,7 +50,9 @@
 
 #include "slurm/slurm.h"
 
+#include "src/common/atomic.h"
 #include "src/common/events.h"
+#include "src/common/mpmc_ring.h"
 #include "src/common/pack.h"
 #include "src/common/probes.h"
 
@@ -325,7 +327,15 @@ typedef struct {
 	int error;
 	/* list of work_t */
 	list_t *delayed_work;
-	/* list of work_t* */
+	/*
+	 * Ring of work_t* ready to run. Workers may pop from ring without
+	 * holding mgr.mutex. Producers must hold mgr.mutex.
+	 */
+	mpmc_ring_t *work_ring;
+	/*
+	 * list of work_t* ready to run that did not fit in work_ring. Always
+	 * newer than any work in work_ring.
+	 */
 	list_t *work;
 
 	pthread_mutex_t mutex;
@@ -349,6 +359,15 @@ typedef struct {
 
 		/* number of threads */
 		int threads;
+
+#ifndef __STDC_NO_ATOMICS__
+		/*
+		 * Non-zero while workers may keep popping mgr.work_ring after
+		 * running work without relocking mgr.mutex. Only set by watch()
+		 * while there is no pending shutdown or quiesce.
+		 */
+		atomic_uint64_t direct;
+#endif
 	} workers;
 
 	/* Global quiesce state */
@@ -461,6 +480,19 @@ extern void add_work(bool locked, conmgr_fd_t *con, conmgr_callback_t callback,
 extern void work_mask_depend(work_t *work, conmgr_work_depend_t depend_mask);
 extern void handle_work(bool locked, work_t *work);
 
+/*
+ * Pop next work ready to run
+ * NOTE: caller must hold mgr.mutex lock
+ * RET work or NULL if none queued
+ */
+extern work_t *work_queue_pop(void);
+
+/*
+ * Get number of work ready to run
+ * NOTE: caller must hold mgr.mutex lock
+ */
+extern int work_queue_count(void);
+
 /*
  * Poll all connections and handle any events
  */
@@ -612,6 +644,13 @@ extern void workers_init(int count, int default_count);
  */
 extern void workers_fini(void);
 
+/*
+ * Allow or disallow workers to run queued work back to back without relocking
+ * mgr.mutex
+ * Note: Caller must hold conmgr lock
+ */
+extern void workers_set_direct(bool direct);
+
 /*
  * Change con->type
  * NOTE: caller must hold mgr.mutex lock
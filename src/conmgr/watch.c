@@ -1629,6 +1629,12 @@ static void _quiesce_max_sleep(void)
 
 static bool _watch_loop(void)
 {
+	/*
+	 * Workers must relock mgr.mutex between work to see shutdown and
+	 * quiesce requests
+	 */
+	workers_set_direct(!mgr.shutdown_requested && !mgr.quiesce.requested);
+
 	if (mgr.shutdown_requested) {
 		signal_mgr_stop();
 		cancel_delayed_work(false);
@@ -1687,7 +1693,7 @@ static bool _watch_loop(void)
 			 * wake them all up independent of the size of the
 			 * mgr.work queue.
 			 */
-			if (!list_is_empty(mgr.work))
+			if (work_queue_count())
 				EVENT_BROADCAST(&mgr.worker_sleep);
 		}
 	}
@@ -1700,12 +1706,12 @@ static bool _watch_loop(void)
 	 * any queued work.
 	 */
 
-	if (mgr.workers.active || !list_is_empty(mgr.work) ||
+	if (mgr.workers.active || work_queue_count() ||
 	    !list_is_empty(mgr.delayed_work)) {
 		/* Need to wait for all work/workers to complete */
 		log_flag(CONMGR, "%s: waiting on workers:%d work:%d delayed_work:%d",
 			 __func__, mgr.workers.active,
-			 list_count(mgr.delayed_work), list_count(mgr.work));
+			 list_count(mgr.delayed_work), work_queue_count());
 		mgr.waiting_on_work = true;
 		return true;
 	}
@@ -1747,7 +1753,7 @@ extern void *watch(void *arg)
 
 		log_flag(CONMGR, "%s: waiting for new events: workers:%d/%d work:%d delayed_work:%d connections:%d listeners:%d complete:%d polling:%c inspecting:%c shutdown_requested:%c quiesce_requested:%c waiting_on_work:%c timeout:%s",
 				 __func__, mgr.workers.active,
-				 mgr.workers.total, list_count(mgr.work),
+				 mgr.workers.total, work_queue_count(),
 				 list_count(mgr.delayed_work),
 				 list_count(mgr.connections),
 				 list_count(mgr.listen_conns),
@@ -1765,6 +1771,8 @@ extern void *watch(void *arg)
 		_reset_watch_max_sleep();
 	}
 
+	workers_set_direct(false);
+
 	log_flag(CONMGR, "%s: returning shutdown_requested=%c connections=%u listen_conns=%u",
 		 __func__, BOOL_CHARIFY(mgr.shutdown_requested),
 		 list_count(mgr.connections), list_count(mgr.listen_conns));
@@ -36,6 +36,7 @@
 #include "src/common/events.h"
 #include "src/common/list.h"
 #include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
 #include "src/common/proc_args.h"
 #include "src/common/read_config.h"
 #include "src/common/xmalloc.h"
@@ -299,7 +300,7 @@ extern void wrap_work(work_t *work)
 }
 
 /*
- * Add work to mgr.work
+ * Add work to mgr.work_ring or mgr.work on overflow
  * Single point to enqueue internal function callbacks
  * NOTE: _handle_work_run() can add new entries to mgr.work
  *
@@ -313,15 +314,37 @@ static void _handle_work_run(work_t *work)
 	xassert(work->magic == MAGIC_WORK);
 
 	_log_work(work, __func__, "Enqueueing work. work:%u",
-		  list_count(mgr.work));
+		  work_queue_count());
 
-	/* add to work list and signal a thread if watch is active */
-	list_append(mgr.work, work);
+	/*
+	 * Add to work ring and signal a thread if watch is active. Once the
+	 * ring overflows, keep appending to the list until it is drained to
+	 * preserve FIFO ordering.
+	 */
+	if (!list_is_empty(mgr.work) || !mpmc_ring_push(mgr.work_ring, work))
+		list_append(mgr.work, work);
 
 	if (!mgr.quiesce.active)
 		EVENT_SIGNAL(&mgr.worker_sleep);
 }
 
+extern work_t *work_queue_pop(void)
+{
+	work_t *work = NULL;
+
+	/* work_ring is always older than any overflow in mgr.work */
+	if (!(work = mpmc_ring_pop(mgr.work_ring)))
+		work = list_pop(mgr.work);
+
+	xassert(!work || (work->magic == MAGIC_WORK));
+	return work;
+}
+
+extern int work_queue_count(void)
+{
+	return (mpmc_ring_count(mgr.work_ring) + list_count(mgr.work));
+}
+
 /*
  * Routes new pending work to the correct queue
  * WARNING: conmgr.mutex must be locked by calling thread
@@ -528,8 +551,9 @@ static void _probe_verbose(probe_log_t *log)
 		.log = log,
 	};
 
-	probe_log(log, "work queues: work:%d delayed_work:%d",
-		  list_count(mgr.work), list_count(mgr.delayed_work));
+	probe_log(log, "work queues: work:%d work_ring:%u/%u delayed_work:%d",
+		  list_count(mgr.work), mpmc_ring_count(mgr.work_ring),
+		  mpmc_ring_size(mgr.work_ring), list_count(mgr.delayed_work));
 
 	(void) list_for_each_ro(mgr.delayed_work, _foreach_log_work, &args);
 
@@ -550,7 +574,7 @@ extern probe_status_t probe_work(probe_log_t *log, void *arg)
 
 	if (!mgr.initialized)
 		status = PROBE_RC_UNKNOWN;
-	else if (!mgr.work || !mgr.delayed_work)
+	else if (!mgr.work || !mgr.work_ring || !mgr.delayed_work)
 		status = PROBE_RC_DOWN;
 	else
 		status = PROBE_RC_READY;
@@ -35,8 +35,10 @@
 
 #include "slurm/slurm_errno.h"
 
+#include "src/common/atomic.h"
 #include "src/common/events.h"
 #include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
 #include "src/common/probes.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_time.h"
@@ -245,6 +247,40 @@ extern void workers_fini(void)
 	mgr.workers.threads = 0;
 }
 
+/*
+ * Pop work from mgr.work_ring without mgr.mutex
+ * NOTE: caller must be counted in mgr.workers.active
+ * RET work or NULL if direct popping is not allowed or the ring is empty
+ */
+static work_t *_pop_direct(worker_t *worker)
+{
+#ifndef __STDC_NO_ATOMICS__
+	work_t *work;
+
+	if (!atomic_uint64_get(mgr.workers.direct))
+		return NULL;
+
+	if (!(work = mpmc_ring_pop(mgr.work_ring)))
+		return NULL;
+
+	xassert(work->magic == MAGIC_WORK);
+
+	log_flag(CONMGR, "%s: [%u] %s() running directly",
+		 __func__, worker->id, work->callback.func_name);
+
+	return work;
+#else /* __STDC_NO_ATOMICS__ */
+	return NULL;
+#endif /* __STDC_NO_ATOMICS__ */
+}
+
+extern void workers_set_direct(bool direct)
+{
+#ifndef __STDC_NO_ATOMICS__
+	(void) atomic_uint64_set(mgr.workers.direct, direct);
+#endif /* !__STDC_NO_ATOMICS__ */
+}
+
 static void *_worker(void *arg)
 {
 	worker_t *worker = arg;
@@ -266,7 +302,7 @@ static void *_worker(void *arg)
 		while (mgr.quiesce.active)
 			EVENT_WAIT(&mgr.quiesce.on_stop_quiesced, &mgr.mutex);
 
-		work = list_pop(mgr.work);
+		work = work_queue_pop();
 
 		/* wait for work if nothing to do */
 		if (!work) {
@@ -295,14 +331,18 @@ static void *_worker(void *arg)
 		log_flag(CONMGR, "%s: [%u] %s() running active_workers=%u/%u queue=%u",
 			 __func__, worker->id, work->callback.func_name,
 			 mgr.workers.active, mgr.workers.total,
-			 list_count(mgr.work));
+			 work_queue_count());
 
 		/* Unlock mutex before running work */
 		slurm_mutex_unlock(&mgr.mutex);
 
-		/* run work via wrap_work() which will xfree(work) */
-		wrap_work(work);
-		work = NULL;
+		/*
+		 * run work via wrap_work() which will xfree(work) and keep
+		 * running any work already in the ring while allowed
+		 */
+		do {
+			wrap_work(work);
+		} while ((work = _pop_direct(worker)));
 
 		/* Lock mutex after running work */
 		slurm_mutex_lock(&mgr.mutex);
@@ -311,7 +351,7 @@ static void *_worker(void *arg)
 
 		log_flag(CONMGR, "%s: [%u] finished active_workers=%u/%u queue=%u",
 			 __func__, worker->id, mgr.workers.active,
-			 mgr.workers.total, list_count(mgr.work));
+			 mgr.workers.total, work_queue_count());
 
 		/* wake up watch for all ending work on shutdown */
 		if (mgr.shutdown_requested || mgr.waiting_on_work)
@@ -345,7 +385,7 @@ extern void workers_shutdown(void)
 
 	do {
 		log_flag(CONMGR, "%s: waiting for work=%u workers=%u/%u",
-			 __func__, list_count(mgr.work), mgr.workers.active,
+			 __func__, work_queue_count(), mgr.workers.active,
 			 mgr.workers.total);
 
 		if (mgr.workers.total > 0) {
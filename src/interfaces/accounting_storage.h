@@ -52,9 +52,19 @@
 
 typedef enum {
 	ACCT_STORAGE_INFO_CONN_ACTIVE,
-	ACCT_STORAGE_INFO_AGENT_COUNT
+	ACCT_STORAGE_INFO_AGENT_COUNT,
+	ACCT_STORAGE_INFO_AGENT_STATS, /* acct_storage_agent_stats_t */
 } acct_storage_info_t;
 
+/* Messages the slurmctld agent has delivered to the SlurmDBD */
+typedef struct {
+	uint32_t batch_cnt; /* RPCs sent, each with one or more messages */
+	uint32_t batch_max; /* most messages sent in one RPC */
+	uint64_t msg_cnt; /* messages sent */
+	uint64_t usec; /* usec spent sending and waiting for the reply */
+	uint64_t usec_max; /* longest usec for one RPC */
+} acct_storage_agent_stats_t;
+
 extern uid_t db_api_uid;
 
 extern int acct_storage_g_init(void); /* load the plugin */
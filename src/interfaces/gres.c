@@ -61,6 +61,7 @@
 #include "slurm/slurm.h"
 #include "slurm/slurm_errno.h"
 #include "src/common/assoc_mgr.h"
+#include "src/common/atomic.h"
 #include "src/common/bitstring.h"
 #include "src/interfaces/cgroup.h"
 #include "src/interfaces/gres.h"
@@ -209,6 +210,7 @@ typedef struct {
 	int core_end_bit;
 	int core_start_bit;
 	uint32_t job_id;
+	gres_node_index_t *node_gres_index;
 	list_t *node_gres_list;
 	char *node_name;
 	bool use_total_gres;
@@ -383,12 +385,27 @@ static char *local_plugins_str = NULL;
 static pthread_mutex_t gres_context_lock = PTHREAD_MUTEX_INITIALIZER;
 static list_t *gres_conf_list = NULL;
 static uint32_t gpu_plugin_id = NO_VAL;
+static int gpu_ctx_inx = -1;
 static volatile uint32_t autodetect_flags = GRES_AUTODETECT_UNSET;
 static buf_t *gres_context_buf = NULL;
 static buf_t *gres_conf_buf = NULL;
 static bool reset_prev = true;
 static bool use_local_index = false;
 static bool dev_index_mode_set = false;
+/*
+ * Bumped whenever a gres_state_t is added to or freed from a node's own
+ * gres_list so that no gres_node_index_t misses an entry or keeps a freed
+ * pointer, even if a new list is later allocated at the same address. That
+ * only happens on reconfigure, state recovery or registration with changed
+ * GRES. Copies from gres_node_state_list_dup() do not bump it, see
+ * _gres_node_copy_list_delete().
+ */
+#ifndef __STDC_NO_ATOMICS__
+static atomic_uint64_t node_gres_gen = ATOMIC_UINT64_INITIALIZER(1);
+#else
+static pthread_mutex_t node_gres_gen_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t node_gres_gen = 1;
+#endif
 
 /* Local functions */
 static void _accumulate_job_gres_alloc(gres_job_state_t *gres_js,
@@ -469,6 +486,32 @@ extern uint32_t gres_build_id(char *name)
 	return id;
 }
 
+static void _node_gres_gen_bump(void)
+{
+#ifndef __STDC_NO_ATOMICS__
+	atomic_uint64_increment(node_gres_gen);
+#else
+	slurm_mutex_lock(&node_gres_gen_lock);
+	node_gres_gen++;
+	slurm_mutex_unlock(&node_gres_gen_lock);
+#endif
+}
+
+static uint64_t _node_gres_gen_get(void)
+{
+#ifndef __STDC_NO_ATOMICS__
+	return atomic_uint64_get(node_gres_gen);
+#else
+	uint64_t gen;
+
+	slurm_mutex_lock(&node_gres_gen_lock);
+	gen = node_gres_gen;
+	slurm_mutex_unlock(&node_gres_gen_lock);
+
+	return gen;
+#endif
+}
+
 extern int gres_find_id(void *x, void *key)
 {
 	uint32_t *plugin_id = (uint32_t *)key;
@@ -478,6 +521,86 @@ extern int gres_find_id(void *x, void *key)
 	return 0;
 }
 
+extern int gres_get_index(uint32_t plugin_id)
+{
+	for (int i = 0; i < gres_context_cnt; i++)
+		if (gres_context[i].plugin_id == plugin_id)
+			return i;
+
+	return -1;
+}
+
+/* Return ctx_inx if it is the dense GRES index of plugin_id, else search */
+static int _check_index(uint32_t plugin_id, int ctx_inx)
+{
+	if ((ctx_inx >= 0) && (ctx_inx < gres_context_cnt) &&
+	    (gres_context[ctx_inx].plugin_id == plugin_id))
+		return ctx_inx;
+
+	return gres_get_index(plugin_id);
+}
+
+extern int gres_get_gpu_index(void)
+{
+	return gpu_ctx_inx;
+}
+
+static int _build_node_index(void *x, void *arg)
+{
+	gres_state_t *gres_state_node = x;
+	gres_node_index_t *index = arg;
+	int inx = _check_index(gres_state_node->plugin_id,
+			       gres_state_node->ctx_inx);
+
+	/* keep first match like list_find_first() */
+	if ((inx >= 0) && !index->state[inx])
+		index->state[inx] = gres_state_node;
+
+	return SLURM_SUCCESS;
+}
+
+extern gres_state_t *gres_node_index_find(gres_node_index_t *index,
+					  list_t *node_gres_list,
+					  uint32_t plugin_id, int ctx_inx)
+{
+	uint64_t gen;
+	int inx;
+
+	if (!node_gres_list)
+		return NULL;
+
+	if (!index || ((inx = _check_index(plugin_id, ctx_inx)) < 0))
+		return list_find_first(node_gres_list, gres_find_id,
+				       &plugin_id);
+
+	gen = _node_gres_gen_get();
+	if ((index->gres_list != node_gres_list) || (index->gen != gen) ||
+	    (index->cnt != gres_context_cnt)) {
+		if (index->cnt != gres_context_cnt) {
+			index->cnt = gres_context_cnt;
+			xrecalloc(index->state, index->cnt,
+				  sizeof(*index->state));
+		}
+		memset(index->state, 0, (index->cnt * sizeof(*index->state)));
+		list_for_each_ro(node_gres_list, _build_node_index, index);
+		index->gres_list = node_gres_list;
+		index->gen = gen;
+	}
+
+	return index->state[inx];
+}
+
+extern void gres_node_index_free(gres_node_index_t *index)
+{
+	if (!index)
+		return;
+
+	xfree(index->state);
+	index->cnt = 0;
+	index->gres_list = NULL;
+	index->gen = 0;
+}
+
 extern int gres_find_gpu_or_alt(void *x, void *key)
 {
 	gres_state_t *state_ptr = (gres_state_t *) x;
@@ -599,6 +722,7 @@ extern gres_state_t *gres_create_state(void *src_ptr,
 		gres_state_t *gres_state = src_ptr;
 		new_gres_state->config_flags = gres_state->config_flags;
 		new_gres_state->plugin_id = gres_state->plugin_id;
+		new_gres_state->ctx_inx = gres_state->ctx_inx;
 		new_gres_state->gres_name = xstrdup(gres_state->gres_name);
 		break;
 	}
@@ -607,6 +731,7 @@ extern gres_state_t *gres_create_state(void *src_ptr,
 		slurm_gres_context_t *gres_ctx = src_ptr;
 		new_gres_state->config_flags = gres_ctx->config_flags;
 		new_gres_state->plugin_id = gres_ctx->plugin_id;
+		new_gres_state->ctx_inx = gres_get_index(gres_ctx->plugin_id);
 		new_gres_state->gres_name = xstrdup(gres_ctx->gres_name);
 		break;
 	}
@@ -615,6 +740,7 @@ extern gres_state_t *gres_create_state(void *src_ptr,
 		gres_key_t *search_key = src_ptr;
 		new_gres_state->config_flags = search_key->config_flags;
 		new_gres_state->plugin_id = search_key->plugin_id;
+		new_gres_state->ctx_inx = gres_get_index(search_key->plugin_id);
 		/*
 		 * gres_name should be handled after this since search_key
 		 * doesn't have that
@@ -771,6 +897,8 @@ static void _add_gres_context(char *gres_name)
 	gres_ctx->gres_type = xstrdup_printf("gres/%s", gres_name);
 	gres_ctx->plugin_list = NULL;
 	gres_ctx->cur_plugin = PLUGIN_INVALID_HANDLE;
+	if (gres_ctx->plugin_id == gpu_plugin_id)
+		gpu_ctx_inx = gres_context_cnt;
 
 	gres_context_cnt++;
 }
@@ -994,6 +1122,7 @@ extern int gres_fini(void)
 	FREE_NULL_BUFFER(gres_context_buf);
 	FREE_NULL_BUFFER(gres_conf_buf);
 	gres_context_cnt = -1;
+	gpu_ctx_inx = -1;
 
 fini:	slurm_mutex_unlock(&gres_context_lock);
 	return rc;
@@ -3273,6 +3402,22 @@ static void _gres_node_list_delete(void *list_element)
 	_gres_node_state_delete(gres_ns);
 	gres_state_node->gres_data = NULL;
 	_gres_state_delete_members(gres_state_node);
+	_node_gres_gen_bump();
+}
+
+/*
+ * Delete an element placed on a will-run copy by gres_node_state_list_dup().
+ * A copy is only viewed through the gres_node_index_t kept next to it in the
+ * same node_use_record_t, which is released along with it, so freeing the
+ * copy does not need to invalidate any other view.
+ */
+static void _gres_node_copy_list_delete(void *list_element)
+{
+	gres_state_t *gres_state_node = list_element;
+
+	_gres_node_state_delete(gres_state_node->gres_data);
+	gres_state_node->gres_data = NULL;
+	_gres_state_delete_members(gres_state_node);
 }
 
 extern void gres_add_type(char *type, gres_node_state_t *gres_ns,
@@ -3607,6 +3752,7 @@ extern void gres_init_node_config(char *orig_config, list_t **gres_list)
 				&gres_context[i], GRES_STATE_SRC_CONTEXT_PTR,
 				GRES_STATE_TYPE_NODE, _build_gres_node_state());
 			list_append(*gres_list, gres_state_node);
+			_node_gres_gen_bump();
 		}
 
 		_node_config_init(orig_config, &gres_context[i],
@@ -4541,6 +4687,7 @@ extern int gres_node_config_validate(node_record_t *node_ptr,
 				&gres_context[i], GRES_STATE_SRC_CONTEXT_PTR,
 				GRES_STATE_TYPE_NODE, _build_gres_node_state());
 			list_append(node_ptr->gres_list, gres_state_node);
+			_node_gres_gen_bump();
 		}
 		rc2 = _node_config_validate(node_ptr, gres_state_node, cpu_cnt,
 					    core_cnt, sock_cnt, cores_per_sock,
@@ -4639,10 +4786,12 @@ extern void gres_node_feature(char *node_name,
 			/* FIXME: no config_flags known at this moment */
 			/* gres_state_node->config_flags = ; */
 			gres_state_node->plugin_id = plugin_id;
+			gres_state_node->ctx_inx = gres_get_index(plugin_id);
 			gres_state_node->gres_data = _build_gres_node_state();
 			gres_state_node->gres_name = xstrdup(gres_name);
 			gres_state_node->state_type = GRES_STATE_TYPE_NODE;
 			list_append(*gres_list, gres_state_node);
+			_node_gres_gen_bump();
 		}
 		gres_ns = gres_state_node->gres_data;
 		if (gres_size >= gres_ns->gres_cnt_alloc) {
@@ -5391,6 +5540,7 @@ extern int gres_node_state_unpack(list_t **gres_list, buf_t *buffer,
 			gres_ctx, GRES_STATE_SRC_CONTEXT_PTR,
 			GRES_STATE_TYPE_NODE, gres_ns);
 		list_append(*gres_list, gres_state_node);
+		_node_gres_gen_bump();
 		gres_ctx->config_flags |= full_config_flags;
 	}
 	slurm_mutex_unlock(&gres_context_lock);
@@ -5548,7 +5698,7 @@ extern list_t *gres_node_state_list_dup(list_t *gres_list)
 
 	slurm_mutex_lock(&gres_context_lock);
 	if ((gres_context_cnt > 0)) {
-		new_list = list_create(_gres_node_list_delete);
+		new_list = list_create(_gres_node_copy_list_delete);
 		(void) list_for_each(gres_list,
 				     _foreach_node_state_dup,
 				     new_list);
@@ -8237,9 +8387,10 @@ static int _foreach_job_test(void *x, void *arg)
 	foreach_job_test_t *foreach_job_test = arg;
 	uint32_t tmp_cnt;
 	gres_state_t *gres_state_node =
-		list_find_first(foreach_job_test->node_gres_list,
-				gres_find_id,
-				&gres_state_job->plugin_id);
+		gres_node_index_find(foreach_job_test->node_gres_index,
+				     foreach_job_test->node_gres_list,
+				     gres_state_job->plugin_id,
+				     gres_state_job->ctx_inx);
 	if (!gres_state_node) {
 		/* node lack resources required by the job */
 		foreach_job_test->core_cnt = 0;
@@ -8270,6 +8421,7 @@ static int _foreach_job_test(void *x, void *arg)
  * Determine how many cores on the node can be used by this job
  * IN job_gres_list  - job's gres_list built by gres_job_state_validate()
  * IN node_gres_list - node's gres_list built by gres_node_config_validate()
+ * IN/OUT node_gres_index - flat view of node_gres_list or NULL
  * IN use_total_gres - if set then consider all gres resources as available,
  *		       and none are committed to running jobs
  * IN core_start_bit - index into core_bitmap for this node's first core
@@ -8281,6 +8433,7 @@ static int _foreach_job_test(void *x, void *arg)
  *      otherwise - Count of available cores
  */
 extern uint32_t gres_job_test(list_t *job_gres_list, list_t *node_gres_list,
+			      gres_node_index_t *node_gres_index,
 			      bool use_total_gres,
 			      int core_start_bit, int core_end_bit,
 			      uint32_t job_id, char *node_name)
@@ -8290,6 +8443,7 @@ extern uint32_t gres_job_test(list_t *job_gres_list, list_t *node_gres_list,
 		.core_end_bit = core_end_bit,
 		.core_start_bit = core_start_bit,
 		.job_id = job_id,
+		.node_gres_index = node_gres_index,
 		.node_gres_list = node_gres_list,
 		.node_name = node_name,
 		.use_total_gres = use_total_gres,
@@ -378,11 +378,30 @@ typedef enum {
 typedef struct gres_state {
 	uint32_t config_flags;	/* See GRES_CONF_* values above */
 	uint32_t plugin_id;
+	int ctx_inx;		/* dense GRES index of plugin_id, set on create,
+				 * see gres_get_index() */
 	void *gres_data;
 	char *gres_name;		/* GRES name (e.g. "gpu") */
 	gres_state_type_enum_t state_type;
 } gres_state_t;
 
+/*
+ * Flat view of a node's gres_list, indexed by the dense GRES index that
+ * gres_init() assigns to each configured GRES plugin (see gres_get_index()).
+ * The list remains the authoritative copy. The view is rebuilt on first use
+ * after it is pointed at a different list, or after an entry is added to or
+ * freed from any node's own gres_list, so it never holds a stale pointer.
+ * Creating or freeing will-run copies made by gres_node_state_list_dup()
+ * leaves other views intact.
+ * Not thread safe, each view must only be used by one thread at a time.
+ */
+typedef struct {
+	int cnt;		/* entries in state */
+	uint64_t gen;		/* node gres generation the view was built at */
+	list_t *gres_list;	/* node gres_list the view was built from */
+	gres_state_t **state;	/* indexed by dense GRES index */
+} gres_node_index_t;
+
 /* Used to set Prolog and Epilog env var. Currently designed for gres/mps. */
 typedef struct {
 	uint32_t plugin_id;	/* GRES ID number */
@@ -697,11 +716,39 @@ extern int gres_node_state_unpack(list_t **gres_list, buf_t *buffer,
 
 /*
  * Duplicate a node gres status (used for will-run logic)
+ * A gres_node_index_t built on the copy must be freed along with the copy.
  * IN gres_list - node gres state information
  * RET a copy of gres_list or NULL on failure
  */
 extern list_t *gres_node_state_list_dup(list_t *gres_list);
 
+/*
+ * Return the dense GRES index assigned by gres_init() to plugin_id or -1 if
+ * it is not a configured GRES.
+ */
+extern int gres_get_index(uint32_t plugin_id);
+
+/* Return the dense GRES index of gres/gpu or -1 if it is not configured */
+extern int gres_get_gpu_index(void);
+
+/*
+ * Find the gres_state_t for plugin_id in a node's gres_list. Same result as
+ * list_find_first(node_gres_list, gres_find_id, &plugin_id), but repeated
+ * lookups against the same list are an array access.
+ * IN/OUT index - flat view of node_gres_list, NULL to search the list
+ * IN node_gres_list - node's gres_list
+ * IN plugin_id - GRES to find
+ * IN ctx_inx - dense GRES index of plugin_id (e.g. gres_state_t ctx_inx),
+ *	a wrong value only costs a gres_get_index() search
+ * RET gres_state_t or NULL if node lacks the GRES
+ */
+extern gres_state_t *gres_node_index_find(gres_node_index_t *index,
+					  list_t *node_gres_list,
+					  uint32_t plugin_id, int ctx_inx);
+
+/* Release memory held by a gres_node_index_t (not the struct itself) */
+extern void gres_node_index_free(gres_node_index_t *index);
+
 /* Copy gres_job_state_t record for ALL nodes */
 extern void *gres_job_state_dup(gres_job_state_t *gres_js);
 
@@ -890,6 +937,7 @@ extern int gres_job_state_unpack(list_t **gres_list, buf_t *buffer,
  * Determine how many cores on the node can be used by this job
  * IN job_gres_list  - job's gres_list built by gres_job_state_validate()
  * IN node_gres_list - node's gres_list built by gres_node_config_validate()
+ * IN/OUT node_gres_index - flat view of node_gres_list or NULL
  * IN use_total_gres - if set then consider all gres resources as available,
  *		       and none are committed to running jobs
  * IN core_bitmap    - Identification of available cores (NULL if no restriction)
@@ -902,6 +950,7 @@ extern int gres_job_state_unpack(list_t **gres_list, buf_t *buffer,
  *      otherwise - Count of available cores
  */
 extern uint32_t gres_job_test(list_t *job_gres_list, list_t *node_gres_list,
+			      gres_node_index_t *node_gres_index,
 			      bool use_total_gres,
 			      int core_start_bit, int core_end_bit,
 			      uint32_t job_id, char *node_name);
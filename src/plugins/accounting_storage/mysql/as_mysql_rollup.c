@@ -42,6 +42,7 @@
 #include "as_mysql_archive.h"
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
+#include "src/common/xhash.h"
 
 enum {
 	TIME_ALLOC,
@@ -141,16 +142,6 @@ static int _find_loc_tres(void *x, void *key)
 	return 0;
 }
 
-static int _find_id_usage(void *x, void *key)
-{
-	local_id_usage_t *loc = (local_id_usage_t *)x;
-	uint32_t id = *(uint32_t *)key;
-
-	if (loc->id == id)
-		return 1;
-	return 0;
-}
-
 static int _find_id_alt_usage(void *x, void *key)
 {
 	local_id_usage_t *loc = x;
@@ -162,6 +153,47 @@ static int _find_id_alt_usage(void *x, void *key)
 	return 0;
 }
 
+/* Hash local_id_usage_t on id and id_alt (0 for assocs and wckeys) */
+static void _id_usage_key(void *item, const char **key, uint32_t *key_len)
+{
+	local_id_usage_t *usage = item;
+
+	*key = (const char *) &usage->id;
+	*key_len = (sizeof(usage->id) + sizeof(usage->id_alt));
+}
+
+/*
+ * Find local_id_usage_t in map or add a new one to both list and map.
+ * map only indexes the list, items are owned by the list.
+ */
+static local_id_usage_t *_get_id_usage(list_t *usage_list, xhash_t *map,
+				       int id, int id_alt, bool make_tres)
+{
+	local_id_usage_t *usage, key = {
+		.id = id,
+		.id_alt = id_alt,
+	};
+	const char *key_str;
+	uint32_t key_len;
+
+	/* id and id_alt must be adjacent to hash them together */
+	xassert(offsetof(local_id_usage_t, id_alt) == sizeof(key.id));
+
+	_id_usage_key(&key, &key_str, &key_len);
+	if ((usage = xhash_get(map, key_str, key_len)))
+		return usage;
+
+	usage = xmalloc(sizeof(*usage));
+	usage->id = id;
+	usage->id_alt = id_alt;
+	if (make_tres)
+		usage->loc_tres = list_create(_destroy_local_tres_usage);
+	list_append(usage_list, usage);
+	xhash_add(map, usage);
+
+	return usage;
+}
+
 static void _remove_job_tres_time_from_cluster(list_t *c_tres, list_t *j_tres,
 					       int seconds)
 {
@@ -1285,28 +1317,19 @@ static void _add_planned_time(local_cluster_usage_t *c_usage, time_t job_start,
 }
 
 static local_id_usage_t *_check_q_usage(list_t *qos_usage_list,
+					xhash_t *qos_usage_map,
 					local_id_usage_t *curr_q_usage,
 					local_id_usage_t *id_usage)
 {
 	xassert(qos_usage_list);
+	xassert(qos_usage_map);
 	xassert(id_usage);
 
 	if (curr_q_usage && _find_id_alt_usage(curr_q_usage, id_usage))
 		return curr_q_usage;
 
-	curr_q_usage = list_find_first(qos_usage_list,
-				       _find_id_alt_usage,
-				       id_usage);
-	if (!curr_q_usage) {
-		curr_q_usage = xmalloc(sizeof(*curr_q_usage));
-		curr_q_usage->id = id_usage->id;
-		curr_q_usage->id_alt = id_usage->id_alt;
-		list_append(qos_usage_list, curr_q_usage);
-		curr_q_usage->loc_tres = list_create(
-			_destroy_local_tres_usage);
-	}
-
-	return curr_q_usage;
+	return _get_id_usage(qos_usage_list, qos_usage_map, id_usage->id,
+			     id_usage->id_alt, true);
 }
 
 extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
@@ -1333,6 +1356,10 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	list_t *qos_usage_list = list_create(_destroy_local_id_usage);
 	list_t *wckey_usage_list = list_create(_destroy_local_id_usage);
 	list_t *resv_usage_list = list_create(_destroy_local_resv_usage);
+	/* Index the usage lists above, 100k+ assocs are searched per job */
+	xhash_t *assoc_usage_map = xhash_init(_id_usage_key, NULL);
+	xhash_t *qos_usage_map = xhash_init(_id_usage_key, NULL);
+	xhash_t *wckey_usage_map = xhash_init(_id_usage_key, NULL);
 	uint16_t track_wckey = slurm_get_track_wckey();
 	local_cluster_usage_t *loc_c_usage = NULL;
 	local_cluster_usage_t *c_usage = NULL;
@@ -1560,17 +1587,17 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			 * Do the qos calculation check the assoc_id now since
 			 * it will change in the next if
 			 */
-			q_usage = _check_q_usage(qos_usage_list, q_usage,
-						 &id_usage);
+			q_usage = _check_q_usage(qos_usage_list, qos_usage_map,
+						 q_usage, &id_usage);
 
 			if (last_id != assoc_id) {
-				a_usage = xmalloc(sizeof(local_id_usage_t));
-				a_usage->id = assoc_id;
-				list_append(assoc_usage_list, a_usage);
-				last_id = assoc_id;
 				/* a_usage->loc_tres is made later,
 				   don't do it here.
 				*/
+				a_usage = _get_id_usage(assoc_usage_list,
+							assoc_usage_map,
+							assoc_id, 0, false);
+				last_id = assoc_id;
 			}
 
 			/* Short circuit this so so we don't get a pointer. */
@@ -1579,20 +1606,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 			/* do the wckey calculation */
 			if (last_wckeyid != wckey_id) {
-				list_iterator_reset(w_itr);
-				while ((w_usage = list_next(w_itr)))
-					if (w_usage->id == wckey_id)
-						break;
-
-				if (!w_usage) {
-					w_usage = xmalloc(
-						sizeof(local_id_usage_t));
-					w_usage->id = wckey_id;
-					list_append(wckey_usage_list,
-						    w_usage);
-					w_usage->loc_tres = list_create(
-						_destroy_local_tres_usage);
-				}
+				w_usage = _get_id_usage(wckey_usage_list,
+							wckey_usage_map,
+							wckey_id, 0, true);
 				last_wckeyid = wckey_id;
 			}
 
@@ -1836,7 +1852,8 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 
 					if (id_usage.id_alt) {
 						q_usage = _check_q_usage(
-							qos_usage_list, q_usage,
+							qos_usage_list,
+							qos_usage_map, q_usage,
 							&id_usage);
 
 						_add_time_tres(
@@ -1847,19 +1864,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 							0);
 					}
 
-					if ((last_id != associd) &&
-					    !(a_usage = list_find_first(
-						      assoc_usage_list,
-						      _find_id_usage,
-						      &associd))) {
-						a_usage = xmalloc(
-							sizeof(local_id_usage_t));
-						a_usage->id = associd;
-						list_append(assoc_usage_list,
-							    a_usage);
-						a_usage->loc_tres = list_create(
-							_destroy_local_tres_usage);
-					}
+					if (last_id != associd)
+						a_usage = _get_id_usage(
+							assoc_usage_list,
+							assoc_usage_map,
+							associd, 0, true);
 					last_id = associd;
 
 					_add_time_tres(a_usage->loc_tres,
@@ -1966,6 +1975,9 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		q_usage     = NULL;
 		w_usage     = NULL;
 
+		xhash_clear(assoc_usage_map);
+		xhash_clear(qos_usage_map);
+		xhash_clear(wckey_usage_map);
 		list_flush(assoc_usage_list);
 		list_flush(cluster_down_list);
 		list_flush(qos_usage_list);
@@ -1991,6 +2003,9 @@ end_it:
 	if (r_itr)
 		list_iterator_destroy(r_itr);
 
+	xhash_free(assoc_usage_map);
+	xhash_free(qos_usage_map);
+	xhash_free(wckey_usage_map);
 	FREE_NULL_LIST(assoc_usage_list);
 	FREE_NULL_LIST(cluster_down_list);
 	FREE_NULL_LIST(qos_usage_list);
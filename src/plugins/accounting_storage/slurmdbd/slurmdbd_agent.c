@@ -37,6 +37,12 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <dirent.h>
+
+#if HAVE_LZ4
+# include <lz4.h>
+#endif
+
 #include "src/common/slurm_xlator.h"
 
 #include "src/common/fd.h"
@@ -60,8 +66,10 @@ persist_conn_t *slurmdbd_conn = NULL;
 
 
 #define DBD_MAGIC		0xDEAD3219
+#define DBD_SPOOL_MAGIC		0xDEAD3220
 #define DEBUG_PRINT_MAX_MSG_TYPES 10
 #define MAX_DBD_DEFAULT_ACTION MAX_DBD_ACTION_DISCARD
+#define DEFAULT_DBD_BATCH_SIZE 1000
 
 static pthread_mutex_t agent_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
@@ -77,6 +85,25 @@ static pthread_mutex_t slurmdbd_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  slurmdbd_cond = PTHREAD_COND_INITIALIZER;
 
 static int max_dbd_msg_action = MAX_DBD_DEFAULT_ACTION;
+static int dbd_batch_size = DEFAULT_DBD_BATCH_SIZE;
+static int dbd_batch_delay = 0; /* msec */
+static acct_storage_agent_stats_t agent_stats; /* protected by agent_lock */
+static int dbd_spool_segment = 0; /* msgs per spool segment, 0 disables */
+static uint16_t dbd_spool_compress = COMPRESS_OFF;
+
+/*
+ * Once dbd_spool_segment msgs are queued in agent_list, newer msgs are
+ * appended to numbered segment files instead. The agent loads the oldest
+ * segment back into agent_list whenever it is empty. All protected by
+ * agent_lock.
+ */
+static int spool_fd = -1; /* segment being written */
+static uint32_t spool_head = 0; /* oldest segment on disk */
+static uint32_t spool_tail = 0; /* segment being (or next to be) written */
+static uint32_t spool_tail_cnt = 0; /* msgs in segment being written */
+static uint32_t spool_cnt = 0; /* msgs on disk not loaded into agent_list */
+static bool spool_head_loaded = false; /* head segment is in agent_list */
+static uint32_t spool_purged = 0; /* segments before this have no step msgs */
 
 typedef struct {
 	list_t *id_rc_list;
@@ -384,6 +411,504 @@ static buf_t *_load_dbd_rec(int fd)
 	return buffer;
 }
 
+static buf_t *_upgrade_dbd_rec(buf_t *buffer, uint16_t rpc_version)
+{
+	persist_msg_t msg = {0};
+	int rc;
+
+	if (rpc_version == SLURM_PROTOCOL_VERSION)
+		return buffer;
+
+	/*
+	 * unpack and repack with new PROTOCOL_VERSION just so we keep
+	 * things up to date.
+	 */
+	set_buf_offset(buffer, 0);
+	rc = unpack_slurmdbd_msg(&msg, rpc_version, buffer);
+	FREE_NULL_BUFFER(buffer);
+	if (rc != SLURM_SUCCESS)
+		return NULL;
+
+	return pack_slurmdbd_msg(&msg, SLURM_PROTOCOL_VERSION);
+}
+
+static char *_spool_fname(uint32_t seq)
+{
+	char *fname = NULL;
+
+	xstrfmtcat(fname, "%s/dbd.spool.%u",
+		   slurm_conf.state_save_location, seq);
+	return fname;
+}
+
+/*
+ * Write msg to spool segment as stored size, original size (0 when not
+ * compressed), data and magic.
+ */
+static int _spool_write_rec(int fd, buf_t *buffer)
+{
+	uint32_t msg_size = get_buf_offset(buffer);
+	uint32_t stored_size = msg_size, orig_size = 0;
+	uint32_t magic = DBD_SPOOL_MAGIC;
+	char *data = get_buf_data(buffer), *comp = NULL;
+
+#if HAVE_LZ4
+	if (dbd_spool_compress == COMPRESS_LZ4) {
+		int bound = LZ4_compressBound(msg_size);
+		int comp_size;
+
+		comp = xmalloc(bound);
+		comp_size = LZ4_compress_default(data, comp, msg_size, bound);
+		/* only keep compressed data when it is smaller */
+		if ((comp_size > 0) && (comp_size < msg_size)) {
+			data = comp;
+			stored_size = comp_size;
+			orig_size = msg_size;
+		}
+	}
+#endif
+
+	safe_write(fd, &stored_size, sizeof(stored_size));
+	safe_write(fd, &orig_size, sizeof(orig_size));
+	safe_write(fd, data, stored_size);
+	safe_write(fd, &magic, sizeof(magic));
+	xfree(comp);
+	return SLURM_SUCCESS;
+
+rwfail:
+	error("spool save error: %m");
+	xfree(comp);
+	return SLURM_ERROR;
+}
+
+/*
+ * Read next msg written by _spool_write_rec()
+ * IN fd - segment to read from
+ * OUT buffer_ptr - msg with offset set to its end or NULL to skip the msg
+ * RET SLURM_SUCCESS or SLURM_ERROR at end of segment or on error
+ */
+static int _spool_read_rec(int fd, buf_t **buffer_ptr)
+{
+	uint32_t stored_size, orig_size, magic;
+	char *data = NULL;
+	buf_t *buffer = NULL;
+	ssize_t rd_size;
+
+	/* Reaching EOF between msgs is the normal end of the segment */
+	do {
+		rd_size = read(fd, &stored_size, sizeof(stored_size));
+	} while ((rd_size < 0) && (errno == EINTR));
+	if (!rd_size)
+		return SLURM_ERROR;
+	if (rd_size != sizeof(stored_size))
+		goto rwfail;
+	safe_read(fd, &orig_size, sizeof(orig_size));
+	if ((stored_size > MAX_BUF_SIZE) || (orig_size > MAX_BUF_SIZE))
+		goto rwfail;
+
+	if (!buffer_ptr) {
+		if (lseek(fd, stored_size, SEEK_CUR) < 0)
+			goto rwfail;
+	} else {
+		data = xmalloc(stored_size);
+		safe_read(fd, data, stored_size);
+	}
+
+	safe_read(fd, &magic, sizeof(magic));
+	if (magic != DBD_SPOOL_MAGIC)
+		goto rwfail;
+
+	if (!buffer_ptr)
+		return SLURM_SUCCESS;
+
+	if (!orig_size) {
+		buffer = create_buf(data, stored_size);
+		data = NULL;
+		set_buf_offset(buffer, stored_size);
+	} else {
+#if HAVE_LZ4
+		buffer = init_buf(orig_size);
+		if (LZ4_decompress_safe(data, get_buf_data(buffer),
+					stored_size, orig_size) != orig_size)
+			goto rwfail;
+		set_buf_offset(buffer, orig_size);
+		xfree(data);
+#else
+		error("spool msg is lz4 compressed but lz4 support is not available");
+		goto rwfail;
+#endif
+	}
+
+	*buffer_ptr = buffer;
+	return SLURM_SUCCESS;
+
+rwfail:
+	error("spool recover error, ignoring rest of segment");
+	FREE_NULL_BUFFER(buffer);
+	xfree(data);
+	return SLURM_ERROR;
+}
+
+/*
+ * Read all msgs of a spool segment
+ * IN seq - segment number
+ * IN list - list to append msgs to or NULL to only count them
+ * RET number of msgs or -1 if the segment could not be opened
+ */
+static int _spool_read_segment(uint32_t seq, list_t *list)
+{
+	char *fname = _spool_fname(seq), *ver_str = NULL;
+	buf_t *buffer = NULL;
+	uint16_t rpc_version = 0;
+	int fd, cnt = 0;
+
+	if ((fd = open(fname, O_RDONLY | O_CLOEXEC)) < 0) {
+		if (errno != ENOENT)
+			error("Opening spool file %s: %m", fname);
+		xfree(fname);
+		return -1;
+	}
+	xfree(fname);
+
+	if (_spool_read_rec(fd, (list ? &buffer : NULL)))
+		goto end_it;
+	if (list) {
+		set_buf_offset(buffer, 0);
+		safe_unpackstr(&ver_str, buffer);
+		FREE_NULL_BUFFER(buffer);
+		if (ver_str)
+			rpc_version = slurm_atoul(ver_str + 3);
+		xfree(ver_str);
+	}
+
+	while (!_spool_read_rec(fd, (list ? &buffer : NULL))) {
+		if (list) {
+			if (!(buffer = _upgrade_dbd_rec(buffer, rpc_version)))
+				continue;
+			list_enqueue(list, buffer);
+			buffer = NULL;
+		}
+		cnt++;
+	}
+
+end_it:
+	(void) close(fd);
+	return cnt;
+
+unpack_error:
+	error("spool recover error, segment %u has no version", seq);
+	FREE_NULL_BUFFER(buffer);
+	(void) close(fd);
+	return cnt;
+}
+
+/* Write the version record every segment starts with */
+static int _spool_write_ver(int fd)
+{
+	char ver_str[10];
+	buf_t *ver_buf;
+	int rc;
+
+	snprintf(ver_str, sizeof(ver_str), "VER%d", SLURM_PROTOCOL_VERSION);
+	ver_buf = init_buf(strlen(ver_str));
+	packstr(ver_str, ver_buf);
+	rc = _spool_write_rec(fd, ver_buf);
+	FREE_NULL_BUFFER(ver_buf);
+
+	return rc;
+}
+
+static int _spool_write_list_rec(void *x, void *arg)
+{
+	return _spool_write_rec(*(int *) arg, x);
+}
+
+/* Close segment being written so it can be loaded */
+static void _spool_close_tail(void)
+{
+	if (spool_fd < 0)
+		return;
+
+	if (fsync_and_close(spool_fd, "dbd.spool"))
+		error("error from fsync_and_close");
+	spool_fd = -1;
+	spool_tail++;
+	spool_tail_cnt = 0;
+}
+
+/* Append msg to the spool instead of agent_list */
+static int _spool_write(buf_t *buffer)
+{
+	if (spool_fd < 0) {
+		char *fname = _spool_fname(spool_tail);
+
+		/*
+		 * Never overwrite a segment, one left on disk before
+		 * _spool_recover() ran is picked up on the next recovery.
+		 */
+		while ((spool_fd = open(fname, (O_WRONLY | O_CREAT | O_EXCL |
+						O_CLOEXEC), 0600)) < 0) {
+			if (errno != EEXIST) {
+				error("Creating spool file %s: %m", fname);
+				xfree(fname);
+				return SLURM_ERROR;
+			}
+			log_flag(DBD_AGENT, "skipping existing spool segment %u",
+				 spool_tail);
+			xfree(fname);
+			if (spool_head == spool_tail)
+				spool_head++;
+			fname = _spool_fname(++spool_tail);
+		}
+		xfree(fname);
+
+		if (_spool_write_ver(spool_fd) != SLURM_SUCCESS) {
+			_spool_close_tail();
+			return SLURM_ERROR;
+		}
+	}
+
+	if (_spool_write_rec(spool_fd, buffer) != SLURM_SUCCESS) {
+		/* never append after a partially written msg */
+		_spool_close_tail();
+		return SLURM_ERROR;
+	}
+
+	spool_cnt++;
+	if (++spool_tail_cnt >= dbd_spool_segment)
+		_spool_close_tail();
+
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Load oldest spool segment into the empty agent_list. A segment is only
+ * removed once all of its msgs were sent, so after a crash they are sent again
+ * instead of being lost.
+ */
+static void _spool_load(void)
+{
+	int cnt;
+
+	if (spool_head_loaded) {
+		char *fname = _spool_fname(spool_head);
+
+		(void) unlink(fname);
+		xfree(fname);
+		spool_head_loaded = false;
+		spool_head++;
+	}
+
+	if (!spool_cnt)
+		return;
+
+	if (spool_head == spool_tail)
+		_spool_close_tail();
+
+	while (!spool_head_loaded && (spool_head != spool_tail)) {
+		if ((cnt = _spool_read_segment(spool_head, agent_list)) < 0) {
+			spool_head++;
+			continue;
+		}
+
+		log_flag(DBD_AGENT, "loaded %d msgs from spool segment %u",
+			 cnt, spool_head);
+		spool_cnt -= MIN(cnt, spool_cnt);
+		spool_head_loaded = true;
+	}
+
+	if (spool_head == spool_tail)
+		spool_cnt = 0;
+}
+
+/*
+ * Purge queued records from the agent queue
+ */
+static int _purge_agent_list_req(void *x, void *arg)
+{
+	uint16_t msg_type;
+	uint32_t offset;
+	buf_t *buffer = x;
+	uint16_t purge_type = *(uint16_t *)arg;
+
+	offset = get_buf_offset(buffer);
+	if (offset < 2)
+		return 0;
+	set_buf_offset(buffer, 0);
+	(void) unpack16(&msg_type, buffer);	/* checked by offset */
+	set_buf_offset(buffer, offset);
+	switch (purge_type) {
+	case DBD_STEP_START:
+		if ((msg_type == DBD_STEP_START) ||
+		    (msg_type == DBD_STEP_COMPLETE))
+			return 1;
+		break;
+	case DBD_JOB_START:
+		if (msg_type == DBD_JOB_START)
+			return 1;
+		break;
+	default:
+		error("unknown purge type %d", purge_type);
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * Remove msgs matching purge_type from a spool segment by writing the
+ * remaining msgs to a new file that replaces it.
+ * RET number of msgs removed
+ */
+static int _spool_purge_segment(uint32_t seq, uint16_t purge_type)
+{
+	char *fname = _spool_fname(seq), *new_fname = NULL;
+	list_t *list = list_create(slurmdbd_free_buffer);
+	int fd, purged = 0, rc = SLURM_SUCCESS;
+
+	if ((_spool_read_segment(seq, list) <= 0) ||
+	    !(purged = list_delete_all(list, _purge_agent_list_req,
+				       &purge_type)))
+		goto end_it;
+
+	xstrfmtcat(new_fname, "%s.new", fname);
+	if ((fd = open(new_fname, (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC),
+		       0600)) < 0) {
+		error("Creating spool file %s: %m", new_fname);
+		purged = 0;
+		goto end_it;
+	}
+	if ((_spool_write_ver(fd) != SLURM_SUCCESS) ||
+	    (list_for_each_ro(list, _spool_write_list_rec, &fd) < 0))
+		rc = SLURM_ERROR;
+	if (fsync_and_close(fd, "dbd.spool"))
+		rc = SLURM_ERROR;
+	if (!rc && (rename(new_fname, fname) < 0)) {
+		error("Renaming spool file %s: %m", new_fname);
+		rc = SLURM_ERROR;
+	}
+	if (rc) {
+		/* keep the segment as it was */
+		(void) unlink(new_fname);
+		purged = 0;
+	}
+
+end_it:
+	FREE_NULL_LIST(list);
+	xfree(new_fname);
+	xfree(fname);
+	return purged;
+}
+
+/*
+ * Purge msgs from spool segments the way _max_dbd_msg_action() purges
+ * agent_list. The segment being written is only purged once it is closed
+ * (at most dbd_spool_segment msgs), and a segment is purged once since no msgs
+ * are added to it after that. The head segment is already part of agent_list.
+ * RET number of msgs removed
+ */
+static int _spool_purge(uint16_t purge_type)
+{
+	uint32_t seq = spool_head + (spool_head_loaded ? 1 : 0);
+	uint32_t end = spool_tail;
+	int cnt, purged = 0;
+
+	if (!spool_cnt)
+		return 0;
+
+	if ((spool_fd >= 0) && (end > seq))
+		end--;
+	if ((spool_purged > seq) && (spool_purged <= end))
+		seq = spool_purged;
+
+	for (; seq < end; seq++) {
+		cnt = _spool_purge_segment(seq, purge_type);
+		log_flag(DBD_AGENT, "purged %d msgs from spool segment %u",
+			 cnt, seq);
+		purged += cnt;
+	}
+	spool_purged = end;
+	spool_cnt -= MIN(purged, spool_cnt);
+
+	return purged;
+}
+
+/* Find spool segments left behind by a previous slurmctld */
+static void _spool_recover(void)
+{
+	DIR *dir;
+	struct dirent *ent;
+	bool found = false;
+	uint32_t min = 0, max = 0;
+
+	if (spool_cnt || spool_head_loaded || (spool_fd >= 0))
+		return;
+
+	if (!(dir = opendir(slurm_conf.state_save_location))) {
+		error("Opening %s: %m", slurm_conf.state_save_location);
+		return;
+	}
+	while ((ent = readdir(dir))) {
+		unsigned long seq;
+		char *end = NULL;
+
+		if (xstrncmp(ent->d_name, "dbd.spool.", 10))
+			continue;
+		seq = strtoul(ent->d_name + 10, &end, 10);
+		if ((end == (ent->d_name + 10)) || *end)
+			continue;
+		if (!found || (seq < min))
+			min = seq;
+		if (!found || (seq > max))
+			max = seq;
+		found = true;
+	}
+	closedir(dir);
+
+	if (!found)
+		return;
+
+	for (uint32_t seq = min; seq <= max; seq++) {
+		int cnt = _spool_read_segment(seq, NULL);
+
+		if (cnt > 0) {
+			spool_cnt += cnt;
+		} else if (!cnt) {
+			char *fname = _spool_fname(seq);
+
+			(void) unlink(fname);
+			xfree(fname);
+		}
+	}
+
+	/* new msgs go after the recovered segments */
+	spool_head = min;
+	spool_tail = max + 1;
+	spool_tail_cnt = 0;
+	spool_purged = min;
+	verbose("recovered %u pending RPCs from spool segments %u-%u",
+		spool_cnt, min, max);
+}
+
+/*
+ * Prepare the spool for agent_list to be saved in dbd.messages. The head
+ * segment is already part of agent_list, the rest stays on disk and is
+ * recovered by _spool_recover() after a restart. Segment numbers keep
+ * increasing so that msgs spooled later never reuse a segment still on disk.
+ */
+static void _spool_save(void)
+{
+	if (spool_head_loaded) {
+		char *fname = _spool_fname(spool_head);
+
+		(void) unlink(fname);
+		xfree(fname);
+		spool_head_loaded = false;
+		spool_head++;
+	}
+	_spool_close_tail();
+}
+
 static void _load_dbd_state(void)
 {
 	char *dbd_fname = NULL;
@@ -430,23 +955,7 @@ static void _load_dbd_state(void)
 				buffer = _load_dbd_rec(fd);
 			if (buffer == NULL)
 				break;
-			if (rpc_version != SLURM_PROTOCOL_VERSION) {
-				/* unpack and repack with new
-				 * PROTOCOL_VERSION just so we keep
-				 * things up to date.
-				 */
-				persist_msg_t msg = {0};
-				int rc;
-				set_buf_offset(buffer, 0);
-				rc = unpack_slurmdbd_msg(
-					&msg, rpc_version, buffer);
-				FREE_NULL_BUFFER(buffer);
-				if (rc == SLURM_SUCCESS)
-					buffer = pack_slurmdbd_msg(
-						&msg, SLURM_PROTOCOL_VERSION);
-				else
-					buffer = NULL;
-			}
+			buffer = _upgrade_dbd_rec(buffer, rpc_version);
 			if (!buffer) {
 				error("no buffer given");
 				continue;
@@ -461,6 +970,8 @@ static void _load_dbd_state(void)
 		(void) close(fd);
 	}
 	xfree(dbd_fname);
+
+	_spool_recover();
 }
 
 static int _save_dbd_rec(int fd, buf_t *buffer)
@@ -509,6 +1020,8 @@ static void _save_dbd_state(void)
 	uint16_t msg_type;
 	uint32_t offset;
 
+	_spool_save();
+
 	xstrfmtcat(dbd_fname, "%s/dbd.messages", slurm_conf.state_save_location);
 	(void) unlink(dbd_fname);	/* clear save state */
 	fd = open(dbd_fname, O_WRONLY | O_CREAT | O_TRUNC, 0600);
@@ -563,40 +1076,6 @@ end_it:
 	xfree(dbd_fname);
 }
 
-/*
- * Purge queued records from the agent queue
- */
-static int _purge_agent_list_req(void *x, void *arg)
-{
-	uint16_t msg_type;
-	uint32_t offset;
-	buf_t *buffer = x;
-	uint16_t purge_type = *(uint16_t *)arg;
-
-	offset = get_buf_offset(buffer);
-	if (offset < 2)
-		return 0;
-	set_buf_offset(buffer, 0);
-	(void) unpack16(&msg_type, buffer);	/* checked by offset */
-	set_buf_offset(buffer, offset);
-	switch (purge_type) {
-	case DBD_STEP_START:
-		if ((msg_type == DBD_STEP_START) ||
-		    (msg_type == DBD_STEP_COMPLETE))
-			return 1;
-		break;
-	case DBD_JOB_START:
-		if (msg_type == DBD_JOB_START)
-			return 1;
-		break;
-	default:
-		error("unknown purge type %d", purge_type);
-		break;
-	}
-
-	return 0;
-}
-
 static void _max_dbd_msg_action(uint32_t *msg_cnt)
 {
 	int purged = 0;
@@ -614,6 +1093,7 @@ static void _max_dbd_msg_action(uint32_t *msg_cnt)
 		uint16_t purge_type = DBD_STEP_START;
 		purged = list_delete_all(agent_list, _purge_agent_list_req,
 					 &purge_type);
+		purged += _spool_purge(purge_type);
 		*msg_cnt -= purged;
 		info("purge %d step records", purged);
 	}
@@ -678,6 +1158,53 @@ static int _get_my_list(void *x, void *arg)
 	return 0;
 }
 
+/* Account for messages delivered in one RPC. Caller must hold agent_lock */
+static void _add_agent_stats(uint32_t msg_cnt, uint64_t usec)
+{
+	agent_stats.batch_cnt++;
+	agent_stats.batch_max = MAX(agent_stats.batch_max, msg_cnt);
+	agent_stats.msg_cnt += msg_cnt;
+	agent_stats.usec += usec;
+	agent_stats.usec_max = MAX(agent_stats.usec_max, usec);
+}
+
+/*
+ * Give slurmctld up to dbd_batch_delay msec to queue dbd_batch_size messages
+ * before sending them so the SlurmDBD can commit more records at once.
+ */
+static void _wait_for_batch(void)
+{
+	struct timespec deadline, now;
+	int cnt;
+
+	if (!dbd_batch_delay)
+		return;
+
+	slurm_mutex_lock(&agent_lock);
+	cnt = list_count(agent_list);
+	if ((cnt <= 0) || (cnt >= dbd_batch_size) || spool_cnt ||
+	    !slurmdbd_conn->conn) {
+		slurm_mutex_unlock(&agent_lock);
+		return;
+	}
+
+	/* agent_cond uses the default CLOCK_REALTIME */
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline = timespec_add(deadline,
+				TIMESPEC_FROM_USEC(dbd_batch_delay * 1000));
+	while (!*slurmdbd_conn->shutdown &&
+	       (list_count(agent_list) < dbd_batch_size)) {
+		clock_gettime(CLOCK_REALTIME, &now);
+		if (!timespec_is_after(deadline, now))
+			break;
+		slurm_cond_timedwait(&agent_cond, &agent_lock, &deadline);
+	}
+
+	log_flag(DBD_AGENT, "waited for batch of %d messages, agent_count=%d",
+		 dbd_batch_size, list_count(agent_list));
+	slurm_mutex_unlock(&agent_lock);
+}
+
 static void *_agent(void *x)
 {
 	int rc;
@@ -687,6 +1214,8 @@ static void *_agent(void *x)
 	static time_t fail_time = 0;
 	persist_msg_t list_req = {0};
 	dbd_list_msg_t list_msg;
+	timespec_t send_start = { 0 }, send_end = { 0 };
+	uint32_t send_cnt = 0;
 	DEF_TIMERS;
 
 	slurm_mutex_lock(&agent_lock);
@@ -703,6 +1232,8 @@ static void *_agent(void *x)
 		 slurmdbd_msg_type_2_str(list_req.msg_type, 1));
 
 	while (*slurmdbd_conn->shutdown == 0) {
+		_wait_for_batch();
+
 		slurm_mutex_lock(&slurmdbd_lock);
 		if (halt_agent) {
 			log_flag(DBD_AGENT, "slurmdbd agent halt with agent_count=%d",
@@ -725,6 +1256,8 @@ static void *_agent(void *x)
 		}
 
 		slurm_mutex_lock(&agent_lock);
+		if (agent_list && !list_count(agent_list))
+			_spool_load();
 		cnt = list_count(agent_list);
 		if ((cnt == 0) || !slurmdbd_conn->conn ||
 		    (fail_time && (difftime(time(NULL), fail_time) < 10))) {
@@ -749,7 +1282,7 @@ static void *_agent(void *x)
 		/* Leave item on the queue until processing complete */
 		if (agent_list) {
 			if (cnt > 1) {
-				int max_rpcs = 1000;
+				int max_rpcs = dbd_batch_size;
 				foreach_get_my_list_t args = {
 					.msg_size = sizeof(list_req),
 					.my_list = list_create(NULL),
@@ -761,8 +1294,11 @@ static void *_agent(void *x)
 						  _get_my_list, &args, 1, true);
 				buffer = pack_slurmdbd_msg(
 					&list_req, SLURM_PROTOCOL_VERSION);
-			} else
+				send_cnt = list_count(list_msg.my_list);
+			} else {
 				buffer = list_peek(agent_list);
+				send_cnt = 1;
+			}
 		} else
 			buffer = NULL;
 		slurm_mutex_unlock(&agent_lock);
@@ -782,6 +1318,7 @@ static void *_agent(void *x)
 		/* NOTE: agent_lock is clear here, so we can add more
 		 * requests to the queue while waiting for this RPC to
 		 * complete. */
+		send_start = timespec_now();
 		rc = slurm_persist_send_msg(slurmdbd_conn, buffer);
 		if (rc != SLURM_SUCCESS) {
 			if (*slurmdbd_conn->shutdown) {
@@ -809,6 +1346,7 @@ static void *_agent(void *x)
 				      "message need to resend: %d: %m", rc);
 			}
 		}
+		send_end = timespec_now();
 		slurm_mutex_unlock(&slurmdbd_lock);
 		slurm_mutex_lock(&assoc_cache_mutex);
 		if (slurmdbd_conn->conn &&
@@ -832,6 +1370,10 @@ static void *_agent(void *x)
 
 			FREE_NULL_BUFFER(buffer);
 			fail_time = 0;
+
+			_add_agent_stats(send_cnt,
+					 timer_get_duration(&send_start,
+							    &send_end));
 		} else {
 			/* We need to free a mult_msg even on failure */
 			if (list_msg.my_list) {
@@ -1006,7 +1548,7 @@ extern int slurmdbd_agent_send(uint16_t rpc_version, persist_msg_t *req)
 			return SLURM_ERROR;
 		}
 	}
-	cnt = list_count(agent_list);
+	cnt = list_count(agent_list) + spool_cnt;
 	if ((cnt >= (slurm_conf.max_dbd_msgs / 2)) &&
 	    (difftime(time(NULL), syslog_time) > 120)) {
 		/* Record critical error every 120 seconds */
@@ -1021,7 +1563,23 @@ extern int slurmdbd_agent_send(uint16_t rpc_version, persist_msg_t *req)
 	_max_dbd_msg_action(&cnt);
 
 	if (cnt < slurm_conf.max_dbd_msgs) {
-		list_enqueue(agent_list, buffer);
+		/* keep msgs in order once any are spooled */
+		if (!spool_cnt && (!dbd_spool_segment ||
+				   (list_count(agent_list) <
+				    dbd_spool_segment))) {
+			list_enqueue(agent_list, buffer);
+		} else if (_spool_write(buffer) == SLURM_SUCCESS) {
+			FREE_NULL_BUFFER(buffer);
+		} else if (!spool_cnt) {
+			/* nothing older is spooled, keep it in agent_list */
+			list_enqueue(agent_list, buffer);
+		} else {
+			error("unable to spool %s:%u request behind %u spooled msgs, discarding it",
+			      slurmdbd_msg_type_2_str(req->msg_type, 1),
+			      req->msg_type, spool_cnt);
+			FREE_NULL_BUFFER(buffer);
+			rc = SLURM_ERROR;
+		}
 	} else {
 		error("agent queue is full (%u), discarding %s:%u request",
 		      cnt,
@@ -1048,7 +1606,20 @@ extern bool slurmdbd_conn_active(void)
 
 extern int slurmdbd_agent_queue_count(void)
 {
-	return list_count(agent_list);
+	int cnt;
+
+	slurm_mutex_lock(&agent_lock);
+	cnt = list_count(agent_list) + spool_cnt;
+	slurm_mutex_unlock(&agent_lock);
+
+	return cnt;
+}
+
+extern void slurmdbd_agent_get_stats(acct_storage_agent_stats_t *stats)
+{
+	slurm_mutex_lock(&agent_lock);
+	*stats = agent_stats;
+	slurm_mutex_unlock(&agent_lock);
 }
 
 extern void slurmdbd_agent_config_setup(void)
@@ -1081,4 +1652,61 @@ extern void slurmdbd_agent_config_setup(void)
 		xfree(type);
 	} else
 		max_dbd_msg_action = MAX_DBD_DEFAULT_ACTION;
+
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "dbd_batch_size="))) {
+		dbd_batch_size = strtol(tmp_ptr + strlen("dbd_batch_size="),
+					NULL, 10);
+		if (dbd_batch_size < 1) {
+			error("Invalid SlurmctldParameters dbd_batch_size, using %d",
+			      DEFAULT_DBD_BATCH_SIZE);
+			dbd_batch_size = DEFAULT_DBD_BATCH_SIZE;
+		}
+	} else
+		dbd_batch_size = DEFAULT_DBD_BATCH_SIZE;
+
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "dbd_batch_delay="))) {
+		dbd_batch_delay = strtol(tmp_ptr + strlen("dbd_batch_delay="),
+					 NULL, 10);
+		if ((dbd_batch_delay < 0) || (dbd_batch_delay > MSEC_IN_SEC)) {
+			error("Invalid SlurmctldParameters dbd_batch_delay, disabling");
+			dbd_batch_delay = 0;
+		}
+	} else
+		dbd_batch_delay = 0;
+
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "dbd_spool_segment="))) {
+		dbd_spool_segment = strtol(tmp_ptr +
+					   strlen("dbd_spool_segment="),
+					   NULL, 10);
+		if (dbd_spool_segment < 0) {
+			error("Invalid SlurmctldParameters dbd_spool_segment, disabling");
+			dbd_spool_segment = 0;
+		}
+	} else
+		dbd_spool_segment = 0;
+
+	if ((tmp_ptr = xstrcasestr(slurm_conf.slurmctld_params,
+				   "dbd_spool_compress="))) {
+		char *type = xstrdup(tmp_ptr + strlen("dbd_spool_compress="));
+		tmp_ptr = strchr(type, ',');
+		if (tmp_ptr)
+			tmp_ptr[0] = '\0';
+		if (!xstrcasecmp(type, "lz4")) {
+#if HAVE_LZ4
+			dbd_spool_compress = COMPRESS_LZ4;
+#else
+			error("lz4 support not available, dbd_spool_compress disabled");
+			dbd_spool_compress = COMPRESS_OFF;
+#endif
+		} else if (!xstrcasecmp(type, "none"))
+			dbd_spool_compress = COMPRESS_OFF;
+		else
+			fatal("Unknown SlurmctldParameters option for dbd_spool_compress '%s'",
+			      type);
+		xfree(type);
+	} else
+		dbd_spool_compress = COMPRESS_OFF;
 }
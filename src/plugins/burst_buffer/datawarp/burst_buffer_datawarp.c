@@ -1741,6 +1741,7 @@ static void *_start_stage_out(void *x)
 			job_state_unset_flag(job_ptr, JOB_STAGE_OUT);
 			xfree(job_ptr->state_desc);
 			last_job_update = time(NULL);
+			job_ptr->last_update = time(NULL);
 		}
 		slurm_mutex_lock(&bb_state.bb_mutex);
 		bb_job = _get_bb_job(job_ptr);
@@ -3588,6 +3589,7 @@ fini:
 static void _kill_job(job_record_t *job_ptr, bool hold_job)
 {
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	job_ptr->end_time = last_job_update;
 	if (hold_job)
 		job_ptr->priority = 0;
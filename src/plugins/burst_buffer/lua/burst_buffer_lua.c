@@ -1705,6 +1705,7 @@ static void *_start_stage_out(void *x)
 		job_state_unset_flag(job_ptr, JOB_STAGE_OUT);
 		xfree(job_ptr->state_desc);
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		log_flag(BURST_BUF, "Stage-out/post-run complete for %pJ",
 			 job_ptr);
 		if (bb_job)
@@ -3596,6 +3597,7 @@ fini:	xfree(data_buf);
 static void _kill_job(job_record_t *job_ptr, bool hold_job, char *resp_msg)
 {
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	job_ptr->end_time = last_job_update;
 	if (hold_job)
 		job_ptr->priority = 0;
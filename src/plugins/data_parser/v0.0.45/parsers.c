@@ -424,6 +424,7 @@ typedef struct {
 	uint64_t dropped;
 	uint16_t cycle_last;
 	uint16_t cycle_max;
+	uint64_t coalesced;
 	uint64_t time;
 	uint64_t average_time;
 } STATS_MSG_RPC_TYPE_t;
@@ -3565,6 +3566,8 @@ static int DUMP_FUNC(STATS_MSG_RPCS_BY_TYPE)(const parser_t *const parser,
 			rpc.dropped = stats->rpc_type_dropped[i];
 			rpc.cycle_last = stats->rpc_type_cycle_last[i];
 			rpc.cycle_max = stats->rpc_type_cycle_max[i];
+			if (stats->rpc_type_coalesced)
+				rpc.coalesced = stats->rpc_type_coalesced[i];
 		}
 
 		if ((stats->rpc_type_time[i] > 0) &&
@@ -10474,6 +10477,7 @@ static const parser_t PARSER_ARRAY(STATS_MSG_RPC_TYPE)[] = {
 	add_parse_req(UINT64, dropped, "dropped", "Number of RPCs dropped"),
 	add_parse_req(UINT16, cycle_last, "cycle_last", "Number of RPCs processed within the last RPC queue cycle"),
 	add_parse_req(UINT16, cycle_max, "cycle_max", "Maximum number of RPCs processed within a RPC queue cycle since start"),
+	add_parse_req(UINT64, coalesced, "coalesced", "Number of RPCs answered with a response already packed within the same RPC queue cycle"),
 	add_parse_req(UINT64, time, "total_time", "Total time spent processing RPC in seconds"),
 	add_parse_req(UINT64_NO_VAL, average_time, "average_time", "Average time spent processing RPC in seconds"),
 };
@@ -45,10 +45,15 @@
 #include "fair_tree.h"
 
 static int  _ft_decay_apply_new_usage(job_record_t *job, time_t *start);
-static void _apply_priority_fs(void);
+static void _apply_priority_fs(bool recalc_all);
+
+/* Last g_assoc_mgr_update_gen seen when calculating fairshare */
+static uint32_t last_assoc_update_gen = 0;
+/* Sort every level, not only ones with new usage */
+static bool fs_recalc_all = true;
 
 /* Fair Tree code called from the decay thread loop */
-extern void fair_tree_decay(list_t *jobs, time_t start)
+extern void fair_tree_decay(list_t *jobs, time_t start, bool recalc_all)
 {
 	slurmctld_lock_t job_write_lock =
 		{ NO_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK, NO_LOCK };
@@ -63,11 +68,12 @@ extern void fair_tree_decay(list_t *jobs, time_t start)
 
 	/* calculate fs factor for associations */
 	assoc_mgr_lock(&locks);
-	_apply_priority_fs();
+	_apply_priority_fs(recalc_all);
 	assoc_mgr_unlock(&locks);
 
 	/* assign job priorities */
 	lock_slurmctld(job_write_lock);
+	decay_weighted_factors_prepare();
 	list_for_each(jobs, (ListForF) decay_apply_weighted_factors, &start);
 	unlock_slurmctld(job_write_lock);
 }
@@ -304,8 +310,65 @@ static slurmdb_assoc_rec_t** _merge_accounts(
 }
 
 
-/* Calculate fairshare for each child then sort children by fairshare value
- * (level_fs). Once they are sorted, operate on each child in sorted order.
+static int _calc_assoc_fs_for_each(void *x, void *arg)
+{
+	_calc_assoc_fs(x);
+	return 0;
+}
+
+/* Get the children of accounts [begin, end] sorted by level_fs.
+ *
+ * Decay scales all usage by the same factor, so the order of siblings only
+ * changes below accounts that had new usage added (fs_dirty). level_fs is
+ * still recalculated on every level since it is reported (e.g. sshare -l),
+ * but a clean account's children_list is already in sorted order and is not
+ * sorted again. Merged children of tied accounts are always sorted and are
+ * treated as dirty on the next pass.
+ *
+ * IN siblings - array of siblings, sorted by level_fs
+ * IN begin - index of first account
+ * IN end - index of last account
+ * IN assoc_level - depth in the tree (root is 0)
+ * RET - Array of the children. Must be freed.
+ */
+static slurmdb_assoc_rec_t **_sorted_children(slurmdb_assoc_rec_t **siblings,
+					      size_t begin, size_t end,
+					      uint16_t assoc_level)
+{
+	slurmdb_assoc_rec_t **children;
+	bool dirty = fs_recalc_all;
+	size_t i;
+
+	for (i = begin; i <= end; i++) {
+		if (siblings[i]->usage->fs_dirty)
+			dirty = true;
+		siblings[i]->usage->fs_dirty = (begin != end);
+	}
+
+	if (begin == end) {
+		list_t *list = siblings[begin]->usage->children_list;
+
+		if (list) {
+			list_for_each(list, _calc_assoc_fs_for_each, NULL);
+			if (dirty)
+				list_sort(list, (ListCmpF) _cmp_level_fs);
+		}
+
+		return _merge_accounts(siblings, begin, end, assoc_level);
+	}
+
+	children = _merge_accounts(siblings, begin, end, assoc_level);
+
+	for (i = 0; children[i]; i++)
+		_calc_assoc_fs(children[i]);
+
+	qsort(children, i, sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
+
+	return children;
+}
+
+/* Operate on each child in sorted order, as sorted by fairshare value
+ * (level_fs) in _sorted_children().
  * This portion of the tree is now sorted and users are given a fairshare value
  * based on the order they are operated on. The basic equation is
  * (rank / g_user_assoc_count), though ties are allowed. The rank is
@@ -318,7 +381,7 @@ static slurmdb_assoc_rec_t** _merge_accounts(
  *	3) A user with the same level_fs as a sibling account will receive
  *	   the same rank as the account's highest ranked user
  *
- * IN siblings - array of siblings
+ * IN siblings - array of siblings, sorted by level_fs
  * IN assoc_level - depth in the tree (root is 0)
  * IN/OUT rank - current user ranking, starting at g_user_assoc_count
  * IN/OUT rnt - rank, no ties (what rank would be if no tie exists)
@@ -339,13 +402,6 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 		return;
 	}
 
-	/* Calculate level_fs for each child */
-	for (i = 0; (assoc = siblings[i]); i++)
-		_calc_assoc_fs(assoc);
-
-	/* Sort children by level_fs */
-	qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
-
 	/* Iterate through children in sorted order. If it's a user, calculate
 	 * fs_factor, otherwise recurse. */
 	for (i = 0; (assoc = siblings[i]); i++) {
@@ -380,9 +436,9 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 			/* Merging does not affect child level_fs calculations
 			 * since the necessary information is stored on each
 			 * assoc's usage struct */
-			children = _merge_accounts(siblings, i,
-						   i + merge_count,
-						   assoc_level);
+			children = _sorted_children(siblings, i,
+						    i + merge_count,
+						    assoc_level);
 
 			_calc_tree_fs(children, assoc_level+1,
 				      rank, rnt, tied);
@@ -399,25 +455,27 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 
 
 /* Start fairshare calculations at root. Call assoc_mgr_lock before this. */
-static void _apply_priority_fs(void)
+static void _apply_priority_fs(bool recalc_all)
 {
 	slurmdb_assoc_rec_t** children = NULL;
+	slurmdb_assoc_rec_t *root[] = { assoc_mgr_root_assoc, NULL };
 	uint32_t rank = g_user_assoc_count;
 	uint32_t rnt = rank;
-	size_t child_count = 0;
 
 	log_flag(PRIO, "Fair Tree fairshare algorithm, starting at root:");
 
 	if (!assoc_mgr_root_assoc)
 		return;
 
+	/* Associations or shares changed, so no level can be trusted */
+	fs_recalc_all = (recalc_all ||
+			 (last_assoc_update_gen != g_assoc_mgr_update_gen));
+	last_assoc_update_gen = g_assoc_mgr_update_gen;
+
 	assoc_mgr_root_assoc->usage->level_fs = (long double) NO_VAL;
 
-	/* _calc_tree_fs requires an array instead of list */
-	children = _append_list_to_array(
-		assoc_mgr_root_assoc->usage->children_list,
-		children,
-		&child_count);
+	/* _calc_tree_fs requires a sorted array instead of list */
+	children = _sorted_children(root, 0, 0, 0);
 
 	_calc_tree_fs(children, 0, &rank, &rnt, false);
 
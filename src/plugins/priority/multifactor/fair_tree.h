@@ -40,7 +40,11 @@
 
 #include "priority_multifactor.h"
 
-/* Fair Tree code called from the decay thread loop */
-extern void fair_tree_decay(list_t *jobs, time_t start);
+/*
+ * Fair Tree code called from the decay thread loop
+ * IN recalc_all - usage changed other than by decay and new job usage, so
+ *	recalculate every level of the tree
+ */
+extern void fair_tree_decay(list_t *jobs, time_t start, bool recalc_all);
 
 #endif
@@ -126,6 +126,24 @@ static uint32_t flags;       /* Priority Flags */
 static time_t g_last_ran = 0; /* when the last poll ran */
 static time_t g_last_reset = 0; /* when the last reset was done */
 static double decay_factor = 1; /* The decay factor when decaying time. */
+static bool fs_recalc_all = true; /* Usage changed other than by decay or
+				   * new job usage; sort every level of the
+				   * Fair Tree */
+
+typedef struct {
+	uint32_t assoc_update_gen;
+	uint32_t cluster_cpus;
+	int node_cnt;
+	time_t part_update;
+} prio_inputs_t;
+
+/*
+ * Inputs to job priority that change without the job itself being updated
+ * (which always calls priority_p_set()). If none moved since the last pass
+ * only jobs whose age, fairshare, site or nice factor moved are refreshed.
+ */
+static prio_inputs_t last_prio_inputs;
+static bool refresh_all_jobs = true, refresh_all_pending = true;
 
 typedef struct {
 	job_record_t *job_ptr;
@@ -259,6 +277,7 @@ static int _reset_usage(void)
 		qos->usage->grp_used_wall = 0;
 	}
 	list_iterator_destroy(itr);
+	fs_recalc_all = true;
 	assoc_mgr_unlock(&locks);
 
 	return SLURM_SUCCESS;
@@ -392,6 +411,56 @@ static double _get_fairshare_priority(job_record_t *job_ptr)
 	return priority_fs;
 }
 
+static double _get_age_factor(time_t start_time, job_record_t *job_ptr)
+{
+	uint32_t diff = 0;
+
+	if (!job_ptr->details->accrue_time)
+		return 0.0;
+
+	/*
+	 * Only really add an age priority if the
+	 * job_ptr->details->accrue_time is past the start_time.
+	 */
+	if (start_time > job_ptr->details->accrue_time)
+		diff = start_time - job_ptr->details->accrue_time;
+
+	if (diff < max_age)
+		return (double) diff / (double) max_age;
+
+	return 1.0;
+}
+
+/*
+ * Check if a factor that changes without the job being updated moved since
+ * the job's priority was last calculated. Weighted factors are compared the
+ * same way _get_priority_internal() calculates them so equal means unchanged.
+ */
+static bool _job_factors_moved(job_record_t *job_ptr, time_t start_time)
+{
+	priority_factors_t *factors = job_ptr->prio_factors;
+
+	if (refresh_all_jobs || !factors || !job_ptr->details ||
+	    job_ptr->direct_set_prio)
+		return true;
+
+	if (weight_age &&
+	    (factors->priority_age !=
+	     (_get_age_factor(start_time, job_ptr) * (double) weight_age)))
+		return true;
+
+	if (weight_fs && job_ptr->assoc_ptr &&
+	    (factors->priority_fs !=
+	     (_get_fairshare_priority(job_ptr) * (double) weight_fs)))
+		return true;
+
+	if ((factors->priority_site != job_ptr->site_factor) ||
+	    (factors->nice != job_ptr->details->nice))
+		return true;
+
+	return false;
+}
+
 static void _get_tres_factors(job_record_t *job_ptr, part_record_t *part_ptr,
 			      double *tres_factors)
 {
@@ -1237,6 +1306,8 @@ static int _apply_new_usage(job_record_t *job_ptr, time_t start_period,
 	while (assoc) {
 		assoc->usage->grp_used_wall += run_decay;
 		assoc->usage->usage_raw += (long double)real_decay;
+		if (real_decay)
+			assoc->usage->fs_dirty = true;
 		log_flag(PRIO, "Adding %f new usage to assoc %u (%s/%s/%s) raw usage is now %Lf. Group wall added %f making it %f.",
 			 real_decay, assoc->id, assoc->acct, assoc->user,
 			 assoc->partition, assoc->usage->usage_raw, run_decay,
@@ -1404,8 +1475,11 @@ static void *_decay_thread(void *no_data)
 			goto get_usage;
 		real_decay = pow(decay_factor, (double)run_delta);
 
-		if (real_decay < DBL_MIN)
+		/* Small usage may underflow, so ratios are not kept */
+		if (real_decay < DBL_MIN) {
 			real_decay = DBL_MIN;
+			fs_recalc_all = true;
+		}
 
 		log_flag(PRIO, "Decay factor over %g seconds goes from %.15f -> %.15f",
 			 run_delta, decay_factor, real_decay);
@@ -1427,6 +1501,7 @@ static void *_decay_thread(void *no_data)
 		site_factor_g_update();
 
 		if (!(flags & PRIORITY_FLAGS_FAIR_TREE)) {
+			decay_weighted_factors_prepare();
 			list_for_each(
 				job_list,
 				(ListForF) _decay_apply_new_usage_and_weighted_factors,
@@ -1437,9 +1512,10 @@ static void *_decay_thread(void *no_data)
 		unlock_slurmctld(job_write_lock);
 
 	get_usage:
-		if (flags & PRIORITY_FLAGS_FAIR_TREE)
-			fair_tree_decay(job_list, start_time);
-		else if (calc_fairshare)
+		if (flags & PRIORITY_FLAGS_FAIR_TREE) {
+			fair_tree_decay(job_list, start_time, fs_recalc_all);
+			fs_recalc_all = false;
+		} else if (calc_fairshare)
 			list_for_each(
 				job_list,
 				_set_non_fair_tree_fs_factor,
@@ -1856,6 +1932,8 @@ extern void priority_p_reconfig(bool assoc_clear)
 				   NO_LOCK, NO_LOCK, NO_LOCK };
 
 	reconfig = 1;
+	fs_recalc_all = true;
+	refresh_all_pending = true;
 	_internal_setup();
 
 	/* Since Fair Tree uses a different shares calculation method, we
@@ -2033,6 +2111,33 @@ extern bool decay_apply_new_usage(job_record_t *job_ptr,
 }
 
 
+extern void decay_weighted_factors_prepare(void)
+{
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .qos = READ_LOCK };
+	prio_inputs_t inputs = {
+		.cluster_cpus = cluster_cpus,
+		.node_cnt = active_node_record_count,
+		.part_update = last_part_update,
+	};
+
+	assoc_mgr_lock(&locks);
+	inputs.assoc_update_gen = g_assoc_mgr_update_gen;
+	assoc_mgr_unlock(&locks);
+
+	refresh_all_jobs = (refresh_all_pending ||
+			    (inputs.assoc_update_gen !=
+			     last_prio_inputs.assoc_update_gen) ||
+			    (inputs.cluster_cpus !=
+			     last_prio_inputs.cluster_cpus) ||
+			    (inputs.node_cnt != last_prio_inputs.node_cnt) ||
+			    (inputs.part_update != last_prio_inputs.part_update));
+	refresh_all_pending = false;
+	last_prio_inputs = inputs;
+
+	log_flag(PRIO, "Refreshing priority of %s jobs",
+		 (refresh_all_jobs ? "all" : "moved"));
+}
+
 extern int decay_apply_weighted_factors(job_record_t *job_ptr,
 					time_t *start_time_ptr)
 {
@@ -2051,11 +2156,16 @@ extern int decay_apply_weighted_factors(job_record_t *job_ptr,
 	     !(flags & PRIORITY_FLAGS_CALCULATE_RUNNING)))
 		return SLURM_SUCCESS;
 
+	if (!_job_factors_moved(job_ptr, *start_time_ptr))
+		return SLURM_SUCCESS;
+
 	new_prio = _get_priority_internal(*start_time_ptr, job_ptr);
-	if (((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
-	    (job_ptr->priority < new_prio)) {
+	if ((((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
+	     (job_ptr->priority < new_prio)) &&
+	    (job_ptr->priority != new_prio)) {
 		job_ptr->priority = new_prio;
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 	}
 
 	debug2("priority for job %u is now %u",
@@ -2102,22 +2212,9 @@ extern void set_priority_factors(time_t start_time, job_record_t *job_ptr)
 		memset(job_ptr->prio_factors, 0, sizeof(priority_factors_t));
 	}
 
-	if (weight_age && job_ptr->details->accrue_time) {
-		uint32_t diff = 0;
-
-		/*
-		 * Only really add an age priority if the
-		 * job_ptr->details->accrue_time is past the start_time.
-		 */
-		if (start_time > job_ptr->details->accrue_time)
-			diff = start_time - job_ptr->details->accrue_time;
-
-		if (diff < max_age)
-			job_ptr->prio_factors->priority_age =
-				(double)diff / (double)max_age;
-		else
-			job_ptr->prio_factors->priority_age = 1.0;
-	}
+	if (weight_age)
+		job_ptr->prio_factors->priority_age =
+			_get_age_factor(start_time, job_ptr);
 
 	if (job_ptr->assoc_ptr && weight_fs) {
 		job_ptr->prio_factors->priority_fs =
@@ -54,6 +54,12 @@ extern double priority_p_calc_fs_factor(
 		long double usage_efctv, long double shares_norm);
 extern bool decay_apply_new_usage(job_record_t *job_ptr,
 				  time_t *start_time_ptr);
+/*
+ * Decide if the following decay_apply_weighted_factors() pass must refresh
+ * every job or only jobs whose age, fairshare, site or nice factor moved.
+ * Call with the job write and partition read locks held.
+ */
+extern void decay_weighted_factors_prepare(void);
 extern int decay_apply_weighted_factors(job_record_t *job_ptr,
 					time_t *start_time_ptr);
 extern void set_assoc_usage_norm(slurmdb_assoc_rec_t *assoc);
@@ -227,6 +227,7 @@ static uint32_t job_test_cnt = 0;
 static int max_backfill_job_cnt = DEF_BF_MAX_JOB_TEST;
 static int max_backfill_job_per_assoc = 0;
 static int max_backfill_job_per_part = 0;
+static int max_backfill_time_per_part = 0;
 static int max_backfill_job_per_user = 0;
 static int max_backfill_job_per_user_part = 0;
 static int max_backfill_jobs_start = 0;
@@ -239,7 +240,15 @@ static int yield_sleep   = YIELD_SLEEP;
 static list_t *het_job_list = NULL;
 static xhash_t *user_usage_map = NULL; /* look up user usage when no assoc */
 static bitstr_t *planned_bitmap = NULL;
+/* Temporaries of one _attempt_backfill() cycle, such as node_space bitmaps */
+static xarena_t *bf_arena = NULL;
 static bool soft_time_limit = false;
+/* node_space record indices ordered by time, mirrors the "next" chain */
+static int *ns_order = NULL;
+static int ns_order_cnt = 0;
+/* Partition being charged for bf_max_time_part and when it started */
+static part_record_t *time_part_ptr = NULL;
+static struct timeval time_part_tv;
 
 /*********************** local functions *********************/
 static void _add_reservation(time_t start_time, time_t end_reserve,
@@ -251,7 +260,7 @@ static void _attempt_backfill(void);
 static int  _clear_job_estimates(void *x, void *arg);
 static int  _clear_qos_blocked_times(void *x, void *arg);
 static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
-			   int node_space_recs);
+			   int node_space_recs, xarena_stats_t *arena_stats);
 static uint32_t _get_job_max_tl(job_record_t *job_ptr, time_t now,
 				node_space_map_t *node_space);
 static bool _hetjob_any_resv(job_record_t *het_leader);
@@ -359,6 +368,58 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 	log_flag(BACKFILL, "=========================================");
 }
 
+/*
+ * Return the position in ns_order of the first node_space record with an
+ * end_time after "when" (or at/after "when" if "inclusive" is set).
+ * Returns ns_order_cnt if there is no such record.
+ */
+static int _ns_order_pos(node_space_map_t *node_space, time_t when,
+			 bool inclusive)
+{
+	int lo = 0, hi = ns_order_cnt;
+
+	while (lo < hi) {
+		int mid = lo + ((hi - lo) / 2);
+		time_t end_time = node_space[ns_order[mid]].end_time;
+
+		if ((end_time > when) || (inclusive && (end_time == when)))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
+static void _ns_order_insert(int pos, int rec)
+{
+	memmove(&ns_order[pos + 1], &ns_order[pos],
+		sizeof(int) * (ns_order_cnt - pos));
+	ns_order[pos] = rec;
+	ns_order_cnt++;
+}
+
+static void _ns_order_remove(int pos)
+{
+	ns_order_cnt--;
+	memmove(&ns_order[pos], &ns_order[pos + 1],
+		sizeof(int) * (ns_order_cnt - pos));
+}
+
+extern int node_space_find(node_space_map_t *node_space, time_t when)
+{
+	int pos;
+
+	if (!ns_order_cnt)
+		return 0;
+
+	pos = _ns_order_pos(node_space, when, false);
+	if (pos >= ns_order_cnt)
+		pos = ns_order_cnt - 1;
+
+	return ns_order[pos];
+}
+
 static void _set_job_time_limit(job_record_t *job_ptr, uint32_t new_limit)
 {
 	job_ptr->time_limit = new_limit;
@@ -513,10 +574,13 @@ static int  _try_sched(job_record_t *job_ptr, bitstr_t **avail_bitmap,
 			} else {
 				rc = ESLURM_NODES_BUSY;
 			}
-			FREE_NULL_BITMAP(*avail_bitmap);
-			*avail_bitmap = bit_copy(tmp_bitmap);
+			if (!*avail_bitmap)
+				*avail_bitmap = bit_alloc(bit_size(tmp_bitmap));
 			if (low_bitmap)
-				bit_and_not(*avail_bitmap, low_bitmap);
+				bit_copybits_and_not(*avail_bitmap, tmp_bitmap,
+						     low_bitmap);
+			else
+				bit_copybits(*avail_bitmap, tmp_bitmap);
 			FREE_NULL_LIST(detail_ptr->feature_list_use);
 		}
 		list_iterator_destroy(feat_iter);
@@ -605,8 +669,9 @@ static int  _try_sched(job_record_t *job_ptr, bitstr_t **avail_bitmap,
 					*avail_bitmap = NULL;
 				}
 			}
-			FREE_NULL_BITMAP(*avail_bitmap);
-			*avail_bitmap = bit_copy(tmp_bitmap);
+			if (!*avail_bitmap)
+				*avail_bitmap = bit_alloc(bit_size(tmp_bitmap));
+			bit_copybits(*avail_bitmap, tmp_bitmap);
 			FREE_NULL_LIST(detail_ptr->feature_list_use);
 		}
 		list_iterator_destroy(feat_iter);
@@ -832,6 +897,23 @@ static void _load_config(void)
 		      max_backfill_job_per_part, max_backfill_job_cnt);
 	}
 
+	if ((tmp_ptr = xstrcasestr(sched_params, "bf_max_time_part="))) {
+		max_backfill_time_per_part = atoi(tmp_ptr + 17);
+		if ((max_backfill_time_per_part < 0) ||
+		    (max_backfill_time_per_part > MAX_BF_MAX_TIME)) {
+			error("Invalid SchedulerParameters bf_max_time_part: %d",
+			      max_backfill_time_per_part);
+			max_backfill_time_per_part = 0;
+		}
+	} else {
+		max_backfill_time_per_part = 0;
+	}
+	if (max_backfill_time_per_part &&
+	    (max_backfill_time_per_part >= bf_max_time)) {
+		error("bf_max_time_part >= bf_max_time (%d >= %d)",
+		      max_backfill_time_per_part, bf_max_time);
+	}
+
 	if ((tmp_ptr = xstrcasestr(sched_params, "bf_max_job_start="))) {
 		max_backfill_jobs_start = atoi(tmp_ptr + 17);
 		if (max_backfill_jobs_start < 0 ||
@@ -1075,9 +1157,10 @@ extern void backfill_reconfig(void)
  * IN tv1 - start time
  * IN tv2 - end (current) time
  * IN node_space_recs - count of records in resources/time table being tested
+ * IN arena_stats - allocations made out of bf_arena during the cycle
  */
 static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
-			   int node_space_recs)
+			   int node_space_recs, xarena_stats_t *arena_stats)
 {
 	uint32_t delta_t, real_time;
 
@@ -1100,6 +1183,8 @@ static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
 	}
 	slurmctld_diag_stats.bf_table_size = node_space_recs;
 	slurmctld_diag_stats.bf_table_size_sum += node_space_recs;
+	slurmctld_diag_stats.bf_arena_alloc_cnt = arena_stats->alloc_cnt;
+	slurmctld_diag_stats.bf_arena_alloc_bytes = arena_stats->alloc_bytes;
 }
 
 static void _init_planned_bitmap(void)
@@ -1123,7 +1208,9 @@ extern void __attempt_backfill(void)
 	_load_config();
 	het_job_list = list_create(_het_job_map_del);
 	_init_planned_bitmap();
+	bf_arena = xarena_create(0);
 	_attempt_backfill();
+	xarena_destroy(&bf_arena);
 	FREE_NULL_LIST(het_job_list);
 	FREE_NULL_BITMAP(planned_bitmap);
 }
@@ -1151,6 +1238,7 @@ extern void *backfill_agent(void *args)
 	last_backfill_time = time(NULL);
 	_init_planned_bitmap();
 	het_job_list = list_create(_het_job_map_del);
+	bf_arena = xarena_create(0);
 	while (!stop_backfill) {
 		if (short_sleep)
 			_my_sleep(USEC_IN_SEC);
@@ -1212,6 +1300,7 @@ extern void *backfill_agent(void *args)
 	FREE_NULL_LIST(het_job_list);
 	xhash_free(user_usage_map); /* May have been init'ed if used */
 	FREE_NULL_BITMAP(planned_bitmap);
+	xarena_destroy(&bf_arena);
 
 	return NULL;
 }
@@ -1684,6 +1773,24 @@ static bool _check_bf_usage(
 	return usage->count >= limit;
 }
 
+/*
+ * Add the time spent since time_part_tv to the bf_max_time_part usage of
+ * time_part_ptr, then start charging part_ptr (if any).
+ */
+static void _charge_part_time(part_record_t *part_ptr)
+{
+	if (time_part_ptr && time_part_ptr->bf_data &&
+	    time_part_ptr->bf_data->time_usage) {
+		time_part_ptr->bf_data->time_usage->count +=
+			slurm_delta_tv(&time_part_tv) /
+			(USEC_IN_SEC / MSEC_IN_SEC);
+	}
+
+	time_part_ptr = part_ptr;
+	if (time_part_ptr)
+		gettimeofday(&time_part_tv, NULL);
+}
+
 /*
  * Check if job exceeds configured count limits
  * returns true if count exceeded
@@ -1725,6 +1832,22 @@ static bool _job_exceeds_max_bf_param(job_record_t *job_ptr,
 		}
 	}
 
+	if (max_backfill_time_per_part) {
+		xassert(part_ptr->bf_data);
+		if (!part_ptr->bf_data->time_usage)
+			part_ptr->bf_data->time_usage =
+				xmalloc(sizeof(slurmdb_bf_usage_t));
+		part_usage = part_ptr->bf_data->time_usage;
+		if (_check_bf_usage(part_usage,
+				    (max_backfill_time_per_part * MSEC_IN_SEC),
+				    sched_start)) {
+			log_flag(BACKFILL, "have already spent %ds testing jobs for partition %s; skipping %pJ",
+				 max_backfill_time_per_part,
+				 job_ptr->part_ptr->name, job_ptr);
+			return true;
+		}
+	}
+
 	if (max_backfill_job_per_assoc) {
 		if (assoc_ptr) {
 			if (!assoc_ptr->bf_usage)
@@ -2058,17 +2181,16 @@ static int _get_licenses_from_nspace(node_space_map_t *node_space,
 				     time_t start_time,
 				     bf_licenses_t **licenses_pptr)
 {
-	int j = 0;
-	while (true) {
-		if ((node_space[j].end_time > start_time) &&
-		    (node_space[j].begin_time <= start_time)) {
-			*licenses_pptr = node_space[j].licenses;
+	int j = node_space_find(node_space, start_time);
 
-			return SLURM_SUCCESS;
-		}
-		if ((j = node_space[j].next) == 0)
-			return SLURM_ERROR;
+	if ((node_space[j].end_time > start_time) &&
+	    (node_space[j].begin_time <= start_time)) {
+		*licenses_pptr = node_space[j].licenses;
+
+		return SLURM_SUCCESS;
 	}
+
+	return SLURM_ERROR;
 }
 
 static int _hres_pre_select(job_record_t *job_ptr, node_space_map_t *node_space,
@@ -2113,7 +2235,9 @@ static int _hres_pre_select(job_record_t *job_ptr, node_space_map_t *node_space,
 static void _attempt_backfill(void)
 {
 	DEF_TIMERS;
+	xarena_stats_t arena_stats;
 	list_t *job_queue = NULL;
+	job_queue_heap_t *job_heap = NULL;
 	job_queue_rec_t *job_queue_rec = NULL;
 	int bb, i, j, node_space_recs, mcs_select = 0;
 	slurmdb_qos_rec_t *qos_ptr = NULL;
@@ -2184,7 +2308,7 @@ static void _attempt_backfill(void)
 
 	_handle_planned(nodes_planned);
 
-	job_queue = build_job_queue(true, true);
+	job_queue = build_job_queue(true, true, bf_arena);
 	job_test_count = list_count(job_queue);
 	if (job_test_count == 0) {
 		if (slurm_conf.debug_flags & DEBUG_FLAG_BACKFILL)
@@ -2192,6 +2316,7 @@ static void _attempt_backfill(void)
 		else
 			debug("no jobs to backfill");
 		FREE_NULL_LIST(job_queue);
+		xarena_reset(bf_arena, NULL);
 		return;
 	} else
 		debug("%u jobs to backfill", job_test_count);
@@ -2220,7 +2345,8 @@ static void _attempt_backfill(void)
 	window_end *= backfill_resolution;
 	node_space[0].end_time = window_end;
 
-	node_space[0].avail_bitmap = bit_copy(avail_node_bitmap);
+	node_space[0].avail_bitmap = bit_copy_arena(bf_arena,
+						    avail_node_bitmap);
 	/* Make "resuming" nodes available to be scheduled in backfill */
 	bit_or(node_space[0].avail_bitmap, rs_node_bitmap);
 
@@ -2235,6 +2361,9 @@ static void _attempt_backfill(void)
 
 	node_space[0].next = 0;
 	node_space_recs = 1;
+	ns_order = xcalloc((bf_node_space_size + 1), sizeof(int));
+	ns_order[0] = 0;
+	ns_order_cnt = 1;
 
 	if (bf_running_job_reserve) {
 		node_space_handler_t node_space_handler;
@@ -2276,7 +2405,8 @@ static void _attempt_backfill(void)
 		assoc_mgr_unlock(&qos_read_lock);
 	}
 
-	sort_job_queue(job_queue);
+	job_heap = job_queue_heap_create(job_queue);
+	FREE_NULL_LIST(job_queue);
 
 	/* Ignore nodes that have been set as available during this cycle. */
 	bit_clear_all(bf_ignore_node_bitmap);
@@ -2291,6 +2421,10 @@ static void _attempt_backfill(void)
 		bool use_prefer = false;
 		slurmctld_resv_t *resv_ptr = NULL;
 
+		/* Charge the last job's partition before any lock yield */
+		if (time_part_ptr)
+			_charge_part_time(NULL);
+
 		/* Run some final guaranteed logic after each job iteration */
 		if (job_ptr) {
 			job_resv_clear_magnetic_flag(job_ptr);
@@ -2319,8 +2453,8 @@ static void _attempt_backfill(void)
 				job_ptr->start_time = array_start_time;
 		}
 		array_start_time = 0;
-		xfree(job_queue_rec);
-		job_queue_rec = list_pop(job_queue);
+		xfree_arena(job_queue_rec);
+		job_queue_rec = job_queue_heap_pop(job_heap);
 		if (!job_queue_rec) {
 			log_flag(BACKFILL, "reached end of job queue");
 			_set_bf_exit(BF_EXIT_END);
@@ -2428,7 +2562,7 @@ static void _attempt_backfill(void)
 		else
 			job_queue_rec_magnetic_resv(job_queue_rec);
 		resv_ptr = job_ptr->resv_ptr;
-		xfree(job_queue_rec);
+		xfree_arena(job_queue_rec);
 
 		job_ptr->bit_flags |= BACKFILL_SCHED;
 		job_ptr->last_sched_eval = now;
@@ -2461,11 +2595,13 @@ static void _attempt_backfill(void)
 				assoc_mgr_unlock(&locks);
 				job_fail_qos(job_ptr, __func__, false);
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 			}
 			assoc_mgr_unlock(&locks);
 		}
@@ -2534,13 +2670,16 @@ static void _attempt_backfill(void)
 		if (!job_ptr->part_ptr->bf_data &&
 		    (bf_job_part_count_reserve ||
 		     max_backfill_job_per_user_part ||
-		     max_backfill_job_per_part)) {
+		     max_backfill_job_per_part ||
+		     max_backfill_time_per_part)) {
 			bf_part_data_t *part_data =
 				xmalloc(sizeof(bf_part_data_t));
 			part_data->job_usage =
 				xmalloc(sizeof(slurmdb_bf_usage_t));
 			part_data->resv_usage =
 				xmalloc(sizeof(slurmdb_bf_usage_t));
+			part_data->time_usage =
+				xmalloc(sizeof(slurmdb_bf_usage_t));
 			part_data->user_usage = xhash_init(_bf_map_key_id,
 							   _bf_map_free);
 			job_ptr->part_ptr->bf_data = part_data;
@@ -2636,6 +2775,8 @@ next_task:
 		/* Test to see if we've exceeded any per user/partition limit */
 		if (_job_exceeds_max_bf_param(job_ptr, orig_sched_start))
 			continue;
+		if (max_backfill_time_per_part)
+			_charge_part_time(part_ptr);
 
 		if (((part_ptr->state_up & PARTITION_SCHED) == 0) ||
 		    (part_ptr->node_bitmap == NULL)) {
@@ -2760,6 +2901,12 @@ TRY_LATER:
 			/* Sync planned nodes before yielding locks */
 			nodes_planned = true;
 			_handle_planned(nodes_planned);
+			/*
+			 * Partition may be deleted while locks are released,
+			 * and the yield is not that partition's test time.
+			 */
+			if (time_part_ptr)
+				_charge_part_time(NULL);
 			if (_yield_locks(yield_sleep)) {
 				log_flag(BACKFILL, "system state changed, breaking out after testing %u(%d) jobs",
 					 slurmctld_diag_stats.bf_last_depth,
@@ -2820,6 +2967,8 @@ TRY_LATER:
 			job_ptr->time_limit = save_time_limit;
 			job_ptr->part_ptr = part_ptr;
 			job_ptr->qos_ptr = qos_ptr;
+			if (max_backfill_time_per_part)
+				_charge_part_time(part_ptr);
 		}
 
 		/*
@@ -2919,7 +3068,7 @@ TRY_LATER:
 		}
 
 		COPY_BITMAP(tmp_bitmap, avail_bitmap);
-		for (j = 0; ; ) {
+		for (j = node_space_find(node_space, start_res); ; ) {
 			if ((node_space[j].end_time > start_res) &&
 			     node_space[j].next && (later_start == 0)) {
 				int tmp = node_space[j].next;
@@ -3113,7 +3262,7 @@ later_start_set:
 			orig_end_time = end_time;
 			end_time += boot_time;
 
-			for (j = 0; ; ) {
+			for (j = node_space_find(node_space, start_res); ; ) {
 				if (node_space[j].end_time <= start_res)
 					;
 				else if (node_space[j].begin_time <= end_time) {
@@ -3155,6 +3304,7 @@ later_start_set:
 		if (start_res > job_ptr->start_time) {
 			job_ptr->start_time = start_res;
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		}
 
 		if (job_ptr->start_time > now) {
@@ -3235,6 +3385,7 @@ later_start_set:
 					     job_ptr->state_reason),
 				     job_ptr->priority);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			_set_job_time_limit(job_ptr, orig_time_limit);
 			later_start = 0;
 			if (bb == -1) {
@@ -3687,7 +3838,7 @@ skip_start:
 	if (!nodes_planned)
 		_handle_planned(true);
 
-	xfree(job_queue_rec);
+	xfree_arena(job_queue_rec);
 
 	if (job_ptr) {
 		/* Restore preemption state if needed. */
@@ -3725,16 +3876,20 @@ skip_start:
 		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
 	}
 	xfree(node_space);
+	xfree(ns_order);
+	ns_order_cnt = 0;
+	_charge_part_time(NULL);
 
-	FREE_NULL_LIST(job_queue);
+	job_queue_heap_free(job_heap);
 	FREE_NULL_LIST(nodes_used_list);
 	xfree(nodes_used);
 
 	if (bf_topopt_enable)
 		fini_oracle();
 
+	xarena_reset(bf_arena, &arena_stats);
 	gettimeofday(&bf_time2, NULL);
-	_do_diag_stats(&bf_time1, &bf_time2, node_space_recs);
+	_do_diag_stats(&bf_time1, &bf_time2, node_space_recs, &arena_stats);
 	if (slurm_conf.debug_flags & DEBUG_FLAG_BACKFILL) {
 		END_TIMER;
 		info("completed testing %u(%d) jobs, %s",
@@ -3793,6 +3948,7 @@ static int _start_job(job_record_t *job_ptr, bitstr_t *resv_bitmap)
 	if (rc == SLURM_SUCCESS) {
 		/* job initiated */
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		info("Started %pJ in %s on %s",
 		     job_ptr, job_ptr->part_ptr->name, job_ptr->nodes);
 		if (job_ptr->batch_flag == 0)
@@ -3841,8 +3997,9 @@ static uint32_t _get_job_max_tl(job_record_t *job_ptr, time_t now,
 		return max_tl;
 
 	for (j = 0; ; ) {
+		if (node_space[j].begin_time >= job_ptr->end_time)
+			break;	/* Records are ordered by time */
 		if ((node_space[j].begin_time != now) && // No current conflicts
-		    (node_space[j].begin_time < job_ptr->end_time) &&
 		    (!bit_super_set(job_ptr->node_bitmap,
 				    node_space[j].avail_bitmap) ||
 		     !bf_licenses_avail(node_space[j].licenses, job_ptr,
@@ -3876,8 +4033,9 @@ static void _reset_job_time_limit(job_record_t *job_ptr, time_t now,
 	uint32_t new_time_limit;
 
 	for (j = 0; ; ) {
+		if (node_space[j].begin_time >= job_ptr->end_time)
+			break;	/* Records are ordered by time */
 		if ((node_space[j].begin_time != now) && // No current conflicts
-		    (node_space[j].begin_time < job_ptr->end_time) &&
 		    (!bit_super_set(job_ptr->node_bitmap,
 				    node_space[j].avail_bitmap))) {
 			/* Job overlaps pending job's resource reservation */
@@ -3928,6 +4086,7 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 {
 	bool placed = false;
 	int i, j, one_before = 0, one_after = -1;
+	int pos, before_pos;
 	bitstr_t *res_bitmap_orig = res_bitmap;
 	bitstr_t *res_bitmap_efctv = NULL;
 
@@ -3972,50 +4131,57 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 	 */
 	if (end_reserve < (start_time + backfill_resolution))
 		end_reserve = start_time + backfill_resolution;
-	for (j = 0; ; ) {
-		if (node_space[j].end_time > start_time) {
-			/* insert start entry record */
-			i = *node_space_recs;
-			node_space[i].begin_time = start_time;
-			node_space[i].end_time = node_space[j].end_time;
-			node_space[j].end_time = start_time;
-			COPY_BITMAP(node_space[i].avail_bitmap,
-				    node_space[j].avail_bitmap);
-			node_space[i].licenses =
-				bf_licenses_copy(node_space[j].licenses);
-			node_space[i].fragmentation =
-				node_space[j].fragmentation;
-			node_space[i].next = node_space[j].next;
-			node_space[j].next = i;
-			(*node_space_recs)++;
-			placed = true;
-			break;
-		}
-		if (node_space[j].end_time == start_time) {
-			/* no need to insert new start entry record */
-			placed = true;
-			break;
-		}
-		one_before = j;
-		if ((j = node_space[j].next) == 0)
-			break;
+	/* Locate the first record ending at or after start_time */
+	pos = _ns_order_pos(node_space, start_time, true);
+	if (pos >= ns_order_cnt) {
+		/* start_time is beyond the end of the table */
+		pos = ns_order_cnt - 1;
+		before_pos = pos;
+	} else {
+		before_pos = pos ? (pos - 1) : 0;
+	}
+	j = ns_order[pos];
+	one_before = ns_order[before_pos];
+
+	if (node_space[j].end_time > start_time) {
+		/* insert start entry record */
+		i = *node_space_recs;
+		node_space[i].begin_time = start_time;
+		node_space[i].end_time = node_space[j].end_time;
+		node_space[j].end_time = start_time;
+		COPY_BITMAP_ARENA(bf_arena, node_space[i].avail_bitmap,
+				  node_space[j].avail_bitmap);
+		node_space[i].licenses =
+			bf_licenses_copy(node_space[j].licenses);
+		node_space[i].fragmentation =
+			node_space[j].fragmentation;
+		node_space[i].next = node_space[j].next;
+		node_space[j].next = i;
+		_ns_order_insert(pos + 1, i);
+		(*node_space_recs)++;
+		placed = true;
+	} else if (node_space[j].end_time == start_time) {
+		/* no need to insert new start entry record */
+		placed = true;
 	}
 
 	while (placed && (j = node_space[j].next)) {
+		pos++;
 		if (end_reserve < node_space[j].end_time) {
 			/* insert end entry record */
 			i = *node_space_recs;
 			node_space[i].begin_time = end_reserve;
 			node_space[i].end_time = node_space[j].end_time;
 			node_space[j].end_time = end_reserve;
-			COPY_BITMAP(node_space[i].avail_bitmap,
-				    node_space[j].avail_bitmap);
+			COPY_BITMAP_ARENA(bf_arena, node_space[i].avail_bitmap,
+					  node_space[j].avail_bitmap);
 			node_space[i].licenses =
 				bf_licenses_copy(node_space[j].licenses);
 			node_space[i].fragmentation =
 				node_space[j].fragmentation;
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
+			_ns_order_insert(pos + 1, i);
 			(*node_space_recs)++;
 		}
 
@@ -4053,15 +4219,18 @@ static void _add_reservation(time_t start_time, time_t end_reserve,
 		if (!bf_licenses_equal(node_space[i].licenses,
 				       node_space[j].licenses)) {
 			i = j;
+			before_pos++;
 			continue;
 		}
 		if (!bit_equal(node_space[i].avail_bitmap,
 			       node_space[j].avail_bitmap)) {
 			i = j;
+			before_pos++;
 			continue;
 		}
 		node_space[i].end_time = node_space[j].end_time;
 		node_space[i].next = node_space[j].next;
+		_ns_order_remove(before_pos + 1);
 		if (node_space[j].avail_bitmap) {
 			for (i = *node_space_recs;
 			     i <= bf_node_space_size; i++) {
@@ -4094,7 +4263,7 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 			       uint32_t start_time, uint32_t end_reserve)
 {
 	bool overlap = false;
-	int j = 0;
+	int j;
 	bitstr_t *use_bitmap_efctv = NULL;
 	bitstr_t *use_bitmap_orig = use_bitmap;
 
@@ -4105,9 +4274,10 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 		use_bitmap = use_bitmap_efctv;
 	}
 
-	while (true) {
-		if ((node_space[j].end_time > start_time) &&
-		    (node_space[j].begin_time < end_reserve)) {
+	for (j = node_space_find(node_space, start_time); ; ) {
+		if (node_space[j].begin_time >= end_reserve)
+			break;	/* Records are ordered by time */
+		if (node_space[j].end_time > start_time) {
 			/*
 			 * Jobs will run concurrently.
 			 * Do they conflict for resources?
@@ -4591,6 +4761,7 @@ static void _het_job_kill_now(het_job_map_t *map)
 		job_ptr->end_time   = now;
 		job_state_set(job_ptr, (JOB_PENDING | JOB_COMPLETING));
 		last_job_update     = now;
+		job_ptr->last_update = time(NULL);
 		build_cg_bitmap(job_ptr);
 		job_completion_logger(job_ptr, false);
 		deallocate_nodes(job_ptr, false, false, false);
@@ -52,6 +52,14 @@ typedef struct {
 	int next; /* next record, by time, zero termination */
 } node_space_map_t;
 
+/*
+ * Return the index of the first node_space record whose end_time is after
+ * "when" (the record covering "when"), or the last record if none.
+ * Uses the time index maintained alongside the linked records, so this is
+ * a binary search rather than a walk of the "next" chain.
+ */
+extern int node_space_find(node_space_map_t *node_space, time_t when);
+
 /* backfill_agent - detached thread periodically attempts to backfill jobs */
 extern void *backfill_agent(void *args);
 
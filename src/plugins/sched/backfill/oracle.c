@@ -51,20 +51,17 @@ static int _get_bitmap_from_nspace(node_space_map_t *node_space,
 				   time_t start_time, bitstr_t *out_bitmap,
 				   uint32_t *fragmentation)
 {
-	int j = 0;
-	while (true) {
-		if ((node_space[j].end_time > start_time) &&
-		    (node_space[j].begin_time <= start_time)) {
-			bit_copybits(out_bitmap,
-				     node_space[j].avail_bitmap);
-			*fragmentation = node_space[j].fragmentation;
-
-			return SLURM_SUCCESS;
-		}
-
-		if ((j = node_space[j].next) == 0)
-			return SLURM_ERROR;
+	int j = node_space_find(node_space, start_time);
+
+	if ((node_space[j].end_time > start_time) &&
+	    (node_space[j].begin_time <= start_time)) {
+		bit_copybits(out_bitmap, node_space[j].avail_bitmap);
+		*fragmentation = node_space[j].fragmentation;
+
+		return SLURM_SUCCESS;
 	}
+
+	return SLURM_ERROR;
 }
 
 static void _add_slot(job_record_t *job_ptr, bitstr_t *job_bitmap,
@@ -140,6 +140,7 @@ static void _compute_start_times(void)
 {
 	int j, rc = SLURM_SUCCESS, job_cnt = 0;
 	list_t *job_queue = NULL;
+	job_queue_heap_t *job_heap = NULL;
 	job_queue_rec_t *job_queue_rec;
 	job_record_t *job_ptr;
 	part_record_t *part_ptr;
@@ -152,9 +153,10 @@ static void _compute_start_times(void)
 	sched_start = now;
 	last_job_alloc = now - 1;
 	alloc_bitmap = bit_alloc(node_record_count);
-	job_queue = build_job_queue(true, false);
-	sort_job_queue(job_queue);
-	while ((job_queue_rec = (job_queue_rec_t *) list_pop(job_queue))) {
+	job_queue = build_job_queue(true, false, NULL);
+	job_heap = job_queue_heap_create(job_queue);
+	FREE_NULL_LIST(job_queue);
+	while ((job_queue_rec = job_queue_heap_pop(job_heap))) {
 		job_ptr  = job_queue_rec->job_ptr;
 		part_ptr = job_queue_rec->part_ptr;
 		xfree(job_queue_rec);
@@ -207,6 +209,7 @@ static void _compute_start_times(void)
 				       NULL);
 		if (rc == SLURM_SUCCESS) {
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			if (job_ptr->time_limit == INFINITE)
 				time_limit = 365 * 24 * 60 * 60;
 			else if (job_ptr->time_limit != NO_VAL)
@@ -232,7 +235,7 @@ static void _compute_start_times(void)
 			break;
 		}
 	}
-	FREE_NULL_LIST(job_queue);
+	job_queue_heap_free(job_heap);
 	FREE_NULL_BITMAP(alloc_bitmap);
 }
 
@@ -43,6 +43,7 @@
 typedef struct {
 	bool first_set;
 	job_resources_t *job_res;
+	node_use_record_t *node_usage;
 	bool rc;
 } foreach_gres_job_mem_set_args_t;
 
@@ -310,11 +311,17 @@ static int _foreach_gres_job_mem_set(void *x, void *arg)
 		if (args->job_res->whole_node & WHOLE_NODE_REQUIRED) {
 			gres_state_t *gres_state_node;
 			gres_node_state_t *gres_ns;
+			gres_node_index_t *node_gres_index = NULL;
 
+			/* The view tracks the copy if node_usage has one */
+			if (!args->node_usage[node_ptr->index].gres_list)
+				node_gres_index =
+				&args->node_usage[node_ptr->index].gres_index;
 			gres_state_node =
-				list_find_first(node_ptr->gres_list,
-						gres_find_id,
-						&gres_state_job->plugin_id);
+				gres_node_index_find(node_gres_index,
+						     node_ptr->gres_list,
+						     gres_state_job->plugin_id,
+						     gres_state_job->ctx_inx);
 			if (!gres_state_node)
 				return 0;
 			gres_ns = gres_state_node->gres_data;
@@ -337,11 +344,13 @@ static int _foreach_gres_job_mem_set(void *x, void *arg)
  * RET TRUE if mem-per-tres specification used to set memory limits
  */
 extern bool gres_select_util_job_mem_set(list_t *job_gres_list,
-					 job_resources_t *job_res)
+					 job_resources_t *job_res,
+					 node_use_record_t *node_usage)
 {
 	foreach_gres_job_mem_set_args_t args = {
 		.first_set = true,
 		.job_res = job_res,
+		.node_usage = node_usage,
 	};
 
 	if (!job_gres_list)
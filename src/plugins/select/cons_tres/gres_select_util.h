@@ -39,6 +39,8 @@
 
 #include "src/interfaces/gres.h"
 
+#include "node_data.h"
+
 /*
  * Set job default parameters in a given element of a list
  * IN job_gres_list - job's gres_list built by gres_job_state_validate()
@@ -90,10 +92,14 @@ extern int gres_select_util_job_min_tasks(uint32_t node_count,
 
 /*
  * Set per-node memory limits based upon GRES assignments
+ * IN job_gres_list - job GRES specification
+ * IN job_res - job's allocated resources
+ * IN node_usage - per-node usage, its gres_index is used for node GRES lookups
  * RET TRUE if mem-per-tres specification used to set memory limits
  */
 extern bool gres_select_util_job_mem_set(list_t *job_gres_list,
-					 job_resources_t *job_res);
+					 job_resources_t *job_res,
+					 node_use_record_t *node_usage);
 
 /*
  * Determine the minimum number of CPUs required to satisfy the job's GRES
@@ -56,6 +56,8 @@ typedef struct {
 	list_t *gres_list_resv;
 } foreach_gres_sock_list_create_t;
 
+static pthread_mutex_t res_gpu_cores_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void _handle_gres_exc_topo(resv_exc_t *resv_exc_ptr, int node_inx,
 				  int topo_inx, gres_node_state_t *gres_ns,
 				  uint64_t *avail_gres, bool use_total_gres,
@@ -712,11 +714,14 @@ static void _pick_restricted_cores(bitstr_t *core_bitmap,
 	int *picked_cores = xcalloc(res_cores_per_gpu, sizeof(int));
 	gres_job_state_t *gres_js = gres_state_job->gres_data;
 
+	/* Nodes may be tested by several threads, see select_threads */
+	slurm_mutex_lock(&res_gpu_cores_mutex);
 	if (!gres_js->res_gpu_cores) {
 		gres_js->res_array_size = node_record_count;
 		gres_js->res_gpu_cores = xcalloc(gres_js->res_array_size,
 						 sizeof(bitstr_t *));
 	}
+	slurm_mutex_unlock(&res_gpu_cores_mutex);
 	/*
 	 * This function can be called multiple times for the same node_i while
 	 * a job is pending. Free any existing gres_js->res_gpu_cores[node_i]
@@ -812,9 +817,10 @@ static void _gres_limit_reserved_cores(gres_sock_list_create_t *create_args)
 	    !create_args->res_cores_per_gpu)
 		return;
 
-	gres_state_node = list_find_first(create_args->node_gres_list,
-					  gres_find_id,
-					  &gpu_plugin_id);
+	gres_state_node = gres_node_index_find(create_args->node_gres_index,
+					       create_args->node_gres_list,
+					       gpu_plugin_id,
+					       gres_get_gpu_index());
 	if (!gres_state_node)
 		return;
 
@@ -842,9 +848,10 @@ static int _foreach_gres_sock_list_create(void *x, void *arg)
 	gres_job_state_t *gres_js = gres_state_job->gres_data;
 	gres_node_state_t *gres_ns;
 	gres_state_t *gres_state_node =
-		list_find_first(create_args->node_gres_list,
-				gres_find_id,
-				&gres_state_job->plugin_id);
+		gres_node_index_find(create_args->node_gres_index,
+				     create_args->node_gres_list,
+				     gres_state_job->plugin_id,
+				     gres_state_job->ctx_inx);
 	node_record_t *node_ptr = node_record_table_ptr[create_args->node_inx];
 
 	if (gres_id_sharing(gres_state_job->plugin_id))
@@ -51,6 +51,8 @@ typedef struct {
 	list_t *job_gres_list; /* IN - job's gres_list built by
 				* gres_job_state_validate() */
 	bool need_gpu; /* OUT - true if job request GPU */
+	gres_node_index_t *node_gres_index; /* IN/OUT - flat view of
+					     * node_gres_list or NULL */
 	list_t *node_gres_list; /* IN - node's gres_list built by
 				 * gres_node_config_validate() */
 	uint32_t node_inx; /* IN - index of node to be evaluated */
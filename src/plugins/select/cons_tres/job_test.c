@@ -44,6 +44,7 @@
 
 #include "src/slurmctld/licenses.h"
 #include "src/common/slurm_time.h"
+#include "src/common/threadpool.h"
 
 typedef struct {
 	int action;
@@ -75,6 +76,79 @@ typedef struct {
 	uint32_t required;
 } license_req_t;
 
+/*
+ * Everything _can_job_run_on_node() reads for a job without GRES or
+ * hierarchical resources, other than the core bitmaps. Cleared with memset()
+ * before being filled so it can be compared with memcmp().
+ */
+typedef struct {
+	/* node */
+	uint32_t node_i;
+	uint64_t alloc_memory;
+	uint64_t mem_spec_limit;
+	uint64_t real_memory;
+	uint16_t cores;
+	uint16_t cpus;
+	uint16_t threads;
+	uint16_t tot_sockets;
+	uint16_t tpc;
+	bool completing;
+	bool part_core_map;
+	/* test */
+	uint16_t cr_type;
+	bool test_only;
+	bool will_run;
+	/* job shape */
+	uint64_t bit_flags;
+	uint16_t core_spec;
+	uint16_t cpus_per_task;
+	bool cpus_per_tres;
+	uint32_t max_cpus_per_node;
+	uint32_t max_cpus_per_socket;
+	uint32_t max_nodes;
+	int min_gres_cpu;
+	uint16_t ntasks_per_node;
+	uint32_t num_tasks;
+	uint32_t orig_pn_min_cpus;
+	uint8_t overcommit;
+	uint32_t pn_min_cpus;
+	uint64_t pn_min_memory;
+	uint8_t share_res;
+	uint8_t whole_node;
+	bool mc;
+	uint16_t mc_cores_per_socket;
+	uint16_t mc_ntasks_per_core;
+	uint16_t mc_ntasks_per_socket;
+	uint16_t mc_sockets_per_node;
+	uint16_t mc_threads_per_core;
+} avail_cache_key_t;
+
+typedef struct {
+	job_record_t *job_ptr;
+	bitstr_t *node_map;
+	bitstr_t **core_map;
+	node_use_record_t *node_usage;
+	uint16_t cr_type;
+	bool test_only;
+	bool will_run;
+	bitstr_t **part_core_map;
+	resv_exc_t *resv_exc_ptr;
+	uint32_t s_p_n;
+	avail_res_t **avail_res_array;
+	int i_first;
+	int i_last;
+} get_res_avail_args_t;
+
+typedef struct {
+	uint32_t gen; /* 0 if never used */
+	uint32_t hash;
+	avail_cache_key_t key;
+	bitstr_t *core_map; /* available cores on input */
+	bitstr_t *part_core_map; /* NULL if none */
+	bitstr_t *core_map_out; /* available cores on output */
+	avail_res_t *avail_res; /* NULL if job can not run on the node */
+} avail_cache_ent_t;
+
 typedef struct {
 	bitstr_t *effective_nodes;
 	list_t *future_license_list;
@@ -90,6 +164,18 @@ bool preempt_strict_order = false;
 bool preempt_for_licenses = false;
 int preempt_reorder_cnt	= 1;
 bool soft_time_limit = false;
+int select_threads = 1;
+
+/*
+ * Results of _can_job_run_on_node() for recently tested job shapes.
+ * Direct mapped: a new result simply replaces whatever used the same slot.
+ */
+#define AVAIL_CACHE_SIZE 4096 /* must be a power of 2 */
+/* Minimum number of nodes for each thread of _get_res_avail() */
+#define SELECT_THREAD_MIN_NODES 128
+static avail_cache_ent_t *avail_cache = NULL;
+static uint32_t avail_cache_gen = 1;
+static pthread_mutex_t avail_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* Local functions */
 static avail_res_t *_allocate(job_record_t *job_ptr,
@@ -523,6 +609,7 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
 		.gpu_spec_bitmap = node_ptr->gpu_spec_bitmap,
 		.job_gres_list = job_ptr->gres_list_req,
 		.need_gpu = false,
+		.node_gres_index = &node_usage[node_i].gres_index,
 		.node_gres_list = node_usage[node_i].gres_list ?
 					  node_usage[node_i].gres_list :
 					  node_ptr->gres_list,
@@ -736,6 +823,289 @@ static avail_res_t *_can_job_run_on_node(job_record_t *job_ptr,
 	return avail_res;
 }
 
+/* Copy of a result without GRES that the caller may modify freely */
+static avail_res_t *_dup_avail_res(avail_res_t *avail_res)
+{
+	avail_res_t *new_res;
+
+	if (!avail_res)
+		return NULL;
+
+	xassert(!avail_res->sock_gres_list);
+
+	new_res = xmalloc(sizeof(*new_res));
+	memcpy(new_res, avail_res, sizeof(*new_res));
+	if (avail_res->avail_cores_per_sock) {
+		new_res->avail_cores_per_sock =
+			xcalloc(avail_res->sock_cnt, sizeof(uint16_t));
+		memcpy(new_res->avail_cores_per_sock,
+		       avail_res->avail_cores_per_sock,
+		       (avail_res->sock_cnt * sizeof(uint16_t)));
+	}
+
+	return new_res;
+}
+
+/*
+ * Fill in the cache key of a job on a node
+ * RET false if the result of _can_job_run_on_node() can not be cached
+ */
+static bool _avail_cache_key(avail_cache_key_t *key, job_record_t *job_ptr,
+			     bitstr_t **core_map, const uint32_t node_i,
+			     node_use_record_t *node_usage, uint16_t cr_type,
+			     bool test_only, bool will_run,
+			     bitstr_t **part_core_map)
+{
+	node_record_t *node_ptr = node_record_table_ptr[node_i];
+	job_details_t *details = job_ptr->details;
+
+	/*
+	 * GRES and hres results depend on GRES usage and topology that is not
+	 * part of the key, and may also change the node's sched_weight.
+	 */
+	if (job_ptr->gres_list_req || job_ptr->hres_select ||
+	    !job_ptr->part_ptr || !core_map[node_i])
+		return false;
+
+	memset(key, 0, sizeof(*key));
+
+	key->node_i = node_i;
+	if ((cr_type & SELECT_MEMORY) && !test_only)
+		key->alloc_memory = node_usage[node_i].alloc_memory;
+	key->mem_spec_limit = node_ptr->mem_spec_limit;
+	key->real_memory = node_ptr->real_memory;
+	key->cores = node_ptr->cores;
+	key->cpus = node_ptr->cpus;
+	key->threads = node_ptr->threads;
+	key->tot_sockets = node_ptr->tot_sockets;
+	key->tpc = node_ptr->tpc;
+	key->completing = IS_NODE_COMPLETING(node_ptr);
+	key->part_core_map = (part_core_map && part_core_map[node_i]);
+
+	key->cr_type = cr_type;
+	key->test_only = test_only;
+	key->will_run = will_run;
+
+	key->bit_flags = (job_ptr->bit_flags &
+			  (BACKFILL_TEST | BF_WHOLE_NODE_TEST));
+	key->core_spec = details->core_spec;
+	key->cpus_per_task = details->cpus_per_task;
+	key->cpus_per_tres = (job_ptr->cpus_per_tres != NULL);
+	key->max_cpus_per_node = job_ptr->part_ptr->max_cpus_per_node;
+	key->max_cpus_per_socket = job_ptr->part_ptr->max_cpus_per_socket;
+	key->max_nodes = details->max_nodes;
+	key->min_gres_cpu = details->min_gres_cpu;
+	key->ntasks_per_node = details->ntasks_per_node;
+	key->num_tasks = details->num_tasks;
+	key->orig_pn_min_cpus = details->orig_pn_min_cpus;
+	key->overcommit = details->overcommit;
+	key->pn_min_cpus = details->pn_min_cpus;
+	key->pn_min_memory = details->pn_min_memory;
+	key->share_res = details->share_res;
+	key->whole_node = details->whole_node;
+	if (details->mc_ptr) {
+		multi_core_data_t *mc_ptr = details->mc_ptr;
+
+		key->mc = true;
+		key->mc_cores_per_socket = mc_ptr->cores_per_socket;
+		key->mc_ntasks_per_core = mc_ptr->ntasks_per_core;
+		key->mc_ntasks_per_socket = mc_ptr->ntasks_per_socket;
+		key->mc_sockets_per_node = mc_ptr->sockets_per_node;
+		key->mc_threads_per_core = mc_ptr->threads_per_core;
+	}
+
+	return true;
+}
+
+static uint32_t _fnv1a(uint32_t hash, const void *data, size_t len)
+{
+	const unsigned char *ptr = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= ptr[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Hash the key and a summary of the core bitmaps. Entries with the same hash
+ * are still compared in full.
+ */
+static uint32_t _avail_cache_hash(avail_cache_key_t *key, bitstr_t *core_map,
+				  bitstr_t *part_core_map)
+{
+	uint32_t hash = 2166136261U;
+	int32_t summary[6] = {
+		bit_set_count(core_map),
+		bit_ffs(core_map),
+		bit_fls(core_map),
+	};
+
+	if (part_core_map) {
+		summary[3] = bit_set_count(part_core_map);
+		summary[4] = bit_ffs(part_core_map);
+		summary[5] = bit_fls(part_core_map);
+	}
+
+	hash = _fnv1a(hash, key, sizeof(*key));
+	hash = _fnv1a(hash, summary, sizeof(summary));
+
+	return hash;
+}
+
+/*
+ * Wrapper around _can_job_run_on_node() which reuses the result for the same
+ * job shape on the same node with the same available cores and memory. The
+ * node usage _can_job_run_on_node() depends on is part of the key, so results
+ * never outlive a change to it, including in the private node usage copies of
+ * will_run tests.
+ */
+static avail_res_t *_can_job_run_on_node_cached(job_record_t *job_ptr,
+						bitstr_t **core_map,
+						const uint32_t node_i,
+						uint32_t s_p_n,
+						node_use_record_t *node_usage,
+						uint16_t cr_type,
+						bool test_only, bool will_run,
+						bitstr_t **part_core_map,
+						resv_exc_t *resv_exc_ptr)
+{
+	avail_cache_key_t key;
+	avail_cache_ent_t *ent;
+	avail_res_t *avail_res;
+	bitstr_t *part_map = NULL, *in_map;
+	uint32_t hash;
+
+	if (!_avail_cache_key(&key, job_ptr, core_map, node_i, node_usage,
+			      cr_type, test_only, will_run, part_core_map))
+		return _can_job_run_on_node(job_ptr, core_map, node_i, s_p_n,
+					    node_usage, cr_type, test_only,
+					    will_run, part_core_map,
+					    resv_exc_ptr);
+
+	if (key.part_core_map)
+		part_map = part_core_map[node_i];
+	hash = _avail_cache_hash(&key, core_map[node_i], part_map);
+
+	slurm_mutex_lock(&avail_cache_mutex);
+	if (!avail_cache)
+		avail_cache = xcalloc(AVAIL_CACHE_SIZE, sizeof(*avail_cache));
+	ent = &avail_cache[hash & (AVAIL_CACHE_SIZE - 1)];
+	if ((ent->gen == avail_cache_gen) && (ent->hash == hash) &&
+	    !memcmp(&ent->key, &key, sizeof(key)) &&
+	    bit_equal(ent->core_map, core_map[node_i]) &&
+	    (!part_map || bit_equal(ent->part_core_map, part_map))) {
+		bit_copybits(core_map[node_i], ent->core_map_out);
+		avail_res = _dup_avail_res(ent->avail_res);
+		slurmctld_diag_stats.avail_cache_hits++;
+		slurm_mutex_unlock(&avail_cache_mutex);
+
+		log_flag(SELECT_TYPE, "%pJ reusing result for node %s",
+			 job_ptr, node_record_table_ptr[node_i]->name);
+		_avail_res_log(avail_res, node_record_table_ptr[node_i]->name);
+		return avail_res;
+	}
+	slurmctld_diag_stats.avail_cache_misses++;
+	slurm_mutex_unlock(&avail_cache_mutex);
+
+	in_map = bit_copy(core_map[node_i]);
+	avail_res = _can_job_run_on_node(job_ptr, core_map, node_i, s_p_n,
+					 node_usage, cr_type, test_only,
+					 will_run, part_core_map, resv_exc_ptr);
+
+	slurm_mutex_lock(&avail_cache_mutex);
+	FREE_NULL_BITMAP(ent->core_map);
+	ent->core_map = in_map;
+	FREE_NULL_BITMAP(ent->part_core_map);
+	if (part_map)
+		ent->part_core_map = bit_copy(part_map);
+	if (ent->core_map_out &&
+	    (bit_size(ent->core_map_out) != bit_size(core_map[node_i])))
+		FREE_NULL_BITMAP(ent->core_map_out);
+	COPY_BITMAP(ent->core_map_out, core_map[node_i]);
+	_free_avail_res(ent->avail_res);
+	ent->avail_res = _dup_avail_res(avail_res);
+	ent->key = key;
+	ent->hash = hash;
+	ent->gen = avail_cache_gen;
+	slurm_mutex_unlock(&avail_cache_mutex);
+
+	return avail_res;
+}
+
+extern void job_test_cache_clear(void)
+{
+	slurm_mutex_lock(&avail_cache_mutex);
+	/* Skip 0, which marks unused entries */
+	if (!++avail_cache_gen)
+		avail_cache_gen++;
+	slurm_mutex_unlock(&avail_cache_mutex);
+}
+
+extern void job_test_cache_fini(void)
+{
+	slurm_mutex_lock(&avail_cache_mutex);
+	if (avail_cache) {
+		for (int i = 0; i < AVAIL_CACHE_SIZE; i++) {
+			FREE_NULL_BITMAP(avail_cache[i].core_map);
+			FREE_NULL_BITMAP(avail_cache[i].part_core_map);
+			FREE_NULL_BITMAP(avail_cache[i].core_map_out);
+			_free_avail_res(avail_cache[i].avail_res);
+		}
+		xfree(avail_cache);
+	}
+	slurm_mutex_unlock(&avail_cache_mutex);
+}
+
+/*
+ * Evaluate the nodes of node_map between i_first and i_last, storing each
+ * node's result in avail_res_array
+ */
+static void *_get_res_avail_range(void *arg)
+{
+	get_res_avail_args_t *args = arg;
+
+	for (int i = args->i_first; i <= args->i_last; i++) {
+		if (bit_test(args->node_map, i))
+			args->avail_res_array[i] =
+				_can_job_run_on_node_cached(
+					args->job_ptr, args->core_map, i,
+					args->s_p_n, args->node_usage,
+					args->cr_type, args->test_only,
+					args->will_run, args->part_core_map,
+					args->resv_exc_ptr);
+	}
+
+	return NULL;
+}
+
+/*
+ * Get number of threads to evaluate the nodes of node_map with
+ * RET 1 to evaluate the nodes in the calling thread
+ */
+static int _get_res_avail_threads(bitstr_t *node_map,
+				  resv_exc_t *resv_exc_ptr)
+{
+	int node_cnt;
+
+	if (select_threads <= 1)
+		return 1;
+
+	/*
+	 * gres_sock_list_create() records the reservation's matching GRES in
+	 * resv_exc_ptr while testing each node.
+	 */
+	if (resv_exc_ptr &&
+	    (resv_exc_ptr->gres_list_exc || resv_exc_ptr->gres_list_inc))
+		return 1;
+
+	node_cnt = bit_set_count(node_map);
+	return MAX(1, MIN(select_threads,
+			  (node_cnt / SELECT_THREAD_MIN_NODES)));
+}
+
 /*
  * Determine resource availability for pending job
  *
@@ -760,27 +1130,60 @@ static avail_res_t **_get_res_avail(job_record_t *job_ptr,
 				    bool will_run, bitstr_t **part_core_map,
 				    resv_exc_t *resv_exc_ptr)
 {
-	int i, i_first, i_last;
-	avail_res_t **avail_res_array = NULL;
-	uint32_t s_p_n = _socks_per_node(job_ptr);
+	int i_first, i_last, thread_cnt;
+	get_res_avail_args_t args = {
+		.job_ptr = job_ptr,
+		.node_map = node_map,
+		.core_map = core_map,
+		.node_usage = node_usage,
+		.cr_type = cr_type,
+		.test_only = test_only,
+		.will_run = will_run,
+		.part_core_map = part_core_map,
+		.resv_exc_ptr = resv_exc_ptr,
+		.s_p_n = _socks_per_node(job_ptr),
+	};
 
-	avail_res_array = xcalloc(node_record_count, sizeof(avail_res_t *));
+	args.avail_res_array = xcalloc(node_record_count,
+				       sizeof(avail_res_t *));
 	i_first = bit_ffs(node_map);
 	if (i_first != -1)
 		i_last = bit_fls(node_map);
 	else
 		i_last = -2;
-	for (i = i_first; i <= i_last; i++) {
-		if (bit_test(node_map, i))
-			avail_res_array[i] =
-				_can_job_run_on_node(
-					job_ptr, core_map, i,
-					s_p_n, node_usage,
-					cr_type, test_only, will_run,
-					part_core_map, resv_exc_ptr);
+
+	thread_cnt = _get_res_avail_threads(node_map, resv_exc_ptr);
+	if (thread_cnt <= 1) {
+		args.i_first = i_first;
+		args.i_last = i_last;
+		(void) _get_res_avail_range(&args);
+	} else {
+		pthread_t tids[thread_cnt];
+		get_res_avail_args_t thread_args[thread_cnt];
+		int per_thread = ROUNDUP((i_last - i_first + 1), thread_cnt);
+
+		/*
+		 * Each thread owns a distinct range of node indexes, so results
+		 * land in the same slots as a serial evaluation would use.
+		 */
+		for (int t = 0; t < thread_cnt; t++) {
+			thread_args[t] = args;
+			thread_args[t].i_first = i_first + (t * per_thread);
+			thread_args[t].i_last = MIN(i_last,
+						    (thread_args[t].i_first +
+						     per_thread - 1));
+			slurm_thread_create(NULL, &tids[t],
+					    _get_res_avail_range,
+					    &thread_args[t]);
+		}
+		for (int t = 0; t < thread_cnt; t++)
+			slurm_thread_join(tids[t]);
+
+		log_flag(SELECT_TYPE, "%pJ evaluated %d nodes with %d threads",
+			 job_ptr, bit_set_count(node_map), thread_cnt);
 	}
 
-	return avail_res_array;
+	return args.avail_res_array;
 }
 
 /* For a given job already past it's end time, guess when it will actually end.
@@ -1108,7 +1511,8 @@ static int _verify_node_state(part_res_record_t *cr_part_ptr,
 		}
 
 		gres_cores = gres_job_test(job_ptr->gres_list_req,
-					   gres_list, true,
+					   gres_list, &node_usage[i].gres_index,
+					   true,
 					   0, 0, job_ptr->job_id,
 					   node_ptr->name);
 		gres_cpus = gres_cores;
@@ -2145,7 +2549,8 @@ alloc_job:
 		return error_code;
 
 	if (!(job_ptr->bit_flags & JOB_MEM_SET) &&
-	    gres_select_util_job_mem_set(job_ptr->gres_list_req, job_res)) {
+	    gres_select_util_job_mem_set(job_ptr->gres_list_req, job_res,
+					 node_usage)) {
 		debug("%pJ memory set via GRES limit", job_ptr);
 	} else {
 		/* load memory allocated array */
@@ -3369,11 +3774,6 @@ static avail_res_t *_allocate_sc(job_record_t *job_ptr, bitstr_t *core_map,
 	 * Step 1: create and compute core-count-per-socket
 	 * arrays and total core counts
 	 */
-	if (part_core_map) {
-		tmp_core = bit_copy(part_core_map);
-		bit_and_not(tmp_core, core_map);
-	}
-
 	socket_begin = 0;
 	socket_end = cores_per_socket;
 	for (i = 0; i < sockets; i++) {
@@ -3381,12 +3781,13 @@ static avail_res_t *_allocate_sc(job_record_t *job_ptr, bitstr_t *core_map,
 
 		free_cores[i] = bit_set_count_range(core_map, socket_begin,
 						    socket_end);
-		if (!tmp_core)
+		if (!part_core_map)
 			used_cores[i] = (cores_per_socket - free_cores[i]);
 		else
-			used_cores[i] = bit_set_count_range(tmp_core,
-							    socket_begin,
-							    socket_end);
+			used_cores[i] = bit_set_count_range_not(part_core_map,
+								core_map,
+								socket_begin,
+								socket_end);
 		used_cpus = used_cores[i] * threads_per_core;
 
 		socket_begin = socket_end;
@@ -3408,7 +3809,7 @@ static avail_res_t *_allocate_sc(job_record_t *job_ptr, bitstr_t *core_map,
 			used_cores[i] += free_cores[i];
 			used_cpus = used_cores[i] * threads_per_core;
 			free_cores[i] = 0;
-		} else if (tmp_core &&
+		} else if (part_core_map &&
 			   (used_cpus >=
 			    job_ptr->part_ptr->max_cpus_per_socket)) {
 			log_flag(SELECT_TYPE, "MaxCpusPerSocket: %u, CPUs already used on socket[%d]: %u - won't use the socket.",
@@ -3423,12 +3824,11 @@ static avail_res_t *_allocate_sc(job_record_t *job_ptr, bitstr_t *core_map,
 				     threads_per_core));
 		}
 		free_core_count += free_cores[i];
-		if (tmp_core)
+		if (part_core_map)
 			used_cpu_count += used_cpus;
 	}
 	free_cpu_count = free_core_count * threads_per_core;
 	avail_res->max_cpus = free_cpu_count;
-	FREE_NULL_BITMAP(tmp_core);
 
 	/* Enforce partition CPU limit, but do not pick specific cores yet */
 	if ((job_ptr->part_ptr->max_cpus_per_node != INFINITE) &&
@@ -44,6 +44,7 @@ extern bool preempt_strict_order;
 extern bool preempt_for_licenses;
 extern int preempt_reorder_cnt;
 extern bool soft_time_limit;
+extern int select_threads;
 
 /*
  * job_test - Given a specification of scheduling requirements,
@@ -85,4 +86,13 @@ extern int job_test(job_record_t *job_ptr, bitstr_t *bitmap,
 		    resv_exc_t *resv_exc_ptr,
 		    will_run_data_t *will_run_ptr);
 
+/*
+ * Invalidate cached _can_job_run_on_node() results. Must be called when node
+ * configuration or SelectTypeParameters may have changed.
+ */
+extern void job_test_cache_clear(void);
+
+/* Release cached _can_job_run_on_node() results */
+extern void job_test_cache_fini(void);
+
 #endif /* !_CONS_TRES_JOB_TEST_H */
@@ -56,6 +56,7 @@ extern void node_data_destroy(node_use_record_t *node_usage)
 	if (node_usage) {
 		for (i = 0; i < node_record_count; i++) {
 			FREE_NULL_LIST(node_usage[i].gres_list);
+			gres_node_index_free(&node_usage[i].gres_index);
 			FREE_NULL_LIST(node_usage[i].jobs);
 		}
 		xfree(node_usage);
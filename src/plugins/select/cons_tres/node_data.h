@@ -46,6 +46,9 @@ typedef struct {
 				       * defined in in src/interfaces/gres.h.
 				       * Local data used only in state copy
 				       * to emulate future node state */
+	gres_node_index_t gres_index; /* flat view of gres_list, or of the
+				       * node's gres_list if gres_list is
+				       * NULL */
 	list_t *jobs;		      /* list of jobs running on node */
 	uint16_t node_state;	      /* see node_cr_state comments */
 } node_use_record_t;
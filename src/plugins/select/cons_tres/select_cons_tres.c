@@ -54,6 +54,7 @@
 
 #define _DEBUG 0	/* Enables module specific debugging */
 #define NODEINFO_MAGIC 0x8a5d
+#define MAX_SELECT_THREADS 64
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined.  They will get
@@ -186,6 +187,7 @@ extern void fini(void)
 	part_data_destroy_res(select_part_record);
 	select_part_record = NULL;
 	cr_fini_global_core_data();
+	job_test_cache_fini();
 }
 
 /* This is Part 1 of a 2-part procedure which can be found in
@@ -249,6 +251,18 @@ extern int select_p_node_init(void)
 	} else
 		bf_window_scale = 0;
 
+	select_threads = 1;
+	if ((tmp_ptr = xstrcasestr(slurm_conf.sched_params,
+				   "select_threads="))) {
+		select_threads = atoi(tmp_ptr + 15);
+		if ((select_threads < 1) ||
+		    (select_threads > MAX_SELECT_THREADS)) {
+			error("Invalid SchedulerParameters select_threads: %d",
+			      select_threads);
+			select_threads = 1;	/* Use default value */
+		}
+	}
+
 	if (xstrcasestr(slurm_conf.sched_params, "spec_cores_first"))
 		spec_cores_first = true;
 	else
@@ -272,6 +286,7 @@ extern int select_p_node_init(void)
 	/* initial global core data structures */
 	select_state_initializing = true;
 	cr_init_global_core_data(node_record_table_ptr, node_record_count);
+	job_test_cache_clear();
 
 	node_data_destroy(select_node_usage);
 
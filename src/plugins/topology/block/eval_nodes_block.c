@@ -488,46 +488,31 @@ next_segment:
 	if (!avail_cpu_per_node)
 		avail_cpu_per_node = xcalloc(node_record_count,
 					     sizeof(uint16_t));
-	node_weight_list = list_create(eval_nodes_topo_weight_free);
+	node_weight_list = eval_nodes_topo_weight_list(topo_eval->node_map);
 	for (i = 0;
-	     (node_ptr = next_node_bitmap(topo_eval->node_map, &i));
+	     req_nodes_bitmap && next_node_bitmap(req_nodes_bitmap, &i);
 	     i++) {
-		topo_weight_info_t nw_static;
-		if (req_nodes_bitmap && bit_test(req_nodes_bitmap, i)) {
-			eval_nodes_select_cores(topo_eval, i, min_rem_nodes);
-			(void) eval_nodes_cpus_to_use(topo_eval, i,
-						      rem_max_cpus,
-						      min_rem_nodes,
-						      &maxtasks, true);
-			if (topo_eval->avail_cpus == 0) {
-				debug2("%pJ insufficient resources on required node",
-				       job_ptr);
-				rc = ESLURM_BREAK_EVAL;
-				goto fini;
-			}
-			avail_cpu_per_node[i] = topo_eval->avail_cpus;
-			rem_nodes--;
-			min_rem_nodes--;
-			topo_eval->max_nodes--;
-			rem_cpus -= topo_eval->avail_cpus;
-			rem_max_cpus -= topo_eval->avail_cpus;
-		}
-
-		nw_static.weight = node_ptr->sched_weight;
-		nw = list_find_first(node_weight_list,
-				     eval_nodes_topo_weight_find,
-				     &nw_static);
-		if (!nw) {	/* New node weight to add */
-			nw = xmalloc(sizeof(topo_weight_info_t));
-			nw->node_bitmap = bit_alloc(node_record_count);
-			nw->weight = node_ptr->sched_weight;
-			list_append(node_weight_list, nw);
+		if (!bit_test(topo_eval->node_map, i))
+			continue;
+		eval_nodes_select_cores(topo_eval, i, min_rem_nodes);
+		(void) eval_nodes_cpus_to_use(topo_eval, i,
+					      rem_max_cpus,
+					      min_rem_nodes,
+					      &maxtasks, true);
+		if (topo_eval->avail_cpus == 0) {
+			debug2("%pJ insufficient resources on required node",
+			       job_ptr);
+			rc = ESLURM_BREAK_EVAL;
+			goto fini;
 		}
-		bit_set(nw->node_bitmap, i);
-		nw->node_cnt++;
+		avail_cpu_per_node[i] = topo_eval->avail_cpus;
+		rem_nodes--;
+		min_rem_nodes--;
+		topo_eval->max_nodes--;
+		rem_cpus -= topo_eval->avail_cpus;
+		rem_max_cpus -= topo_eval->avail_cpus;
 	}
 
-	list_sort(node_weight_list, eval_nodes_topo_weight_sort);
 	if (slurm_conf.debug_flags & DEBUG_FLAG_SELECT_TYPE)
 		(void) list_for_each(node_weight_list,
 				     eval_nodes_topo_weight_log, NULL);
@@ -39,11 +39,6 @@
 
 #include "src/common/xstring.h"
 
-typedef struct node_weight_struct {
-	bitstr_t *node_bitmap;	/* bitmap of nodes with this weight */
-	uint64_t weight;	/* priority of node for scheduling work on */
-} node_weight_type;
-
 typedef struct {
 	uint16_t *avail_cpu_per_node;
 	avail_res_t **avail_res_array;
@@ -59,66 +54,6 @@ typedef struct {
 	uint16_t *used_cpu_per_node;
 } foreach_add_nodes_lln_t;
 
-/* Find node_weight_type element from list with same weight as node config */
-static int _node_weight_find(void *x, void *key)
-{
-	node_weight_type *nwt = x;
-	node_record_t *node_ptr = key;
-	if (nwt->weight == node_ptr->sched_weight)
-		return 1;
-	return 0;
-}
-
-/* Free node_weight_type element from list */
-static void _node_weight_free(void *x)
-{
-	node_weight_type *nwt = x;
-	FREE_NULL_BITMAP(nwt->node_bitmap);
-	xfree(nwt);
-}
-
-/* Sort list of node_weight_type records in order of increasing node weight */
-static int _node_weight_sort(void *x, void *y)
-{
-	node_weight_type *nwt1 = *(node_weight_type **) x;
-	node_weight_type *nwt2 = *(node_weight_type **) y;
-	if (nwt1->weight < nwt2->weight)
-		return -1;
-	if (nwt1->weight > nwt2->weight)
-		return 1;
-	return 0;
-}
-
-/*
- * Given a bitmap of available nodes, return a list of node_weight_type
- * records in order of increasing "weight" (priority)
- */
-static list_t *_build_node_weight_list(bitstr_t *node_bitmap)
-{
-	list_t *node_list;
-	node_record_t *node_ptr;
-	node_weight_type *nwt;
-
-	xassert(node_bitmap);
-	/* Build list of node_weight_type records, one per node weight */
-	node_list = list_create(_node_weight_free);
-	for (int i = 0; (node_ptr = next_node_bitmap(node_bitmap, &i)); i++) {
-		nwt = list_find_first(node_list, _node_weight_find, node_ptr);
-		if (!nwt) {
-			nwt = xmalloc(sizeof(node_weight_type));
-			nwt->node_bitmap = bit_alloc(node_record_count);
-			nwt->weight = node_ptr->sched_weight;
-			list_append(node_list, nwt);
-		}
-		bit_set(nwt->node_bitmap, i);
-	}
-
-	/* Sort the list in order of increasing node weight */
-	list_sort(node_list, _node_weight_sort);
-
-	return node_list;
-}
-
 static void _reduce_res_cores(topology_eval_t *topo_eval,
 			      uint64_t *maxtasks,
 			      uint16_t res_cores_per_gpu,
@@ -433,7 +368,7 @@ static int _eval_nodes_busy(topology_eval_t *topo_eval)
 	bool all_done = false;
 	node_record_t *node_ptr;
 	list_t *node_weight_list = NULL;
-	node_weight_type *nwt;
+	topo_weight_info_t *nwt;
 	list_itr_t *iter;
 	uint64_t maxtasks;
 
@@ -533,7 +468,7 @@ static int _eval_nodes_busy(topology_eval_t *topo_eval)
 	 */
 	if (topo_eval->max_nodes == 0)
 		all_done = true;
-	node_weight_list = _build_node_weight_list(orig_node_map);
+	node_weight_list = eval_nodes_topo_weight_list(orig_node_map);
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
 		for (idle_test = 0; idle_test < 2; idle_test++) {
@@ -1172,7 +1107,7 @@ static int _eval_nodes_lln(topology_eval_t *topo_eval)
 	bool all_done = false;
 	node_record_t *node_ptr;
 	list_t *node_weight_list = NULL;
-	node_weight_type *nwt;
+	topo_weight_info_t *nwt;
 	list_itr_t *iter;
 	avail_res_t **avail_res_array = topo_eval->avail_res_array;
 	uint32_t min_nodes = topo_eval->min_nodes;
@@ -1273,7 +1208,7 @@ static int _eval_nodes_lln(topology_eval_t *topo_eval)
 	 */
 	if (topo_eval->max_nodes == 0)
 		all_done = true;
-	node_weight_list = _build_node_weight_list(orig_node_map);
+	node_weight_list = eval_nodes_topo_weight_list(orig_node_map);
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
 		int last_max_cpu_cnt = -1;
@@ -1386,7 +1321,7 @@ static int _eval_nodes_serial(topology_eval_t *topo_eval)
 	bool all_done = false;
 	node_record_t *node_ptr;
 	list_t *node_weight_list = NULL;
-	node_weight_type *nwt;
+	topo_weight_info_t *nwt;
 	list_itr_t *iter;
 	uint64_t maxtasks;
 
@@ -1481,7 +1416,7 @@ static int _eval_nodes_serial(topology_eval_t *topo_eval)
 
 	if (topo_eval->max_nodes == 0)
 		all_done = true;
-	node_weight_list = _build_node_weight_list(orig_node_map);
+	node_weight_list = eval_nodes_topo_weight_list(orig_node_map);
 	iter = list_iterator_create(node_weight_list);
 	while (!all_done && (nwt = list_next(iter))) {
 		for (i = i_end;
@@ -1542,7 +1477,7 @@ fini:
 static int _add_nodes_by_weight_spread(void *x, void *arg)
 {
 	foreach_add_nodes_lln_t *args = arg;
-	node_weight_type *nwt = x;
+	topo_weight_info_t *nwt = x;
 
 	for (int i = args->i_start; i <= args->i_end; i++) {
 		if (!args->avail_res_array[i] ||
@@ -1668,7 +1603,7 @@ static int _eval_nodes_spread(topology_eval_t *topo_eval)
 	}
 
 	if (topo_eval->max_nodes > 0) {
-		node_weight_list = _build_node_weight_list(orig_node_map);
+		node_weight_list = eval_nodes_topo_weight_list(orig_node_map);
 
 		args.avail_res_array = avail_res_array;
 		args.node_map = topo_eval->node_map;
@@ -2039,6 +1974,82 @@ extern int64_t eval_nodes_get_rem_max_cpus(
 
 }
 
+/*
+ * Add the nodes of one configured weight bucket to the list. They usually
+ * share the same sched_weight, so the whole bucket is added at once.
+ */
+static void _add_weight_bucket(list_t *node_weight_list, bitstr_t *node_map)
+{
+	topo_weight_info_t *nw, nw_static;
+	node_record_t *node_ptr;
+	int first = bit_ffs(node_map);
+	int i;
+
+	nw_static.weight = node_record_table_ptr[first]->sched_weight;
+	for (i = first; (node_ptr = next_node_bitmap(node_map, &i)); i++) {
+		if (node_ptr->sched_weight != nw_static.weight)
+			break;
+	}
+
+	if (!node_ptr) {
+		nw = list_find_first(node_weight_list,
+				     eval_nodes_topo_weight_find, &nw_static);
+		if (!nw) {
+			nw = xmalloc(sizeof(topo_weight_info_t));
+			nw->node_bitmap = bit_copy(node_map);
+			nw->weight = nw_static.weight;
+			list_append(node_weight_list, nw);
+		} else {
+			bit_or(nw->node_bitmap, node_map);
+		}
+		nw->node_cnt += bit_set_count(node_map);
+		return;
+	}
+
+	/* Per job flags split this bucket, group node by node */
+	for (i = first; (node_ptr = next_node_bitmap(node_map, &i)); i++) {
+		nw_static.weight = node_ptr->sched_weight;
+		nw = list_find_first(node_weight_list,
+				     eval_nodes_topo_weight_find, &nw_static);
+		if (!nw) {
+			nw = xmalloc(sizeof(topo_weight_info_t));
+			nw->node_bitmap = bit_alloc(node_record_count);
+			nw->weight = node_ptr->sched_weight;
+			list_append(node_weight_list, nw);
+		}
+		bit_set(nw->node_bitmap, i);
+		nw->node_cnt++;
+	}
+}
+
+extern list_t *eval_nodes_topo_weight_list(bitstr_t *node_map)
+{
+	list_t *node_weight_list;
+	node_weight_bucket_t *index;
+	bitstr_t *bucket_map;
+	int index_cnt;
+
+	xassert(node_map);
+
+	node_weight_list = list_create(eval_nodes_topo_weight_free);
+	index = node_conf_get_weight_index(&index_cnt);
+	bucket_map = bit_alloc(bit_size(node_map));
+
+	for (int b = 0; b < index_cnt; b++) {
+		if (!bit_overlap_any(index[b].node_bitmap, node_map))
+			continue;
+		bit_copybits(bucket_map, index[b].node_bitmap);
+		bit_and(bucket_map, node_map);
+		_add_weight_bucket(node_weight_list, bucket_map);
+	}
+	FREE_NULL_BITMAP(bucket_map);
+
+	/* Per job flags in sched_weight can reorder the buckets */
+	list_sort(node_weight_list, eval_nodes_topo_weight_sort);
+
+	return node_weight_list;
+}
+
 extern int eval_nodes_topo_weight_find(void *x, void *key)
 {
 	topo_weight_info_t *nw = x;
@@ -124,6 +124,14 @@ extern uint64_t eval_nodes_set_max_tasks(job_record_t *job_ptr,
 extern int64_t eval_nodes_get_rem_max_cpus(
 	job_details_t *details_ptr, int rem_nodes);
 
+/*
+ * Build a list of topo_weight_info_t records for the nodes in node_map, one per
+ * sched_weight, in order of increasing sched_weight. Nodes are grouped with
+ * bitmap operations on the configured weight index from
+ * node_conf_get_weight_index().
+ */
+extern list_t *eval_nodes_topo_weight_list(bitstr_t *node_map);
+
 extern int eval_nodes_topo_weight_find(void *x, void *key);
 extern int eval_nodes_topo_node_find(void *x, void *key);
 extern void eval_nodes_topo_weight_free(void *x);
@@ -73,10 +73,21 @@ typedef struct {
 	uint64_t dropped;
 	uint16_t cycle_last;
 	uint16_t cycle_max;
+	uint64_t coalesced;
 } rpc_stat_t;
 
 static rpc_stat_t *types = NULL, *users = NULL;
 
+/* Order matches slurmctld's lock_datatype_t */
+static const char *lock_names[] = {
+	"config",
+	"job",
+	"node",
+	"partition",
+	"federation",
+	"select_node",
+};
+
 struct sdiag_parameters params = {0};
 
 stats_info_response_msg_t *buf;
@@ -176,6 +187,8 @@ static int _print_stats(void)
 		       ((buf->req_time - buf->req_time_start) / 60)));
 	}
 	printf("\tLast queue length: %u\n", buf->schedule_queue_len);
+	printf("\tLast cycle arena allocations: %"PRIu64" (%"PRIu64" bytes)\n",
+	       buf->schedule_arena_alloc_cnt, buf->schedule_arena_alloc_bytes);
 
 	printf("\nMain scheduler exit:\n");
 
@@ -224,6 +237,8 @@ static int _print_stats(void)
 		       buf->bf_queue_len_sum / buf->bf_cycle_counter);
 	}
 	printf("\tLast table size: %u\n", buf->bf_table_size);
+	printf("\tLast cycle arena allocations: %"PRIu64" (%"PRIu64" bytes)\n",
+	       buf->bf_arena_alloc_cnt, buf->bf_arena_alloc_bytes);
 	if (buf->bf_cycle_counter > 0) {
 		printf("\tMean table size: %u\n",
 		       buf->bf_table_size_sum / buf->bf_cycle_counter);
@@ -235,9 +250,49 @@ static int _print_stats(void)
 		       buf->bf_exit[i]);
 	}
 
+	printf("\nNode selection cache:\n");
+	printf("\tHits:   %"PRIu64"\n", buf->avail_cache_hits);
+	printf("\tMisses: %"PRIu64"\n", buf->avail_cache_misses);
+
+	printf("\nDBD Agent statistics (since slurmctld start):\n");
+	printf("\tRPCs sent: %u\n", buf->dbd_agent_batch_cnt);
+	printf("\tMessages sent: %"PRIu64"\n", buf->dbd_agent_msg_cnt);
+	printf("\tMax batch size: %u\n", buf->dbd_agent_batch_max);
+	if (buf->dbd_agent_batch_cnt > 0) {
+		printf("\tMean batch size: %"PRIu64"\n",
+		       buf->dbd_agent_msg_cnt / buf->dbd_agent_batch_cnt);
+		printf("\tMean RPC time: %"PRIu64" microseconds\n",
+		       buf->dbd_agent_usec / buf->dbd_agent_batch_cnt);
+	}
+	printf("\tMax RPC time: %"PRIu64" microseconds\n",
+	       buf->dbd_agent_usec_max);
+	if (buf->dbd_agent_usec > 0) {
+		printf("\tMessages per second: %"PRIu64"\n",
+		       (buf->dbd_agent_msg_cnt * USEC_IN_SEC) /
+		       buf->dbd_agent_usec);
+	}
+
 	printf("\nLatency for 1000 calls to gettimeofday(): %d microseconds\n",
 	       buf->gettimeofday_latency);
 
+	if (buf->lock_stats_cnt) {
+		printf("\nLock wait statistics (microseconds)\n");
+		for (i = 0; i < buf->lock_stats_cnt; i++) {
+			int type = i / 2;
+			uint64_t ave_time = 0;
+
+			if (buf->lock_wait_cnt[i])
+				ave_time = buf->lock_wait_time[i] /
+					   buf->lock_wait_cnt[i];
+			printf("\t%-12s %-5s waits:%-8"PRIu64" ave_time:%-8"PRIu64" max_time:%-8"PRIu64" total_time:%"PRIu64"\n",
+			       (type < ARRAY_SIZE(lock_names)) ?
+			       lock_names[type] : "unknown",
+			       (i % 2) ? "write" : "read",
+			       buf->lock_wait_cnt[i], ave_time,
+			       buf->lock_wait_max[i], buf->lock_wait_time[i]);
+		}
+	}
+
 	printf("\nRemote Procedure Call statistics by message type\n");
 	for (i = 0; i < buf->rpc_type_size; i++) {
 		if (!buf->rpc_queue_enabled)
@@ -246,12 +301,12 @@ static int _print_stats(void)
 			       types[i].count, types[i].average_time,
 			       types[i].time);
 		else
-			printf("\t%-40s(%5u) count:%-6u ave_time:%-6"PRIu64" total_time:%-12"PRIu64" queued:%-6u cycle_last:%-6u cycle_max:%-6u dropped:%"PRIu64"\n",
+			printf("\t%-40s(%5u) count:%-6u ave_time:%-6"PRIu64" total_time:%-12"PRIu64" queued:%-6u cycle_last:%-6u cycle_max:%-6u dropped:%-6"PRIu64" coalesced:%"PRIu64"\n",
 			       rpc_num2string(types[i].id), types[i].id,
 			       types[i].count, types[i].average_time,
 			       types[i].time, types[i].queued,
 			       types[i].cycle_last, types[i].cycle_max,
-			       types[i].dropped);
+			       types[i].dropped, types[i].coalesced);
 	}
 	if (!buf->rpc_type_size)
 		printf("\tNo RPCs recorded yet.\n");
@@ -361,6 +416,9 @@ static void _sort_rpc(void)
 			types[i].dropped = buf->rpc_type_dropped[i];
 			types[i].cycle_last = buf->rpc_type_cycle_last[i];
 			types[i].cycle_max = buf->rpc_type_cycle_max[i];
+			if (buf->rpc_type_coalesced)
+				types[i].coalesced =
+					buf->rpc_type_coalesced[i];
 		}
 	}
 
@@ -2857,6 +2857,7 @@ static int _qos_job_time_out(job_record_t *job_ptr,
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		info("%pJ timed out, the job is at or exceeds QOS %s's group max tres(%s) minutes of %"PRIu64" with %"PRIu64"",
 		     job_ptr, qos_ptr->name,
 		     assoc_mgr_tres_name_array[tres_pos],
@@ -2887,6 +2888,7 @@ static int _qos_job_time_out(job_record_t *job_ptr,
 
 		if (wall_mins >= qos_ptr->grp_wall) {
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			info("%pJ timed out, the job is at or exceeds QOS %s's group wall limit of %u with %u",
 			     job_ptr, qos_ptr->name,
 			     qos_ptr->grp_wall, wall_mins);
@@ -2909,6 +2911,7 @@ static int _qos_job_time_out(job_record_t *job_ptr,
 		break;
 	case TRES_USAGE_REQ_EXCEEDS_LIMIT:
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		info("%pJ timed out, the job is at or exceeds QOS %s's max tres(%s) minutes of %"PRIu64" with %"PRIu64,
 		     job_ptr, qos_ptr->name,
 		     assoc_mgr_tres_name_array[tres_pos],
@@ -4125,6 +4128,17 @@ extern bool acct_policy_job_runnable_post_select(job_record_t *job_ptr,
 
 	assoc_ptr = job_ptr->assoc_ptr;
 	while (assoc_ptr) {
+		/*
+		 * Most associations in a deep hierarchy have no TRES limits,
+		 * none of the checks below can hold the job there.
+		 */
+		if (assoc_ptr->usage->grp_tres_unlimited &&
+		    (parent || assoc_ptr->usage->max_tres_unlimited)) {
+			assoc_ptr = assoc_ptr->usage->parent_assoc_ptr;
+			parent = 1;
+			continue;
+		}
+
 		for (i = 0; i < slurmctld_tres_cnt; i++) {
 			tres_usage_mins[i] =
 				(uint64_t)(assoc_ptr->usage->usage_tres_raw[i]
@@ -4596,6 +4610,7 @@ extern int acct_policy_update_pending_job(job_record_t *job_ptr)
 
 	if (update_accounting) {
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		debug("limits changed for %pJ: updating accounting", job_ptr);
 		/* Update job record in accounting to reflect changes */
 		jobacct_storage_g_job_start(acct_db_conn, job_ptr);
@@ -4692,6 +4707,7 @@ extern bool acct_policy_job_time_out(job_record_t *job_ptr)
 		switch (tres_usage) {
 		case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			info("%pJ timed out, the job is at or exceeds assoc %u(%s/%s/%s) group max tres(%s) minutes of %"PRIu64" with %"PRIu64,
 			     job_ptr, assoc->id, assoc->acct,
 			     assoc->user, assoc->partition,
@@ -4743,6 +4759,7 @@ extern bool acct_policy_job_time_out(job_record_t *job_ptr)
 			break;
 		case TRES_USAGE_REQ_EXCEEDS_LIMIT:
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			info("%pJ timed out, the job is at or exceeds assoc %u(%s/%s/%s) max tres(%s) minutes of %"PRIu64" with %"PRIu64,
 			     job_ptr, assoc->id, assoc->acct,
 			     assoc->user, assoc->partition,
@@ -744,6 +744,13 @@ int main(int argc, char **argv)
 	if (original && daemonize) {
 		if (xdaemon())
 			error("daemon(): %m");
+		/* The async log writer thread does not survive fork() */
+		if (xstrcasestr(slurm_conf.slurmctld_params,
+				"enable_async_log")) {
+			lock_slurmctld(config_write_lock);
+			update_logging();
+			unlock_slurmctld(config_write_lock);
+		}
 		sched_debug("slurmctld starting");
 	}
 
@@ -3660,6 +3667,9 @@ void update_log_levels(int req_slurmctld_debug, int req_syslog_debug)
 	else
 		log_opts.syslog_level = LOG_LEVEL_FATAL;
 
+	if (xstrcasestr(slurm_conf.slurmctld_params, "enable_async_log"))
+		log_opts.async = true;
+
 	log_alter(log_opts, LOG_DAEMON, slurm_conf.slurmctld_logfile);
 
 	debug("slurmctld log levels: stderr=%s logfile=%s syslog=%s",
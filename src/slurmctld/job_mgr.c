@@ -73,10 +73,12 @@
 #include "src/common/sluid.h"
 #include "src/common/slurm_protocol_pack.h"
 #include "src/common/state_save.h"
+#include "src/common/threadpool.h"
 #include "src/common/timers.h"
 #include "src/common/track_script.h"
 #include "src/common/tres_bind.h"
 #include "src/common/tres_frequency.h"
+#include "src/common/xahash.h"
 #include "src/common/xassert.h"
 #include "src/common/xstring.h"
 
@@ -123,6 +125,7 @@
 #define SLURM_CREATE_JOB_FLAG_NO_ALLOCATE_0 0
 #define TOP_PRIORITY 0xffff0000	/* large, but leave headroom for higher */
 #define PURGE_OLD_JOB_IN_SEC 2592000 /* 30 days in seconds */
+#define JOB_PACK_CACHE_CNT 4	/* protocol version/detail pairs cached */
 
 #define JOB_HASH_INX(_job_id)	(_job_id % hash_table_size)
 #define JOB_ARRAY_HASH_INX(_job_id, _task_id)		\
@@ -131,6 +134,26 @@
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define JOB_STATE_VERSION     "PROTOCOL_VERSION"
 
+/*
+ * Job records changed since job_state was last written are appended to
+ * job_state.journal instead of rewriting job_state on every save. The journal
+ * header holds the JOB_STATE_VERSION, protocol version, the time stamp of the
+ * job_state file it applies to and the offset of each job record in that
+ * file (so the records can be unpacked in parallel). Each appended segment is:
+ *	uint32_t segment size (bytes after this field)
+ *	time_t save time
+ *	uint32_t job_id_sequence
+ *	time_t bf_when_last_cycle
+ *	uint32_t record count
+ *	records of uint32_t job_id + packmem() job record (empty when purged)
+ */
+#define JOB_STATE_JOURNAL "job_state.journal"
+/* Rewrite job_state once the journal has this many segments */
+#define JOB_JOURNAL_MAX_SEGMENTS 720
+/* Threads used to unpack job_state and minimum job records for each */
+#define JOB_STATE_UNPACK_THREADS 8
+#define JOB_STATE_UNPACK_MIN_RECS 1024
+
 typedef enum {
 	JOB_HASH_JOB,
 	JOB_HASH_SLUID,
@@ -146,10 +169,49 @@ typedef struct {
 	char **err_msg;
 } resp_array_struct_t;
 
+/*
+ * Packed job records kept between job info requests, one cache per protocol
+ * version and detail level. A cache is dropped when the node, partition or
+ * configuration tables change. Job changes are tracked per record: a packed
+ * record is reused until the job's last_update reaches the time it was packed,
+ * so refreshing a cache only packs the jobs changed since the last refresh.
+ */
+typedef struct {
+	job_record_t *job_ptr;
+	uint32_t job_id;	/* job_id when packed, detects a reused job_ptr */
+	time_t pack_time;	/* when the record was packed */
+	uint32_t offset;	/* offset of packed record in cache buffer */
+	uint32_t size;		/* 0 if the record is packed per request */
+} job_pack_frag_t;
+
+typedef struct {
+	buf_t *buffer;		/* packed job records */
+	time_t build_time;	/* time of the last refresh */
+	time_t expire_time;	/* when a packed expected start time is stale */
+	job_pack_frag_t *frags;	/* one per job, in job_list order */
+	job_pack_frag_t **frags_by_job;	/* frags sorted by job_ptr */
+	uint32_t frag_cnt;
+	uint32_t live_size;	/* bytes of buffer still referenced by frags */
+	time_t last_conf_update;
+	time_t last_job_update;	/* as of the last refresh */
+	time_t last_node_update;
+	time_t last_part_update;
+	uint16_t protocol_version;
+	uint16_t show_flags;	/* only SHOW_DETAIL changes pack_job() */
+} job_pack_cache_t;
+
+typedef struct {
+	job_pack_cache_t *cache;
+	buf_t *old_buffer;	/* set if current records are copied out */
+	job_pack_frag_t **old_frags_by_job;
+	uint32_t old_frag_cnt;
+} job_pack_refresh_t;
+
 typedef struct {
 	buf_t *buffer;
 	uint32_t  filter_uid;
 	bool has_qos_lock;
+	job_pack_cache_t *cache;
 	job_record_t *het_leader;
 	uint32_t  jobs_packed;
 	uint16_t  protocol_version;
@@ -332,6 +394,62 @@ typedef struct {
 	int cnt;
 } foreach_hold_by_id_t;
 
+typedef struct {
+	uint32_t job_id;
+	uint32_t offset;	/* offset of packed record in state buffer */
+	uint32_t size;
+	uint64_t hash;		/* hash of packed record */
+} job_state_rec_t;
+
+typedef struct {
+	buf_t *buffer;
+	job_state_rec_t *recs;
+	uint32_t rec_cnt;
+} foreach_dump_job_state_t;
+
+/* Last saved record of a job, held in job_journal_hash */
+typedef struct {
+	uint32_t job_id;
+	uint32_t generation;	/* job_journal_generation when last seen */
+	uint64_t hash;
+} job_journal_entry_t;
+
+/* Latest journal record of a job while recovering state */
+typedef struct {
+	uint32_t job_id;
+	uint32_t order;		/* position of record in journal */
+	char *data;		/* NULL if job was purged */
+	uint32_t size;
+} job_journal_rec_t;
+
+typedef struct {
+	buf_t *buffer;		/* mmap()ed journal */
+	uint16_t protocol_version;
+	xahash_table_t *recs;	/* job_journal_rec_t by job_id */
+	uint32_t rec_cnt;
+	uint32_t segments;
+	uint32_t job_id_sequence;
+	time_t bf_when_last_cycle;
+	uint32_t superseded;	/* job_state records replaced by journal */
+	uint32_t *offsets;	/* offset of each job_state record */
+	uint32_t offset_cnt;
+} job_journal_t;
+
+typedef struct {
+	job_journal_rec_t *recs;
+	uint32_t rec_cnt;
+} foreach_journal_job_t;
+
+typedef struct {
+	buf_t *buffer;		/* mmap()ed job_state */
+	uint16_t protocol_version;
+	uint32_t *offsets;	/* offset of each job record in buffer */
+	uint32_t rec_cnt;
+	uint32_t start;		/* first record for this thread */
+	uint32_t end;		/* last record for this thread + 1 */
+	job_record_t **jobs;	/* unpacked records, NULL if unpack failed */
+} unpack_job_state_args_t;
+
 /* Global variables */
 list_t *job_list = NULL;	/* job_record list */
 time_t last_job_update;		/* time of last update to job records */
@@ -346,16 +464,23 @@ static uint32_t lowest_prio  = TOP_PRIORITY;
 static int      hash_table_size = 0;
 static int      job_count = 0;		/* job's in the system */
 static uint32_t job_id_sequence = 0;	/* first job_id to assign new job */
-static struct   job_record **job_hash = NULL;
-static struct job_record **job_hash_sluid = NULL;
+static xahash_table_t *job_hash = NULL; /* job_record_t * by job_id */
+static xahash_table_t *job_hash_sluid = NULL; /* job_record_t * by sluid */
 static struct   job_record **job_array_hash_j = NULL;
 static struct   job_record **job_array_hash_t = NULL;
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
+static xahash_table_t *job_journal_hash = NULL; /* job_journal_entry_t */
+static uint32_t job_journal_generation = 0;
+static uint32_t job_journal_segments = 0;
+static uint64_t job_journal_bytes = 0;
+static uint64_t job_state_bytes = 0;
 static uint32_t max_array_size = NO_VAL;
 static bitstr_t *requeue_exit = NULL;
 static bitstr_t *requeue_exit_hold = NULL;
 static bool     validate_cfgd_licenses = true;
+static job_pack_cache_t job_pack_cache[JOB_PACK_CACHE_CNT];
+static pthread_rwlock_t job_pack_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
 
 /* Local functions */
 static void _signal_pending_job_array_tasks(job_record_t *job_ptr,
@@ -396,6 +521,11 @@ static bitstr_t *_make_requeue_array(char *conf_buf);
 static uint32_t _max_switch_wait(uint32_t input_wait);
 static void _move_to_purge_jobs_list(void *job_entry);
 static time_t _get_last_job_state_write_time(void);
+static xahash_hash_t _job_hash_func(const void *key, const size_t key_bytes,
+				    void *state);
+static int _load_job_state(buf_t *buffer, uint16_t protocol_version,
+			   job_journal_t *journal);
+static int _recover_job_state(job_record_t *job_ptr, job_journal_t *journal);
 static void _pack_default_job_details(job_record_t *job_ptr, buf_t *buffer,
 				      uint16_t protocol_version);
 static void _pack_pending_job_details(job_details_t *detail_ptr, buf_t *buffer,
@@ -803,6 +933,7 @@ static int _add_job_record(job_record_t *job_ptr, int num_jobs)
 	}
 	job_count += num_jobs;
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	list_append(job_list, job_ptr);
 
 	return SLURM_SUCCESS;
@@ -1045,6 +1176,276 @@ static int _get_qos_info(char *qos_req, uint32_t qos_id, list_t **qos_plist,
 
 	return rc;
 }
+static void _check_job_state_mtime(void)
+{
+	static time_t last_mtime = (time_t) 0;
+	char *reg_file;
+	struct stat stat_buf;
+
+	reg_file = xstrdup_printf("%s/job_state",
+	                          slurm_conf.state_save_location);
+
+	if (stat(reg_file, &stat_buf) == 0) {
+		int delta_t = difftime(stat_buf.st_mtime, last_mtime);
+		if (delta_t < -10) {
+			error("The modification time of %s moved backwards "
+			      "by %d seconds",
+			      reg_file, (0-delta_t));
+			error("The clock of the file system and this computer "
+			      "appear to not be synchronized");
+			/* It could be safest to exit here. We likely mounted
+			 * a different file system with the state save files */
+		}
+		last_mtime = time(NULL);
+	}
+
+	xfree(reg_file);
+}
+
+static int _dump_job_state_rec(void *object, void *arg)
+{
+	job_record_t *job_ptr = object;
+	foreach_dump_job_state_t *args = arg;
+	uint32_t offset = get_buf_offset(args->buffer);
+
+	(void) job_mgr_dump_job_state(job_ptr, args->buffer);
+
+	/* "unlinked" jobs are not packed */
+	if (get_buf_offset(args->buffer) == offset)
+		return 0;
+
+	args->recs[args->rec_cnt++] = (job_state_rec_t) {
+		.job_id = job_ptr->job_id,
+		.offset = offset,
+		.size = (get_buf_offset(args->buffer) - offset),
+	};
+
+	return 0;
+}
+
+/* FNV-1a hash of a packed job record */
+static uint64_t _hash_job_state_rec(buf_t *buffer, job_state_rec_t *rec)
+{
+	const uint8_t *data = (uint8_t *) get_buf_data(buffer) + rec->offset;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	for (uint32_t i = 0; i < rec->size; i++) {
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+static bool _job_journal_match(void *entry, const void *key,
+			       const size_t key_bytes, void *state)
+{
+	/* job_id is the first member of all journal entries */
+	return (*(uint32_t *) entry == *(const uint32_t *) key);
+}
+
+static void _on_insert_job_journal(void *entry, const void *key,
+				   const size_t key_bytes, void *state)
+{
+	job_journal_entry_t *journal_entry = entry;
+
+	journal_entry->job_id = *(const uint32_t *) key;
+	/* Never matches job_journal_generation to flag new entries */
+	journal_entry->generation = 0;
+	journal_entry->hash = 0;
+}
+
+static void _next_job_journal_generation(void)
+{
+	if (!++job_journal_generation)
+		job_journal_generation++;
+}
+
+static xahash_foreach_control_t _find_purged_job(void *entry, void *state,
+						 void *arg)
+{
+	job_journal_entry_t *journal_entry = entry;
+	foreach_dump_job_state_t *purged = arg;
+
+	if (journal_entry->generation == job_journal_generation)
+		return XAHASH_FOREACH_CONT;
+
+	xrecalloc(purged->recs, (purged->rec_cnt + 1), sizeof(*purged->recs));
+	purged->recs[purged->rec_cnt++].job_id = journal_entry->job_id;
+
+	return XAHASH_FOREACH_CONT;
+}
+
+/*
+ * Build journal segment holding job records that changed since the last save
+ * and the job ids of purged jobs.
+ */
+static buf_t *_build_job_journal_segment(buf_t *buffer,
+					 foreach_dump_job_state_t *args,
+					 time_t now, uint32_t job_id_seq,
+					 time_t bf_when_last_cycle)
+{
+	buf_t *segment = init_buf(BUF_SIZE);
+	foreach_dump_job_state_t purged = { 0 };
+	uint32_t cnt_offset, end_offset, rec_cnt = 0;
+
+	_next_job_journal_generation();
+
+	pack32(0, segment); /* segment size is set below */
+	pack_time(now, segment);
+	pack32(job_id_seq, segment);
+	pack_time(bf_when_last_cycle, segment);
+	cnt_offset = get_buf_offset(segment);
+	pack32(0, segment); /* record count is set below */
+
+	for (uint32_t i = 0; i < args->rec_cnt; i++) {
+		job_state_rec_t *rec = &args->recs[i];
+		job_journal_entry_t *entry =
+			xahash_insert_entry(job_journal_hash, &rec->job_id,
+					    sizeof(rec->job_id));
+
+		if (entry->generation && (entry->hash == rec->hash)) {
+			entry->generation = job_journal_generation;
+			continue;
+		}
+
+		entry->generation = job_journal_generation;
+		entry->hash = rec->hash;
+
+		pack32(rec->job_id, segment);
+		packmem(get_buf_data(buffer) + rec->offset, rec->size,
+			segment);
+		rec_cnt++;
+	}
+
+	(void) xahash_foreach_entry(job_journal_hash, _find_purged_job,
+				    &purged);
+	for (uint32_t i = 0; i < purged.rec_cnt; i++) {
+		uint32_t job_id = purged.recs[i].job_id;
+
+		(void) xahash_free_entry(job_journal_hash, &job_id,
+					 sizeof(job_id));
+		pack32(job_id, segment);
+		packmem(NULL, 0, segment);
+		rec_cnt++;
+	}
+	xfree(purged.recs);
+
+	end_offset = get_buf_offset(segment);
+	set_buf_offset(segment, cnt_offset);
+	pack32(rec_cnt, segment);
+	set_buf_offset(segment, 0);
+	pack32((end_offset - sizeof(uint32_t)), segment);
+	set_buf_offset(segment, end_offset);
+
+	return segment;
+}
+
+/*
+ * Write all job records to job_state and start a new journal for it
+ */
+static int _compact_job_state(buf_t *buffer, foreach_dump_job_state_t *args,
+			      time_t now, uint32_t *high_buffer_size)
+{
+	buf_t *header;
+	uint32_t *offsets;
+	int rc;
+
+	FREE_NULL_XAHASH_TABLE(job_journal_hash);
+
+	_check_job_state_mtime();
+
+	if ((rc = save_buf_to_state("job_state", buffer, high_buffer_size)))
+		return rc;
+
+	last_file_write_time = now;
+	job_state_bytes = get_buf_offset(buffer);
+
+	/* Any older journal no longer matches the job_state time stamp */
+	header = init_buf(BUF_SIZE);
+	packstr(JOB_STATE_VERSION, header);
+	pack16(SLURM_PROTOCOL_VERSION, header);
+	pack_time(now, header);
+	offsets = xcalloc(MAX(args->rec_cnt, 1), sizeof(*offsets));
+	for (uint32_t i = 0; i < args->rec_cnt; i++)
+		offsets[i] = args->recs[i].offset;
+	pack32_array(offsets, args->rec_cnt, header);
+	xfree(offsets);
+	rc = save_buf_to_state(JOB_STATE_JOURNAL, header, NULL);
+	job_journal_bytes = get_buf_offset(header);
+	job_journal_segments = 0;
+	FREE_NULL_BUFFER(header);
+
+	if (rc) {
+		error("Unable to start job state journal, job_state will be rewritten on every save");
+		return SLURM_SUCCESS;
+	}
+
+	job_journal_hash = xahash_new_table(_job_hash_func, _job_journal_match,
+					    _on_insert_job_journal, NULL, 0,
+					    sizeof(job_journal_entry_t), 0);
+	_next_job_journal_generation();
+
+	for (uint32_t i = 0; i < args->rec_cnt; i++) {
+		job_state_rec_t *rec = &args->recs[i];
+		job_journal_entry_t *entry =
+			xahash_insert_entry(job_journal_hash, &rec->job_id,
+					    sizeof(rec->job_id));
+
+		entry->generation = job_journal_generation;
+		entry->hash = rec->hash;
+	}
+
+	debug("%s: wrote %u jobs to job_state", __func__, args->rec_cnt);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Append changed job records to the journal or rewrite job_state once the
+ * journal grows too large to replay quickly.
+ */
+static int _save_job_state(buf_t *buffer, foreach_dump_job_state_t *args,
+			   time_t now, uint32_t job_id_seq,
+			   time_t bf_when_last_cycle,
+			   uint32_t *high_buffer_size)
+{
+	buf_t *segment;
+	int rc;
+
+	for (uint32_t i = 0; i < args->rec_cnt; i++)
+		args->recs[i].hash = _hash_job_state_rec(buffer,
+							 &args->recs[i]);
+
+	/*
+	 * Rewrite job_state on the first save, when taking over as primary and
+	 * after the split brain check in dump_all_job_state() found a time
+	 * stamp it did not write.
+	 */
+	if (!job_journal_hash || !last_file_write_time ||
+	    (job_journal_segments >= JOB_JOURNAL_MAX_SEGMENTS))
+		return _compact_job_state(buffer, args, now, high_buffer_size);
+
+	segment = _build_job_journal_segment(buffer, args, now, job_id_seq,
+					     bf_when_last_cycle);
+
+	if ((job_journal_bytes + get_buf_offset(segment)) >
+	    (job_state_bytes / 2)) {
+		rc = _compact_job_state(buffer, args, now, high_buffer_size);
+	} else if ((rc = append_buf_to_state(JOB_STATE_JOURNAL, segment))) {
+		/* journal may now end in a partial segment */
+		error("Unable to append to job state journal, rewriting job_state");
+		rc = _compact_job_state(buffer, args, now, high_buffer_size);
+	} else {
+		job_journal_segments++;
+		job_journal_bytes += get_buf_offset(segment);
+		debug2("%s: appended %u bytes to job state journal",
+		       __func__, get_buf_offset(segment));
+	}
+
+	FREE_NULL_BUFFER(segment);
+	return rc;
+}
+
 /*
  * dump_all_job_state - save the state of all jobs to file for checkpoint
  *	Changes here should be reflected in load_last_job_id() and
@@ -1056,16 +1457,15 @@ int dump_all_job_state(void)
 	/* Save high-water mark to avoid buffer growth with copies */
 	static uint32_t high_buffer_size = (1024 * 1024);
 	int error_code = SLURM_SUCCESS;
-	char *reg_file;
-	struct stat stat_buf;
 	/* Locks: Read config and job */
 	slurmctld_lock_t job_read_lock =
 		{ READ_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 	buf_t *buffer = init_buf(high_buffer_size);
 	time_t now = time(NULL);
-	time_t last_state_file_time;
+	time_t last_state_file_time, bf_when_last_cycle;
 	static time_t last_job_state_size_check = 0;
-	uint32_t jobs_start, jobs_end, jobs_count;
+	uint32_t jobs_start, jobs_end, jobs_count, job_id_seq;
+	foreach_dump_job_state_t dump_args = { .buffer = buffer };
 	DEF_TIMERS;
 
 	START_TIMER;
@@ -1086,6 +1486,11 @@ int dump_all_job_state(void)
 			      "Shutting down this daemon to avoid inconsistent "
 			      "state due to split brain.");
 		}
+		/*
+		 * The journal no longer belongs to the job_state file on disk,
+		 * so rewrite job_state before appending to it again.
+		 */
+		FREE_NULL_XAHASH_TABLE(job_journal_hash);
 	}
 
 	/* write header: version, time */
@@ -1098,18 +1503,23 @@ int dump_all_job_state(void)
 	 * This is needed so that the job id remains persistent even after
 	 * slurmctld is restarted.
 	 */
-	pack32( job_id_sequence, buffer);
+	job_id_seq = job_id_sequence;
+	pack32(job_id_seq, buffer);
 
 	debug3("Writing job id %u to header record of job_state file",
-	       job_id_sequence);
+	       job_id_seq);
 
 	/* write individual job records */
 	lock_slurmctld(job_read_lock);
 
-	pack_time(slurmctld_diag_stats.bf_when_last_cycle, buffer);
+	bf_when_last_cycle = slurmctld_diag_stats.bf_when_last_cycle;
+	pack_time(bf_when_last_cycle, buffer);
+
+	dump_args.recs = xcalloc(MAX(list_count(job_list), 1),
+				 sizeof(*dump_args.recs));
 
 	jobs_start = get_buf_offset(buffer);
-	list_for_each_ro(job_list, job_mgr_dump_job_state, buffer);
+	list_for_each_ro(job_list, _dump_job_state_rec, &dump_args);
 	jobs_end = get_buf_offset(buffer);
 	if ((difftime(now, last_job_state_size_check) > 60) &&
 	    (jobs_count = list_count(job_list))) {
@@ -1134,29 +1544,10 @@ int dump_all_job_state(void)
 
 	unlock_slurmctld(job_read_lock);
 
-	reg_file = xstrdup_printf("%s/job_state",
-	                          slurm_conf.state_save_location);
+	error_code = _save_job_state(buffer, &dump_args, now, job_id_seq,
+				     bf_when_last_cycle, &high_buffer_size);
 
-	if (stat(reg_file, &stat_buf) == 0) {
-		static time_t last_mtime = (time_t) 0;
-		int delta_t = difftime(stat_buf.st_mtime, last_mtime);
-		if (delta_t < -10) {
-			error("The modification time of %s moved backwards "
-			      "by %d seconds",
-			      reg_file, (0-delta_t));
-			error("The clock of the file system and this computer "
-			      "appear to not be synchronized");
-			/* It could be safest to exit here. We likely mounted
-			 * a different file system with the state save files */
-		}
-		last_mtime = time(NULL);
-	}
-
-	error_code = save_buf_to_state("job_state", buffer, &high_buffer_size);
-	if (!error_code)
-		last_file_write_time = now;
-
-	xfree(reg_file);
+	xfree(dump_args.recs);
 	FREE_NULL_BUFFER(buffer);
 	END_TIMER2(__func__);
 	return error_code;
@@ -1244,6 +1635,7 @@ extern void set_job_failed_assoc_qos_ptr(job_record_t *job_ptr)
 			job_ptr->state_reason = WAIT_NO_REASON;
 			xfree(job_ptr->state_desc);
 			last_job_update = time(NULL);
+			job_ptr->last_update = time(NULL);
 		}
 	}
 
@@ -1273,6 +1665,7 @@ extern void set_job_failed_assoc_qos_ptr(job_record_t *job_ptr)
 			job_ptr->state_reason = WAIT_NO_REASON;
 			xfree(job_ptr->state_desc);
 			last_job_update = time(NULL);
+			job_ptr->last_update = time(NULL);
 		}
 	}
 }
@@ -1335,6 +1728,310 @@ unpack_error:
 	return buf_time;
 }
 
+static int _read_job_journal_segment(buf_t *segment, job_journal_t *journal)
+{
+	time_t save_time;
+	uint32_t rec_cnt;
+
+	safe_unpack_time(&save_time, segment);
+	safe_unpack32(&journal->job_id_sequence, segment);
+	safe_unpack_time(&journal->bf_when_last_cycle, segment);
+	safe_unpack32(&rec_cnt, segment);
+
+	for (uint32_t i = 0; i < rec_cnt; i++) {
+		job_journal_rec_t *rec;
+		uint32_t job_id, size;
+		char *data;
+
+		safe_unpack32(&job_id, segment);
+		safe_unpackmem_ptr(&data, &size, segment);
+
+		/* Later records replace earlier records of the same job */
+		rec = xahash_insert_entry(journal->recs, &job_id,
+					  sizeof(job_id));
+		*rec = (job_journal_rec_t) {
+			.job_id = job_id,
+			.order = journal->rec_cnt++,
+			.data = data,
+			.size = size,
+		};
+	}
+
+	debug3("%s: read %u records saved at %ld",
+	       __func__, rec_cnt, (long) save_time);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	return SLURM_ERROR;
+}
+
+static void _free_job_journal(job_journal_t *journal)
+{
+	xfree(journal->offsets);
+	journal->offset_cnt = 0;
+	FREE_NULL_XAHASH_TABLE(journal->recs);
+	FREE_NULL_BUFFER(journal->buffer);
+}
+
+/*
+ * Read the job state journal written for the job_state file saved at
+ * checkpoint_time. journal->buffer is left NULL if there is no such journal.
+ * RET SLURM_SUCCESS or SLURM_ERROR if the journal is corrupt
+ */
+static int _read_job_journal(time_t checkpoint_time, job_journal_t *journal)
+{
+	char *state_file = NULL, *ver_str = NULL;
+	time_t journal_time = 0;
+	buf_t *buffer;
+
+	*journal = (job_journal_t) {
+		.protocol_version = NO_VAL16,
+	};
+
+	if (!(buffer = state_save_open(JOB_STATE_JOURNAL, &state_file))) {
+		debug2("No job state journal (%s) to recover", state_file);
+		xfree(state_file);
+		return SLURM_SUCCESS;
+	}
+	journal->buffer = buffer;
+
+	safe_unpackstr(&ver_str, buffer);
+	if (ver_str && !xstrcmp(ver_str, JOB_STATE_VERSION))
+		safe_unpack16(&journal->protocol_version, buffer);
+	xfree(ver_str);
+	safe_unpack_time(&journal_time, buffer);
+	if (journal->protocol_version != NO_VAL16)
+		safe_unpack32_array(&journal->offsets, &journal->offset_cnt,
+				    buffer);
+
+	if ((journal->protocol_version == NO_VAL16) ||
+	    (journal_time != checkpoint_time)) {
+		/* job_state was rewritten after this journal was started */
+		info("Ignoring job state journal (%s) of a previous job state file",
+		     state_file);
+		_free_job_journal(journal);
+		xfree(state_file);
+		return SLURM_SUCCESS;
+	}
+
+	journal->recs = xahash_new_table(_job_hash_func, _job_journal_match,
+					 NULL, NULL, 0,
+					 sizeof(job_journal_rec_t), 0);
+
+	while (remaining_buf(buffer) > 0) {
+		buf_t *segment;
+		uint32_t size;
+		int rc;
+
+		if (unpack32(&size, buffer) || (size > remaining_buf(buffer))) {
+			/* slurmctld stopped while appending a segment */
+			error("Ignoring incomplete segment at end of job state journal (%s)",
+			      state_file);
+			break;
+		}
+
+		segment = create_shadow_buf((get_buf_data(buffer) +
+					     get_buf_offset(buffer)), size);
+		set_buf_offset(buffer, (get_buf_offset(buffer) + size));
+
+		rc = _read_job_journal_segment(segment, journal);
+		FREE_NULL_BUFFER(segment);
+		if (rc)
+			goto unpack_error;
+		journal->segments++;
+	}
+
+	debug("Read %u job records in %u segments from job state journal (%s)",
+	      journal->rec_cnt, journal->segments, state_file);
+	xfree(state_file);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("Invalid job state journal (%s)", state_file);
+	xfree(ver_str);
+	xfree(state_file);
+	return SLURM_ERROR;
+}
+
+static xahash_foreach_control_t _find_journal_job(void *entry, void *state,
+						  void *arg)
+{
+	job_journal_rec_t *rec = entry;
+	foreach_journal_job_t *args = arg;
+
+	/* purged jobs have no record to load */
+	if (rec->data)
+		args->recs[args->rec_cnt++] = *rec;
+
+	return XAHASH_FOREACH_CONT;
+}
+
+static int _sort_journal_job(const void *x, const void *y)
+{
+	const job_journal_rec_t *rec1 = x, *rec2 = y;
+
+	return (rec1->order > rec2->order) - (rec1->order < rec2->order);
+}
+
+/*
+ * Load job records from the journal in the order they were saved
+ * RET number of jobs loaded or -1 on error
+ */
+static int _load_job_journal(job_journal_t *journal)
+{
+	foreach_journal_job_t args = {
+		.recs = xcalloc(MAX(journal->rec_cnt, 1), sizeof(*args.recs)),
+	};
+	int job_cnt = 0;
+
+	(void) xahash_foreach_entry(journal->recs, _find_journal_job, &args);
+	qsort(args.recs, args.rec_cnt, sizeof(*args.recs), _sort_journal_job);
+
+	for (uint32_t i = 0; i < args.rec_cnt; i++) {
+		buf_t *buffer = create_shadow_buf(args.recs[i].data,
+						  args.recs[i].size);
+		int rc = _load_job_state(buffer, journal->protocol_version,
+					 NULL);
+
+		FREE_NULL_BUFFER(buffer);
+		if (rc != SLURM_SUCCESS) {
+			job_cnt = -1;
+			break;
+		}
+		job_cnt++;
+	}
+
+	xfree(args.recs);
+	return job_cnt;
+}
+
+static void *_unpack_job_state_range(void *arg)
+{
+	unpack_job_state_args_t *args = arg;
+
+	for (uint32_t i = args->start; i < args->end; i++) {
+		uint32_t end = ((i + 1) < args->rec_cnt) ?
+			args->offsets[i + 1] : size_buf(args->buffer);
+		buf_t *rec = create_shadow_buf((get_buf_data(args->buffer) +
+						args->offsets[i]),
+					       (end - args->offsets[i]));
+		int rc = job_record_unpack(&args->jobs[i], slurmctld_tres_cnt,
+					   rec, args->protocol_version);
+
+		if (!rc && remaining_buf(rec)) {
+			/* record is not where the index says */
+			job_record_delete(args->jobs[i]);
+			args->jobs[i] = NULL;
+			rc = SLURM_ERROR;
+		}
+		FREE_NULL_BUFFER(rec);
+
+		/* records after a bad record are not recovered */
+		if (rc)
+			break;
+	}
+
+	return NULL;
+}
+
+/* Get number of threads to unpack rec_cnt job_state records with */
+static int _job_state_unpack_threads(uint32_t rec_cnt)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int thread_cnt = MIN(JOB_STATE_UNPACK_THREADS,
+			     (rec_cnt / JOB_STATE_UNPACK_MIN_RECS));
+
+	if (cpus > 0)
+		thread_cnt = MIN(thread_cnt, cpus);
+
+	return thread_cnt;
+}
+
+/* Verify journal index covers the job records remaining in buffer */
+static bool _valid_job_state_index(buf_t *buffer, job_journal_t *journal)
+{
+	uint32_t prev = get_buf_offset(buffer);
+
+	if (!journal->offset_cnt || (journal->offsets[0] != prev) ||
+	    (prev >= size_buf(buffer)))
+		return false;
+
+	for (uint32_t i = 1; i < journal->offset_cnt; i++) {
+		if ((journal->offsets[i] <= prev) ||
+		    (journal->offsets[i] >= size_buf(buffer)))
+			return false;
+		prev = journal->offsets[i];
+	}
+
+	return true;
+}
+
+/*
+ * Unpack job_state records on several threads using the record offsets saved
+ * in the journal, then add the jobs in the order they were saved.
+ * RET number of records recovered or -1 on error
+ */
+static int _load_job_state_parallel(buf_t *buffer, uint16_t protocol_version,
+				    job_journal_t *journal, int thread_cnt)
+{
+	uint32_t rec_cnt = journal->offset_cnt;
+	uint32_t per_thread = ROUNDUP(rec_cnt, thread_cnt);
+	job_record_t **jobs = xcalloc(rec_cnt, sizeof(*jobs));
+	unpack_job_state_args_t *args = xcalloc(thread_cnt, sizeof(*args));
+	pthread_t *threads = xcalloc(thread_cnt, sizeof(*threads));
+	int job_cnt = 0;
+	uint32_t i;
+
+	for (int t = 0; t < thread_cnt; t++) {
+		args[t] = (unpack_job_state_args_t) {
+			.buffer = buffer,
+			.protocol_version = protocol_version,
+			.offsets = journal->offsets,
+			.rec_cnt = rec_cnt,
+			.start = MIN((t * per_thread), rec_cnt),
+			.end = MIN(((t + 1) * per_thread), rec_cnt),
+			.jobs = jobs,
+		};
+		slurm_thread_create(NULL, &threads[t], _unpack_job_state_range,
+				    &args[t]);
+	}
+
+	for (int t = 0; t < thread_cnt; t++)
+		slurm_thread_join(threads[t]);
+
+	for (i = 0; i < rec_cnt; i++) {
+		job_record_t *job_ptr = jobs[i];
+
+		if (!job_ptr) {
+			error("failed to load job from state");
+			error("Incomplete job record");
+			break;
+		}
+
+		jobs[i] = NULL;
+		if (_recover_job_state(job_ptr, journal) != SLURM_SUCCESS)
+			break;
+		job_cnt++;
+	}
+
+	if (i < rec_cnt) {
+		job_cnt = -1;
+		for (; i < rec_cnt; i++) {
+			if (jobs[i])
+				job_record_delete(jobs[i]);
+		}
+	}
+
+	debug("%s: unpacked %u job records with %d threads",
+	      __func__, rec_cnt, thread_cnt);
+
+	set_buf_offset(buffer, size_buf(buffer));
+	xfree(threads);
+	xfree(args);
+	xfree(jobs);
+	return job_cnt;
+}
+
 /*
  * load_all_job_state - load the job state from file, recover from last
  *	checkpoint. Execute this after loading the configuration file data.
@@ -1344,15 +2041,18 @@ unpack_error:
 extern int load_all_job_state(void)
 {
 	int error_code = SLURM_SUCCESS;
-	int job_cnt = 0;
+	int job_cnt = 0, journal_cnt, thread_cnt;
 	char *state_file = NULL;
 	buf_t *buffer;
-	time_t buf_time;
+	time_t buf_time, bf_when_last_cycle;
 	uint32_t saved_job_id;
 	char *ver_str = NULL;
 	uint16_t protocol_version = NO_VAL16;
+	job_journal_t journal = { 0 };
+	DEF_TIMERS;
 
 	/* read the file */
+	START_TIMER;
 	if (!(buffer = state_save_open("job_state", &state_file))) {
 		if ((clustername_existed == 1) && (!ignore_state_errors))
 			fatal("No job state file (%s) to recover", state_file);
@@ -1386,9 +2086,20 @@ extern int load_all_job_state(void)
 		job_id_sequence = MAX(saved_job_id, job_id_sequence);
 	debug3("Job id in job_state header is %u", saved_job_id);
 
-	safe_unpack_time(&buf_time, buffer); /* bf_when_last_cycle */
+	safe_unpack_time(&bf_when_last_cycle, buffer);
+
+	/* Records in the journal replace those saved in job_state */
+	if (_read_job_journal(buf_time, &journal))
+		goto unpack_error;
+	if (journal.segments) {
+		if (journal.job_id_sequence <= slurm_conf.max_job_id)
+			job_id_sequence = MAX(journal.job_id_sequence,
+					      job_id_sequence);
+		bf_when_last_cycle = journal.bf_when_last_cycle;
+	}
+
 	if (!slurmctld_diag_stats.bf_when_last_cycle)
-		slurmctld_diag_stats.bf_when_last_cycle = buf_time;
+		slurmctld_diag_stats.bf_when_last_cycle = bf_when_last_cycle;
 
 	/*
 	 * Previously we locked the tres read lock before this loop.  It turned
@@ -1397,23 +2108,51 @@ extern int load_all_job_state(void)
 	 * It ended up being much easier to move the locks for the assoc_mgr
 	 * into the job_mgr_load_job_state function than any other option.
 	 */
+	thread_cnt = _job_state_unpack_threads(journal.offset_cnt);
+	if ((thread_cnt > 1) && !_valid_job_state_index(buffer, &journal)) {
+		error("Job state journal does not match job records in job_state, unpacking them serially");
+		thread_cnt = 0;
+	}
+
+	if (thread_cnt > 1) {
+		if ((job_cnt = _load_job_state_parallel(buffer,
+							protocol_version,
+							&journal,
+							thread_cnt)) < 0) {
+			job_cnt = 0;
+			goto unpack_error;
+		}
+	}
+
 	while (remaining_buf(buffer) > 0) {
-		error_code = job_mgr_load_job_state(buffer, protocol_version);
+		error_code = _load_job_state(buffer, protocol_version,
+					     &journal);
 		if (error_code != SLURM_SUCCESS)
 			goto unpack_error;
 		job_cnt++;
 	}
+	job_cnt -= journal.superseded;
+
+	if (journal.recs) {
+		if ((journal_cnt = _load_job_journal(&journal)) < 0)
+			goto unpack_error;
+		job_cnt += journal_cnt;
+	}
 	debug3("Set job_id_sequence to %u", job_id_sequence);
 
+	_free_job_journal(&journal);
 	FREE_NULL_BUFFER(buffer);
-	info("Recovered information about %d jobs", job_cnt);
+	END_TIMER;
+	info("Recovered information about %d jobs in %s", job_cnt, TIMER_STR());
 	return error_code;
 
 unpack_error:
 	if (!ignore_state_errors)
 		fatal("Incomplete job state save file, start with '-i' to ignore this. Warning: using -i will lose the data that can't be recovered.");
 	error("Incomplete job state save file");
-	info("Recovered information about %d jobs", job_cnt);
+	END_TIMER;
+	info("Recovered information about %d jobs in %s", job_cnt, TIMER_STR());
+	_free_job_journal(&journal);
 	FREE_NULL_BUFFER(buffer);
 	return SLURM_ERROR;
 }
@@ -1430,6 +2169,7 @@ extern int load_last_job_id( void )
 	time_t buf_time;
 	char *ver_str = NULL;
 	uint16_t protocol_version = NO_VAL16;
+	job_journal_t journal;
 
 	/* read the file */
 	if (!(buffer = state_save_open("job_state", &state_file))) {
@@ -1461,6 +2201,12 @@ extern int load_last_job_id( void )
 
 	/* Ignore the state for individual jobs stored here */
 
+	if (!_read_job_journal(buf_time, &journal) && journal.segments) {
+		job_id_sequence = journal.job_id_sequence;
+		debug3("Job ID in job state journal is %u", job_id_sequence);
+	}
+	_free_job_journal(&journal);
+
 	xfree(ver_str);
 	FREE_NULL_BUFFER(buffer);
 	return SLURM_SUCCESS;
@@ -1494,12 +2240,14 @@ extern int job_mgr_dump_job_state(void *object, void *arg)
 	return 0;
 }
 
-extern int job_mgr_load_job_state(buf_t *buffer,
-				  uint16_t protocol_version)
+/*
+ * Add an unpacked job record
+ * IN journal - if set, records of jobs found in this journal are discarded
+ */
+static int _recover_job_state(job_record_t *job_ptr, job_journal_t *journal)
 {
 	char *err_part = NULL;
 	time_t now = time(NULL);
-	job_record_t *job_ptr = NULL;
 	int rc;
 	slurmdb_assoc_rec_t assoc_rec;
 	bool job_finished = false;
@@ -1510,10 +2258,13 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 		.user = READ_LOCK,
 	};
 
-	if (job_record_unpack(&job_ptr, slurmctld_tres_cnt, buffer,
-			      protocol_version)) {
-		error("failed to load job from state");
-		goto unpack_error;
+	if (journal && journal->recs &&
+	    xahash_find_entry(journal->recs, &job_ptr->job_id,
+			      sizeof(job_ptr->job_id))) {
+		/* Job was changed or purged after job_state was written */
+		journal->superseded++;
+		job_record_delete(job_ptr);
+		return SLURM_SUCCESS;
 	}
 
 	if (find_job_record(job_ptr->job_id) ||
@@ -1713,6 +2464,7 @@ extern int job_mgr_load_job_state(buf_t *buffer,
 
 	on_job_state_change(job_ptr, job_ptr->job_state);
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 	return SLURM_SUCCESS;
 
 unpack_error:
@@ -1729,6 +2481,79 @@ free_it:
 	return rc;
 }
 
+/*
+ * Unpack and add a job record
+ * IN journal - if set, records of jobs found in this journal are discarded
+ */
+static int _load_job_state(buf_t *buffer, uint16_t protocol_version,
+			   job_journal_t *journal)
+{
+	job_record_t *job_ptr = NULL;
+
+	if (job_record_unpack(&job_ptr, slurmctld_tres_cnt, buffer,
+			      protocol_version)) {
+		error("failed to load job from state");
+		error("Incomplete job record");
+		return SLURM_ERROR;
+	}
+
+	return _recover_job_state(job_ptr, journal);
+}
+
+extern int job_mgr_load_job_state(buf_t *buffer,
+				  uint16_t protocol_version)
+{
+	return _load_job_state(buffer, protocol_version, NULL);
+}
+
+static xahash_hash_t _job_hash_func(const void *key, const size_t key_bytes,
+				    void *state)
+{
+	xassert(key_bytes == sizeof(uint32_t));
+
+	return *(const uint32_t *) key;
+}
+
+static bool _job_hash_match(void *entry, const void *key,
+			    const size_t key_bytes, void *state)
+{
+	job_record_t *job_ptr = *(job_record_t **) entry;
+
+	return (job_ptr->job_id == *(const uint32_t *) key);
+}
+
+static xahash_hash_t _sluid_hash_func(const void *key, const size_t key_bytes,
+				      void *state)
+{
+	sluid_t sluid = *(const sluid_t *) key;
+
+	xassert(key_bytes == sizeof(sluid_t));
+
+	return (xahash_hash_t) (sluid ^ (sluid >> 32));
+}
+
+static bool _sluid_hash_match(void *entry, const void *key,
+			      const size_t key_bytes, void *state)
+{
+	job_record_t *job_ptr = *(job_record_t **) entry;
+
+	return (job_ptr->step_id.sluid == *(const sluid_t *) key);
+}
+
+/*
+ * Store a job record in a hash table entry. A job record already holding the
+ * same key is replaced so that lookups find the newest record, as they did
+ * with chained hash tables.
+ */
+static void _set_job_hash_entry(job_record_t **entry, job_record_t *job_ptr)
+{
+	if (*entry && (*entry != job_ptr))
+		debug("%s: %pJ replaces %pJ in job hash",
+		      __func__, job_ptr, *entry);
+
+	*entry = job_ptr;
+}
+
 /* _add_job_hash - add a job hash entry for given job record, job_id must
  *	already be set
  * IN job_ptr - pointer to job record
@@ -1736,25 +2561,60 @@ free_it:
  */
 static void _add_job_hash(job_record_t *job_ptr)
 {
-	int inx;
-
-	inx = JOB_HASH_INX(job_ptr->job_id);
-	job_ptr->job_next = job_hash[inx];
-	job_hash[inx] = job_ptr;
+	_set_job_hash_entry(xahash_insert_entry(job_hash, &job_ptr->job_id,
+						sizeof(job_ptr->job_id)),
+			    job_ptr);
 }
 
 static void _add_job_hash_sluid(job_record_t *job_ptr)
 {
-	int inx;
-
 	if (!job_ptr->step_id.sluid) {
 		debug("%s: JobId=%pJ has no SLUID?", __func__, job_ptr);
 		return;
 	}
 
-	inx = JOB_HASH_INX(job_ptr->step_id.sluid);
-	job_ptr->job_next_sluid = job_hash_sluid[inx];
-	job_hash_sluid[inx] = job_ptr;
+	_set_job_hash_entry(
+		xahash_insert_entry(job_hash_sluid, &job_ptr->step_id.sluid,
+				    sizeof(job_ptr->step_id.sluid)),
+		job_ptr);
+}
+
+static void _on_insert_job_hash(void *entry, const void *key,
+				const size_t key_bytes, void *state)
+{
+	*(job_record_t **) entry = NULL;
+}
+
+/*
+ * Remove a job record from the job_id or sluid hash table
+ * RET false if no job record holds its key
+ */
+static bool _remove_job_xahash(job_record_t *job_entry,
+			       job_hash_type_t type)
+{
+	xahash_table_t *ht;
+	const void *key;
+	size_t key_bytes;
+	job_record_t **entry;
+
+	if (type == JOB_HASH_JOB) {
+		ht = job_hash;
+		key = &job_entry->job_id;
+		key_bytes = sizeof(job_entry->job_id);
+	} else {
+		ht = job_hash_sluid;
+		key = &job_entry->step_id.sluid;
+		key_bytes = sizeof(job_entry->step_id.sluid);
+	}
+
+	if (!(entry = xahash_find_entry(ht, key, key_bytes)))
+		return false;
+
+	/* Leave the newer job record that replaced this one */
+	if (*entry == job_entry)
+		(void) xahash_free_entry(ht, key, key_bytes);
+
+	return true;
 }
 
 /* _remove_job_hash - remove a job hash entry for given job record, job_id must
@@ -1771,99 +2631,61 @@ static void _remove_job_hash(job_record_t *job_entry, job_hash_type_t type)
 
 	on_job_state_change(job_entry, NO_VAL);
 
-	if ((type == JOB_HASH_SLUID) && !job_entry->step_id.sluid) {
-		debug("%s: JobId=%pJ has no SLUID?", __func__, job_entry);
-		return;
-	}
-
 	switch (type) {
 	case JOB_HASH_JOB:
-		job_pptr = &job_hash[JOB_HASH_INX(job_entry->job_id)];
-		break;
+		if (!_remove_job_xahash(job_entry, type) &&
+		    (job_entry->job_id != NO_VAL))
+			error("%s: Could not find hash entry for JobId=%u",
+			      __func__, job_entry->job_id);
+		return;
 	case JOB_HASH_SLUID:
-		job_pptr =
-			&job_hash_sluid[JOB_HASH_INX(job_entry->step_id.sluid)];
-		break;
+		if (!job_entry->step_id.sluid) {
+			debug("%s: JobId=%pJ has no SLUID?",
+			      __func__, job_entry);
+			return;
+		}
+		if (!_remove_job_xahash(job_entry, type) &&
+		    (job_entry->job_id != NO_VAL))
+			error("%s: Could not find hash entry for SLUID=%"PRIu64,
+			      __func__, job_entry->step_id.sluid);
+		return;
 	case JOB_HASH_ARRAY_JOB:
 		job_pptr = &job_array_hash_j[
 			JOB_HASH_INX(job_entry->array_job_id)];
-		break;
+		while ((job_ptr = *job_pptr) && (job_ptr != job_entry)) {
+			xassert(job_ptr->magic == JOB_MAGIC);
+			job_pptr = &job_ptr->job_array_next_j;
+		}
+		if (!job_ptr) {
+			if (job_entry->job_id != NO_VAL)
+				error("%s: job array hash error %u", __func__,
+				      job_entry->array_job_id);
+			return;
+		}
+		*job_pptr = job_entry->job_array_next_j;
+		job_entry->job_array_next_j = NULL;
+		return;
 	case JOB_HASH_ARRAY_TASK:
 		job_pptr = &job_array_hash_t[
 			JOB_ARRAY_HASH_INX(job_entry->array_job_id,
 					   job_entry->array_task_id)];
-		break;
-	default:
-		fatal("%s: unknown job_hash_type_t %d", __func__, type);
-		return;
-	}
-
-	while ((job_pptr != NULL) && (*job_pptr != NULL) &&
-	       ((job_ptr = *job_pptr) != job_entry)) {
-		xassert(job_ptr->magic == JOB_MAGIC);
-		switch (type) {
-		case JOB_HASH_JOB:
-			job_pptr = &job_ptr->job_next;
-			break;
-		case JOB_HASH_SLUID:
-			job_pptr = &job_ptr->job_next_sluid;
-			break;
-		case JOB_HASH_ARRAY_JOB:
-			job_pptr = &job_ptr->job_array_next_j;
-			break;
-		case JOB_HASH_ARRAY_TASK:
+		while ((job_ptr = *job_pptr) && (job_ptr != job_entry)) {
+			xassert(job_ptr->magic == JOB_MAGIC);
 			job_pptr = &job_ptr->job_array_next_t;
-			break;
 		}
-	}
-
-	if (job_pptr == NULL || *job_pptr == NULL) {
-		if (job_entry->job_id == NO_VAL)
+		if (!job_ptr) {
+			if (job_entry->job_id != NO_VAL)
+				error("%s: job array, task ID hash error %u_%u",
+				      __func__, job_entry->array_job_id,
+				      job_entry->array_task_id);
 			return;
-
-		switch (type) {
-		case JOB_HASH_JOB:
-			error("%s: Could not find hash entry for JobId=%u",
-			      __func__, job_entry->job_id);
-			break;
-		case JOB_HASH_SLUID:
-		{
-			error("%s: Could not find hash entry for SLUID=%"PRIu64,
-			      __func__, job_entry->step_id.sluid);
-			break;
-		case JOB_HASH_ARRAY_JOB:
-			error("%s: job array hash error %u", __func__,
-			      job_entry->array_job_id);
-			break;
-		case JOB_HASH_ARRAY_TASK:
-			error("%s: job array, task ID hash error %u_%u",
-			      __func__,
-			      job_entry->array_job_id,
-			      job_entry->array_task_id);
-			break;
-		}
 		}
-		return;
-	}
-
-	switch (type) {
-	case JOB_HASH_JOB:
-		*job_pptr = job_entry->job_next;
-		job_entry->job_next = NULL;
-		break;
-	case JOB_HASH_SLUID:
-		*job_pptr = job_entry->job_next_sluid;
-		job_entry->job_next_sluid = NULL;
-		break;
-	case JOB_HASH_ARRAY_JOB:
-		*job_pptr = job_entry->job_array_next_j;
-		job_entry->job_array_next_j = NULL;
-		break;
-	case JOB_HASH_ARRAY_TASK:
 		*job_pptr = job_entry->job_array_next_t;
 		job_entry->job_array_next_t = NULL;
-		break;
+		return;
 	}
+
+	fatal("%s: unknown job_hash_type_t %d", __func__, type);
 }
 
 /* _add_job_array_hash - add a job hash entry for given job record,
@@ -2539,32 +3361,25 @@ extern job_record_t *find_het_job_record(uint32_t job_id,
  */
 extern job_record_t *find_job_record(uint32_t job_id)
 {
-	job_record_t *job_ptr;
+	job_record_t **entry;
 	xassert(verify_lock(JOB_LOCK, READ_LOCK));
 
-	job_ptr = job_hash[JOB_HASH_INX(job_id)];
-	while (job_ptr) {
-		if (job_ptr->job_id == job_id)
-			return job_ptr;
-		job_ptr = job_ptr->job_next;
-	}
+	if (!(entry = xahash_find_entry(job_hash, &job_id, sizeof(job_id))))
+		return NULL;
 
-	return NULL;
+	return *entry;
 }
 
 extern job_record_t *find_sluid(sluid_t sluid)
 {
-	job_record_t *job_ptr;
+	job_record_t **entry;
 	xassert(verify_lock(JOB_LOCK, READ_LOCK));
 
-	job_ptr = job_hash_sluid[JOB_HASH_INX(sluid)];
-	while (job_ptr) {
-		if (job_ptr->step_id.sluid == sluid)
-			return job_ptr;
-		job_ptr = job_ptr->job_next_sluid;
-	}
+	if (!(entry = xahash_find_entry(job_hash_sluid, &sluid,
+					sizeof(sluid))))
+		return NULL;
 
-	return NULL;
+	return *entry;
 }
 
 extern job_record_t *find_job(const slurm_step_id_t *step_id)
@@ -2806,6 +3621,7 @@ static int _foreach_kill_job_by_part_name(void *x, void *arg)
 	}
 	if (IS_JOB_RUNNING(job_ptr) || suspended) {
 		foreach_kill_job_by->kill_job_cnt++;
+		job_ptr->last_update = now;
 		info("Killing %pJ on defunct partition %s",
 		     job_ptr, part_ptr->name);
 		job_state_set(job_ptr, (JOB_NODE_FAIL | JOB_COMPLETING));
@@ -2824,6 +3640,7 @@ static int _foreach_kill_job_by_part_name(void *x, void *arg)
 			deallocate_nodes(job_ptr, false, suspended, false);
 	} else if (pending) {
 		foreach_kill_job_by->kill_job_cnt++;
+		job_ptr->last_update = now;
 		info("Killing %pJ on defunct partition %s",
 		     job_ptr, part_ptr->name);
 		job_state_set(job_ptr, JOB_CANCELLED);
@@ -2967,6 +3784,7 @@ static int _foreach_kill_running_job_by_node(void *x, void *arg)
 		if (!bit_test(job_ptr->node_bitmap_cg, node_ptr->index))
 			return 0;
 		foreach_kill_job_by->kill_job_cnt++;
+		job_ptr->last_update = foreach_kill_job_by->now;
 		bit_clear(job_ptr->node_bitmap_cg, node_ptr->index);
 		job_update_tres_cnt(job_ptr, node_ptr->index);
 		if (job_ptr->node_cnt)
@@ -2984,6 +3802,7 @@ static int _foreach_kill_running_job_by_node(void *x, void *arg)
 		}
 	} else if (IS_JOB_RUNNING(job_ptr) || suspended) {
 		foreach_kill_job_by->kill_job_cnt++;
+		job_ptr->last_update = foreach_kill_job_by->now;
 		if ((job_ptr->details) &&
 		    (job_ptr->kill_on_node_fail == 0) &&
 		    (job_ptr->node_cnt > 1) &&
@@ -3382,7 +4201,7 @@ void dump_job_desc(job_desc_msg_t *job_desc)
  *	this should be called after creating node information, but
  *	before creating any job entries. Pre-existing job entries are
  *	left unchanged.
- *	NOTE: The job hash table size does not change after initial creation.
+ *	NOTE: The job hash tables grow as jobs are added, see rehash_jobs().
  * global: last_job_update - time of last job table update
  *	job_list - pointer to global job list
  *	purge_jobs_list - pointer to purge_jobs_list
@@ -3404,6 +4223,13 @@ void init_job_conf(void)
 		purge_jobs_list = list_create(job_record_delete);
 }
 
+static int _foreach_add_array_hash(void *x, void *arg)
+{
+	_add_job_array_hash(x);
+
+	return 0;
+}
+
 /*
  * rehash_jobs - Create or rebuild the job hash table.
  */
@@ -3413,21 +4239,36 @@ extern void rehash_jobs(void)
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
 	if (job_hash == NULL) {
+		/* Grow as jobs are added */
+		job_hash = xahash_new_table(_job_hash_func, _job_hash_match,
+					    _on_insert_job_hash, NULL, 0,
+					    sizeof(job_record_t *), 0);
+		job_hash_sluid = xahash_new_table(_sluid_hash_func,
+						  _sluid_hash_match,
+						  _on_insert_job_hash, NULL,
+						  0, sizeof(job_record_t *),
+						  0);
+	} else if (hash_table_size < (slurm_conf.max_job_cnt / 2)) {
+		/*
+		 * The job array hash tables are chained by array_job_id, so
+		 * rebuild them if MaxJobCount grows by too much for them to
+		 * remain effective.
+		 */
+		info("%s: MaxJobCount increased, rebuilding job array hash tables",
+		     __func__);
+		xfree(job_array_hash_j);
+		xfree(job_array_hash_t);
+	}
+
+	if (!job_array_hash_j) {
 		hash_table_size = slurm_conf.max_job_cnt;
-		job_hash = xcalloc(hash_table_size, sizeof(job_record_t *));
-		job_hash_sluid =
-			xcalloc(hash_table_size, sizeof(job_record_t *));
 		job_array_hash_j = xcalloc(hash_table_size,
 					   sizeof(job_record_t *));
 		job_array_hash_t = xcalloc(hash_table_size,
 					   sizeof(job_record_t *));
-	} else if (hash_table_size < (slurm_conf.max_job_cnt / 2)) {
-		/* If the MaxJobCount grows by too much, the hash table will
-		 * be ineffective without rebuilding. We don't presently bother
-		 * to rebuild the hash table, but cut MaxJobCount back as
-		 * needed. */
-		error ("MaxJobCount reset too high, restart slurmctld");
-		slurm_conf.max_job_cnt = hash_table_size;
+		if (job_list)
+			(void) list_for_each(job_list, _foreach_add_array_hash,
+					     NULL);
 	}
 }
 
@@ -3475,6 +4316,7 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	job_ptr_pend->step_list = save_step_list;
 	job_ptr_pend->db_index = save_db_index;
 	job_ptr_pend->step_id = save_step_id;
+	job_ptr_pend->last_update = job_ptr->last_update = time(NULL);
 
 	job_ptr_pend->prio_factors = save_prio_factors;
 	slurm_copy_priority_factors(job_ptr_pend->prio_factors,
@@ -3552,8 +4394,8 @@ extern job_record_t *job_array_split(job_record_t *job_ptr, bool list_add)
 	memcpy(job_ptr_pend->limit_set.tres, job_ptr->limit_set.tres,
 	       sizeof(uint16_t) * slurmctld_tres_cnt);
 
-	_add_job_hash(job_ptr);		/* Sets job_next */
-	_add_job_hash(job_ptr_pend);	/* Sets job_next */
+	_add_job_hash(job_ptr);
+	_add_job_hash(job_ptr_pend);
 	_add_job_hash_sluid(job_ptr);
 	_add_job_hash_sluid(job_ptr_pend);
 	_add_job_array_hash(job_ptr);
@@ -4342,6 +5184,7 @@ extern int job_allocate(job_desc_msg_t *job_desc, int immediate,
 
 	if (!test_only) {
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 	}
 
 	if (held_user)
@@ -4484,6 +5327,7 @@ static int _job_fail(job_record_t *job_ptr, uint32_t job_state)
 		} else
 			job_ptr->end_time       = now;
 		last_job_update                 = now;
+		job_ptr->last_update            = time(NULL);
 		job_state_set(job_ptr, (job_state | JOB_COMPLETING));
 		job_ptr->exit_code = 1;
 		job_ptr->state_reason = FAIL_LAUNCH;
@@ -5203,6 +6047,7 @@ extern int job_signal(job_record_t *job_ptr, uint16_t signal,
 	}
 
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 
 	/*
 	 * Handle jobs submitted through scrontab.
@@ -5246,6 +6091,7 @@ extern int job_signal(job_record_t *job_ptr, uint16_t signal,
 
 	if (IS_JOB_CONFIGURING(job_ptr) && (signal == SIGKILL)) {
 		last_job_update         = now;
+		job_ptr->last_update    = time(NULL);
 		job_ptr->end_time       = now;
 		job_state_set(job_ptr, (JOB_CANCELLED | JOB_COMPLETING));
 		if (flags & KILL_FED_REQUEUE)
@@ -5297,6 +6143,7 @@ extern int job_signal(job_record_t *job_ptr, uint16_t signal,
 		job_term_state = JOB_CANCELLED;
 	if (IS_JOB_SUSPENDED(job_ptr) && (signal == SIGKILL)) {
 		last_job_update         = now;
+		job_ptr->last_update    = time(NULL);
 		job_ptr->end_time       = job_ptr->suspend_time;
 		job_ptr->tot_sus_time  += difftime(now, job_ptr->suspend_time);
 		job_state_set(job_ptr, (job_term_state | JOB_COMPLETING));
@@ -5333,6 +6180,7 @@ extern int job_signal(job_record_t *job_ptr, uint16_t signal,
 			job_ptr->time_last_active	= now;
 			job_ptr->end_time		= now;
 			last_job_update			= now;
+			job_ptr->last_update		= time(NULL);
 			job_state_set(job_ptr, (job_term_state |
 						JOB_COMPLETING));
 			if (flags & KILL_FED_REQUEUE)
@@ -5485,6 +6333,7 @@ static void _signal_pending_job_array_tasks(job_record_t *job_ptr,
 	      job_ptr->array_recs->task_id_bitmap))
 		return; /* No tasks to signal */
 
+	job_ptr->last_update = now;
 	if (admin_comment) {
 		xfree(job_ptr->admin_comment);
 		job_ptr->admin_comment = xstrdup(admin_comment);
@@ -6041,6 +6890,7 @@ extern int prolog_complete(prolog_complete_msg_t *msg)
 		agent_trigger(999, false, true);
 	}
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	return SLURM_SUCCESS;
 }
@@ -6265,6 +7115,7 @@ static int _job_complete(job_record_t *job_ptr, uid_t uid, bool requeue,
 	}
 
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 	job_ptr->time_last_active = now;   /* Timer for resending kill RPC */
 	if (job_comp_flag) {	/* job was running */
 		build_cg_bitmap(job_ptr);
@@ -9214,6 +10065,7 @@ extern void job_config_fini(job_record_t *job_ptr)
 	time_t now = time(NULL);
 
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 	job_state_unset_flag(job_ptr, JOB_CONFIGURING);
 	if (IS_JOB_POWER_UP_NODE(job_ptr)) {
 		info("Resetting %pJ start time for node power up", job_ptr);
@@ -9376,6 +10228,7 @@ void job_time_limit(void)
 			job_ptr->state_reason = WAIT_NO_REASON;
 			set_job_prio(job_ptr);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		}
 
 		/* Don't enforce time limits for configuring hetjobs */
@@ -9454,6 +10307,7 @@ void job_time_limit(void)
 				over_run = now - (over_time_limit  * 60);
 			if (job_ptr->end_time <= over_run) {
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 				info("Time limit exhausted for %pJ", job_ptr);
 				_job_timed_out(job_ptr, false);
 				job_ptr->state_reason = FAIL_TIMEOUT;
@@ -9466,6 +10320,7 @@ void job_time_limit(void)
 		    !(job_ptr->resv_ptr->flags & RESERVE_FLAG_FLEX) &&
 		    (job_ptr->resv_ptr->end_time + resv_over_run) < time(NULL)){
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			info("Reservation ended for %pJ", job_ptr);
 			xfree(job_ptr->state_desc);
 			xstrfmtcat(job_ptr->state_desc, "Reservation %s, which this job was running under, has ended",
@@ -9487,6 +10342,7 @@ void job_time_limit(void)
 
 		if (job_ptr->state_reason == FAIL_TIMEOUT) {
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			_job_timed_out(job_ptr, false);
 			xfree(job_ptr->state_desc);
 			goto time_check;
@@ -10170,35 +11026,290 @@ static bool _hide_job_user_rec(job_record_t *job_ptr, slurmdb_user_rec_t *user,
 	return false;
 }
 
-static int _pack_job(void *object, void *arg)
+static void _job_pack_cache_clear(job_pack_cache_t *cache)
 {
-	job_record_t *job_ptr = (job_record_t *)object;
-	_foreach_pack_job_info_t *pack_info = (_foreach_pack_job_info_t *)arg;
+	FREE_NULL_BUFFER(cache->buffer);
+	xfree(cache->frags);
+	xfree(cache->frags_by_job);
+	memset(cache, 0, sizeof(*cache));
+}
+
+static bool _job_pack_cache_tables_valid(job_pack_cache_t *cache)
+{
+	return ((cache->last_node_update == last_node_update) &&
+		(cache->last_part_update == last_part_update) &&
+		(cache->last_conf_update == slurm_conf.last_update));
+}
+
+static bool _job_pack_cache_valid(job_pack_cache_t *cache,
+				  uint16_t protocol_version,
+				  uint16_t show_flags, time_t now)
+{
+	return (cache->buffer &&
+		(cache->protocol_version == protocol_version) &&
+		(cache->show_flags == show_flags) &&
+		_job_pack_cache_tables_valid(cache) &&
+		(!cache->expire_time || (now < cache->expire_time)));
+}
+
+/*
+ * Return true if no job changed since the cache was last refreshed. Update
+ * times only have a resolution of one second, so a change made later in the
+ * second of the refresh could not be detected.
+ */
+static bool _job_pack_cache_current(job_pack_cache_t *cache)
+{
+	return ((cache->last_job_update == last_job_update) &&
+		(last_job_update < cache->build_time));
+}
+
+static job_pack_cache_t *_job_pack_cache_find(uint16_t protocol_version,
+					      uint16_t show_flags, time_t now)
+{
+	for (int i = 0; i < JOB_PACK_CACHE_CNT; i++) {
+		if (_job_pack_cache_valid(&job_pack_cache[i], protocol_version,
+					  show_flags, now))
+			return &job_pack_cache[i];
+	}
+
+	return NULL;
+}
+
+/*
+ * Return true if the packed record of a job depends on the current time,
+ * otherwise lower cache->expire_time to when its packed record goes stale.
+ * Mirrors the expected start time logic of pack_job().
+ */
+static bool _job_pack_is_volatile(job_record_t *job_ptr,
+				  job_pack_cache_t *cache)
+{
+	time_t expire = 0;
+
+	if (IS_JOB_STARTED(job_ptr))
+		return false;
+
+	if (job_ptr->start_time) {
+		if (job_ptr->start_time <= cache->build_time)
+			return true;
+		expire = job_ptr->start_time;
+	} else if (job_ptr->details &&
+		   (job_ptr->details->begin_time > cache->build_time)) {
+		expire = job_ptr->details->begin_time;
+	}
+
+	if (expire && (!cache->expire_time || (expire < cache->expire_time)))
+		cache->expire_time = expire;
+
+	return false;
+}
+
+static int _job_pack_frag_cmp(const void *x, const void *y)
+{
+	uintptr_t job1 = (uintptr_t) (*(job_pack_frag_t **) x)->job_ptr;
+	uintptr_t job2 = (uintptr_t) (*(job_pack_frag_t **) y)->job_ptr;
+
+	if (job1 < job2)
+		return -1;
+	return (job1 > job2);
+}
+
+/*
+ * Find the packed record of a job in frags_by_job.
+ * RET the record or NULL if none or the job changed since it was packed
+ */
+static job_pack_frag_t *_job_pack_frag_find(job_pack_frag_t **frags_by_job,
+					    uint32_t frag_cnt,
+					    job_record_t *job_ptr)
+{
+	job_pack_frag_t key = { .job_ptr = job_ptr }, *key_ptr = &key;
+	job_pack_frag_t **frag;
+
+	if (!frag_cnt)
+		return NULL;
+
+	frag = bsearch(&key_ptr, frags_by_job, frag_cnt, sizeof(*frags_by_job),
+		       _job_pack_frag_cmp);
+
+	if (!frag || !(*frag)->size ||
+	    ((*frag)->job_id != job_ptr->job_id) ||
+	    (job_ptr->last_update >= (*frag)->pack_time))
+		return NULL;
+
+	return *frag;
+}
+
+static int _foreach_job_pack_cache_add(void *x, void *arg)
+{
+	job_record_t *job_ptr = x;
+	job_pack_refresh_t *refresh = arg;
+	job_pack_cache_t *cache = refresh->cache;
+	job_pack_frag_t *frag = &cache->frags[cache->frag_cnt++];
+	job_pack_frag_t *old_frag;
+
+	frag->job_ptr = job_ptr;
+	frag->job_id = job_ptr->job_id;
+	if (_job_pack_is_volatile(job_ptr, cache))
+		return 0;
+
+	old_frag = _job_pack_frag_find(refresh->old_frags_by_job,
+				       refresh->old_frag_cnt, job_ptr);
+	if (old_frag && !refresh->old_buffer) {
+		frag->offset = old_frag->offset;
+		frag->size = old_frag->size;
+		frag->pack_time = old_frag->pack_time;
+	} else if (old_frag) {
+		buf_t *buffer = cache->buffer;
+
+		if (try_grow_buf_remaining(buffer, old_frag->size))
+			return 0;
+		frag->offset = get_buf_offset(buffer);
+		memcpy(&buffer->head[frag->offset],
+		       &refresh->old_buffer->head[old_frag->offset],
+		       old_frag->size);
+		buffer->processed += old_frag->size;
+		frag->size = old_frag->size;
+		frag->pack_time = old_frag->pack_time;
+	} else {
+		frag->offset = get_buf_offset(cache->buffer);
+		pack_job(job_ptr, cache->show_flags, cache->buffer,
+			 cache->protocol_version, 0, true);
+		frag->size = get_buf_offset(cache->buffer) - frag->offset;
+		frag->pack_time = cache->build_time;
+	}
+	cache->live_size += frag->size;
+
+	return 0;
+}
+
+/*
+ * Bring the cache slot of a protocol version and detail level up to date with
+ * job_list, reusing the records of jobs unchanged since they were packed. A
+ * new cache takes the oldest slot.
+ * RET the cache or NULL if the other tables changed too recently to be cached
+ */
+static job_pack_cache_t *_job_pack_cache_refresh(uint16_t protocol_version,
+						 uint16_t show_flags,
+						 time_t now)
+{
+	job_pack_cache_t *cache = NULL;
+	job_pack_refresh_t refresh = { 0 };
+	job_pack_frag_t *old_frags;
+
+	/*
+	 * Update times only have a resolution of one second, so a change made
+	 * later in this same second could not be detected.
+	 */
+	if ((last_node_update >= now) || (last_part_update >= now) ||
+	    (slurm_conf.last_update >= now))
+		return NULL;
+
+	for (int i = 0; i < JOB_PACK_CACHE_CNT; i++) {
+		job_pack_cache_t *slot = &job_pack_cache[i];
 
+		if (slot->buffer && (slot->protocol_version == protocol_version)
+		    && (slot->show_flags == show_flags)) {
+			cache = slot;
+			break;
+		}
+		if (!cache || (slot->build_time < cache->build_time))
+			cache = slot;
+	}
+
+	if (!cache->buffer || (cache->protocol_version != protocol_version) ||
+	    (cache->show_flags != show_flags) ||
+	    !_job_pack_cache_tables_valid(cache)) {
+		_job_pack_cache_clear(cache);
+		cache->protocol_version = protocol_version;
+		cache->show_flags = show_flags;
+		cache->last_conf_update = slurm_conf.last_update;
+		cache->last_node_update = last_node_update;
+		cache->last_part_update = last_part_update;
+		cache->buffer = init_buf(BUF_SIZE);
+	} else if (get_buf_offset(cache->buffer) > (2 * cache->live_size)) {
+		/* Mostly replaced records, copy the current ones out */
+		refresh.old_buffer = cache->buffer;
+		cache->buffer = init_buf(cache->live_size + BUF_SIZE);
+	}
+
+	refresh.cache = cache;
+	refresh.old_frags_by_job = cache->frags_by_job;
+	refresh.old_frag_cnt = cache->frag_cnt;
+	old_frags = cache->frags;
+
+	cache->build_time = now;
+	cache->expire_time = 0;
+	cache->last_job_update = last_job_update;
+	cache->live_size = 0;
+	cache->frag_cnt = 0;
+	cache->frags = xcalloc(list_count(job_list), sizeof(*cache->frags));
+	list_for_each_ro(job_list, _foreach_job_pack_cache_add, &refresh);
+
+	xfree(old_frags);
+	xfree(refresh.old_frags_by_job);
+	FREE_NULL_BUFFER(refresh.old_buffer);
+
+	cache->frags_by_job = xcalloc(cache->frag_cnt,
+				      sizeof(*cache->frags_by_job));
+	for (int i = 0; i < cache->frag_cnt; i++)
+		cache->frags_by_job[i] = &cache->frags[i];
+	qsort(cache->frags_by_job, cache->frag_cnt,
+	      sizeof(*cache->frags_by_job), _job_pack_frag_cmp);
+
+	return cache;
+}
+
+/* Pack one job record if it passes the request's filters */
+static void _pack_job_filtered(job_record_t *job_ptr, job_pack_frag_t *frag,
+			       _foreach_pack_job_info_t *pack_info)
+{
 	xassert (job_ptr->magic == JOB_MAGIC);
 
 	if ((pack_info->filter_uid != NO_VAL) &&
 	    (pack_info->filter_uid != job_ptr->user_id))
-		return SLURM_SUCCESS;
+		return;
 
 	if (!(pack_info->show_flags & SHOW_ALL) && IS_JOB_REVOKED(job_ptr))
-		return SLURM_SUCCESS;
+		return;
 
 	if (!pack_info->privileged) {
 		if (((pack_info->show_flags & SHOW_ALL) == 0) &&
 		    _all_parts_hidden(job_ptr, pack_info->visible_parts))
-			return SLURM_SUCCESS;
+			return;
 
 		if (_hide_job_user_rec(job_ptr, &pack_info->user_rec,
 				       pack_info->show_flags))
-			return SLURM_SUCCESS;
+			return;
 	}
 
-	pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
-		 pack_info->protocol_version, pack_info->uid,
-		 pack_info->has_qos_lock);
+	if (frag && frag->size) {
+		buf_t *buffer = pack_info->buffer;
+
+		if (try_grow_buf_remaining(buffer, frag->size))
+			return;
+		memcpy(&buffer->head[buffer->processed],
+		       &pack_info->cache->buffer->head[frag->offset],
+		       frag->size);
+		buffer->processed += frag->size;
+	} else {
+		pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
+			 pack_info->protocol_version, pack_info->uid,
+			 pack_info->has_qos_lock);
+	}
 
 	pack_info->jobs_packed++;
+}
+
+static int _pack_job(void *object, void *arg)
+{
+	job_record_t *job_ptr = (job_record_t *)object;
+	_foreach_pack_job_info_t *pack_info = (_foreach_pack_job_info_t *)arg;
+	job_pack_frag_t *frag = NULL;
+
+	if (pack_info->cache)
+		frag = _job_pack_frag_find(pack_info->cache->frags_by_job,
+					   pack_info->cache->frag_cnt, job_ptr);
+
+	_pack_job_filtered(job_ptr, frag, pack_info);
 
 	return SLURM_SUCCESS;
 }
@@ -10237,6 +11348,51 @@ static int _foreach_pack_jobid(void *object, void *arg)
 	return _pack_job(job_ptr, info);
 }
 
+/*
+ * Pack the jobs in job_ids, or all jobs if NULL, from the cache of packed job
+ * records. The cache is only refreshed for requests of all jobs, requests of
+ * job ids only reuse the records of jobs unchanged since they were packed.
+ * RET false if no cache could be used and nothing was packed
+ */
+static bool _pack_jobs_cached(list_t *job_ids,
+			      _foreach_pack_job_info_t *pack_info)
+{
+	uint16_t show_flags = pack_info->show_flags & SHOW_DETAIL;
+	time_t now = time(NULL);
+	job_pack_cache_t *cache;
+
+	xassert(verify_lock(JOB_LOCK, READ_LOCK));
+
+	slurm_rwlock_rdlock(&job_pack_cache_lock);
+	cache = _job_pack_cache_find(pack_info->protocol_version, show_flags,
+				     now);
+	if (!job_ids && (!cache || !_job_pack_cache_current(cache))) {
+		slurm_rwlock_unlock(&job_pack_cache_lock);
+		slurm_rwlock_wrlock(&job_pack_cache_lock);
+		cache = _job_pack_cache_find(pack_info->protocol_version,
+					     show_flags, now);
+		if (!cache || !_job_pack_cache_current(cache))
+			cache = _job_pack_cache_refresh(
+				pack_info->protocol_version, show_flags, now);
+	}
+
+	if (cache) {
+		pack_info->cache = cache;
+		if (job_ids) {
+			list_for_each_ro(job_ids, _foreach_pack_jobid,
+					 pack_info);
+		} else {
+			for (int i = 0; i < cache->frag_cnt; i++)
+				_pack_job_filtered(cache->frags[i].job_ptr,
+						   &cache->frags[i], pack_info);
+		}
+		pack_info->cache = NULL;
+	}
+	slurm_rwlock_unlock(&job_pack_cache_lock);
+
+	return (cache != NULL);
+}
+
 /*
  * _pack_init_job_info - create buffer with header packed for a job_info_msg_t
  *
@@ -10291,7 +11447,8 @@ extern buf_t *pack_all_jobs(uint16_t show_flags, uid_t uid, uint32_t filter_uid,
 	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
 	pack_info.visible_parts = build_visible_parts(
 		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
-	list_for_each_ro(job_list, _pack_job, &pack_info);
+	if (!_pack_jobs_cached(NULL, &pack_info))
+		list_for_each_ro(job_list, _pack_job, &pack_info);
 	assoc_mgr_unlock(&locks);
 
 	/* put the real record count in the message body header */
@@ -10341,7 +11498,8 @@ extern buf_t *pack_spec_jobs(list_t *job_ids, uint16_t show_flags, uid_t uid,
 	pack_info.privileged = validate_operator_user_rec(&pack_info.user_rec);
 	pack_info.visible_parts = build_visible_parts(
 		uid, (pack_info.privileged || (show_flags & SHOW_ALL)));
-	list_for_each_ro(job_ids, _foreach_pack_jobid, &pack_info);
+	if (!_pack_jobs_cached(job_ids, &pack_info))
+		list_for_each_ro(job_ids, _foreach_pack_jobid, &pack_info);
 	assoc_mgr_unlock(&locks);
 
 	/* put the real record count in the message body header */
@@ -11504,6 +12662,7 @@ extern void unlink_job_record(job_record_t *job_ptr)
 	job_ptr->job_id = NO_VAL;
 
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	slurm_mutex_lock(&purge_thread_lock);
 	slurm_cond_signal(&purge_thread_cond);
 	slurm_mutex_unlock(&purge_thread_lock);
@@ -12351,6 +13510,7 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 		    (job_desc->burst_buffer[0] == '\0')) {
 			xfree(job_ptr->burst_buffer);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		} else {
 			error_code = ESLURM_NOT_SUPPORTED;
 		}
@@ -12447,6 +13607,7 @@ static int _update_job(job_record_t *job_ptr, job_desc_msg_t *job_desc,
 	if (detail_ptr)
 		mc_ptr = detail_ptr->mc_ptr;
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 
 	/*
 	 * Check to see if the new requested job_desc exceeds any
@@ -16007,6 +17168,7 @@ extern int job_alloc_info_ptr(uint32_t uid, job_record_t *job_ptr)
 	    (bit_overlap_any(power_down_node_bitmap,
 	                     job_ptr->node_bitmap) == 0)) {
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		set_job_alias_list(job_ptr);
 	}
 
@@ -16564,9 +17726,14 @@ void batch_requeue_fini(job_record_t *job_ptr)
 /* job_fini - free all memory associated with job records */
 void job_fini (void)
 {
+	slurm_rwlock_wrlock(&job_pack_cache_lock);
+	for (int i = 0; i < JOB_PACK_CACHE_CNT; i++)
+		_job_pack_cache_clear(&job_pack_cache[i]);
+	slurm_rwlock_unlock(&job_pack_cache_lock);
+
 	FREE_NULL_LIST(job_list);
-	xfree(job_hash);
-	xfree(job_hash_sluid);
+	FREE_NULL_XAHASH_TABLE(job_hash);
+	FREE_NULL_XAHASH_TABLE(job_hash_sluid);
 	xfree(job_array_hash_j);
 	xfree(job_array_hash_t);
 	FREE_NULL_LIST(purge_jobs_list);
@@ -16894,6 +18061,7 @@ extern int job_node_ready(slurm_step_id_t *step_id, int *ready)
 	    (bit_overlap_any(power_down_node_bitmap,
 	                     job_ptr->node_bitmap) == 0)) {
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		set_job_alias_list(job_ptr);
 	}
 
@@ -17050,6 +18218,7 @@ static int _suspend_job_nodes(job_record_t *job_ptr, bool indf_susp)
 		}
 	}
 	last_job_update = last_node_update = now;
+	job_ptr->last_update = time(NULL);
 	return rc;
 }
 
@@ -17100,6 +18269,7 @@ static int _resume_job_nodes(job_record_t *job_ptr, bool indf_susp)
 		node_ptr->node_state = NODE_STATE_ALLOCATED | node_flags;
 	}
 	last_job_update = last_node_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	return rc;
 }
 
@@ -17547,6 +18717,7 @@ static int _job_requeue_op(uid_t uid, job_record_t *job_ptr, bool preempt,
 	}
 
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 
 	/*
 	 * In the job is in the process of completing
@@ -17959,6 +19130,7 @@ static int _set_top(list_t *top_job_list, uid_t uid)
 	int64_t delta_prio, delta_nice, total_delta = 0;
 	int other_job_cnt = 0;
 	uint32_t *prio_elem;
+	time_t now = time(NULL);
 
 	xassert(job_list);
 	xassert(top_job_list);
@@ -18068,6 +19240,7 @@ static int _set_top(list_t *top_job_list, uid_t uid)
 		job_ptr->priority = next_prio;
 		job_ptr->details->nice -= delta_nice;
 		job_ptr->bit_flags &= (~TOP_PRIO_TMP);
+		job_ptr->last_update = now;
 	}
 	list_iterator_destroy(iter);
 	FREE_NULL_LIST(prio_list);
@@ -18086,6 +19259,7 @@ static int _set_top(list_t *top_job_list, uid_t uid)
 			job_ptr->priority = next_prio;
 			job_ptr->details->nice += delta_nice;
 			job_ptr->bit_flags &= (~TOP_PRIO_TMP);
+			job_ptr->last_update = now;
 			total_delta -= delta_nice;
 			if (--other_job_cnt == 0)
 				break;	/* Count will match list size anyway */
@@ -18094,7 +19268,7 @@ static int _set_top(list_t *top_job_list, uid_t uid)
 	}
 	FREE_NULL_LIST(other_job_list);
 
-	last_job_update = time(NULL);
+	last_job_update = now;
 
 	return rc;
 }
@@ -18377,6 +19551,7 @@ extern int update_job_wckey(char *module, job_record_t *job_ptr,
 	}
 
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	return SLURM_SUCCESS;
 }
@@ -18952,6 +20127,7 @@ static void _kill_dependent(job_record_t *job_ptr)
 	job_ptr->end_time = now;
 	job_completion_logger(job_ptr, false);
 	last_job_update = now;
+	job_ptr->last_update = time(NULL);
 	srun_allocate_abort(job_ptr);
 }
 
@@ -120,6 +120,7 @@ typedef enum {
 } sep_depend_t;
 
 typedef struct {
+	xarena_t *arena;
 	bool backfill;
 	bool clear_start;
 	int job_prio_pairs;
@@ -138,6 +139,11 @@ typedef struct {
 	time_t recent;
 } job_is_comp_t;
 
+struct job_queue_heap {
+	job_queue_rec_t **recs;
+	int count;
+};
+
 typedef struct {
 	uint32_t prio;
 	bool set;
@@ -236,6 +242,8 @@ int sched_requests = 0;
 bool sched_running = false;
 bool sched_alive = false;
 static struct timeval sched_last = {0, 0};
+/* Temporaries of one _schedule() cycle, owned by _sched_agent() */
+static xarena_t *sched_arena = NULL;
 
 static uint32_t max_array_size = NO_VAL;
 static bool bf_hetjob_immediate = false;
@@ -291,10 +299,11 @@ static int _queue_resv_list(void *x, void *key)
 	return 0;
 }
 
-static void _job_queue_append(list_t *job_queue, job_record_t *job_ptr,
-			      uint32_t prio)
+static void _job_queue_append(xarena_t *arena, list_t *job_queue,
+			      job_record_t *job_ptr, uint32_t prio)
 {
-	job_queue_req_t job_queue_req = { .job_ptr = job_ptr,
+	job_queue_req_t job_queue_req = { .arena = arena,
+					  .job_ptr = job_ptr,
 					  .job_queue = job_queue,
 					  .part_ptr = job_ptr->part_ptr,
 					  .prio = prio };
@@ -352,6 +361,7 @@ static bool _job_runnable_test1(job_record_t *job_ptr, bool sched_plugin)
 		job_ptr->state_reason = WAIT_CLEANING;
 		xfree(job_ptr->state_desc);
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		sched_debug3("%pJ. State=PENDING. Reason=Cleaning.", job_ptr);
 		return false;
 	}
@@ -370,6 +380,7 @@ static bool _job_runnable_test1(job_record_t *job_ptr, bool sched_plugin)
 			job_ptr->state_reason = WAIT_HELD;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		}
 		sched_debug3("%pJ. State=%s. Reason=%s. Priority=%u.",
 			     job_ptr,
@@ -386,6 +397,7 @@ static bool _job_runnable_test1(job_record_t *job_ptr, bool sched_plugin)
 		job_ptr->state_reason = WAIT_DEPENDENCY;
 		xfree(job_ptr->state_desc);
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 	}
 
 	if (!job_indepen)	/* can not run now */
@@ -413,6 +425,7 @@ static bool _job_runnable_test2(job_record_t *job_ptr, time_t now,
 		job_ptr->state_reason = reason;
 		xfree(job_ptr->state_desc);
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 	}
 	if (reason != WAIT_NO_REASON)
 		return false;
@@ -574,12 +587,12 @@ static int _build_job_queue_for_qos(void *x, void *arg)
 
 	setup_job->job_prio_pairs++;
 	if (job_ptr->prio_mult && job_ptr->prio_mult->priority_array) {
-		_job_queue_append(setup_job->job_queue, job_ptr,
-				  job_ptr->prio_mult->
+		_job_queue_append(setup_job->arena, setup_job->job_queue,
+				  job_ptr, job_ptr->prio_mult->
 				  priority_array[setup_job->prio_inx]);
 	} else {
-		_job_queue_append(setup_job->job_queue, job_ptr,
-				  job_ptr->priority);
+		_job_queue_append(setup_job->arena, setup_job->job_queue,
+				  job_ptr, job_ptr->priority);
 	}
 
 	return 0;
@@ -686,6 +699,7 @@ static int _foreach_build_job_queue(void *x, void *arg)
 		    (job_ptr->state_reason != job_ptr->state_reason_prev_db)) {
 			job_ptr->state_reason_prev_db = job_ptr->state_reason;
 			last_job_update = setup_job->now;
+			job_ptr->last_update = time(NULL);
 		}
 	}
 
@@ -804,14 +818,17 @@ extern void job_queue_rec_resv_list(job_queue_rec_t *job_queue_rec)
  * IN clear_start - if set then clear the start_time for pending jobs,
  *		    true when called from sched/backfill or sched/builtin
  * IN backfill - true if running backfill scheduler, enforce min time limit
+ * IN arena - allocate the job_queue_rec_t records out of this arena, or NULL
  * RET the job queue
  * NOTE: the caller must call FREE_NULL_LIST() on RET value to free memory
  */
-extern list_t *build_job_queue(bool clear_start, bool backfill)
+extern list_t *build_job_queue(bool clear_start, bool backfill,
+			       xarena_t *arena)
 {
 	static time_t last_log_time = 0;
 	split_job_t split_job = { 0 };
 	build_job_queue_for_part_t setup_job = {
+		.arena = arena,
 		.backfill = backfill,
 		.clear_start = clear_start,
 		.last_log_time = &last_log_time,
@@ -820,7 +837,7 @@ extern list_t *build_job_queue(bool clear_start, bool backfill)
 	};
 	/* init the timer */
 	(void) slurm_delta_tv(&setup_job.start_tv);
-	setup_job.job_queue = list_create(xfree_ptr);
+	setup_job.job_queue = list_create(xfree_arena_ptr);
 
 	(void) list_for_each(job_list, _split_job_on_schedule, &split_job);
 
@@ -882,7 +899,7 @@ extern void set_job_elig_time(void)
 	unlock_slurmctld(job_write_lock);
 }
 
-static void _do_diag_stats(long delta_t)
+static void _do_diag_stats(long delta_t, xarena_stats_t *arena_stats)
 {
 	if (delta_t > slurmctld_diag_stats.schedule_cycle_max)
 		slurmctld_diag_stats.schedule_cycle_max = delta_t;
@@ -890,6 +907,10 @@ static void _do_diag_stats(long delta_t)
 	slurmctld_diag_stats.schedule_cycle_sum += delta_t;
 	slurmctld_diag_stats.schedule_cycle_last = delta_t;
 	slurmctld_diag_stats.schedule_cycle_counter++;
+
+	slurmctld_diag_stats.schedule_arena_alloc_cnt = arena_stats->alloc_cnt;
+	slurmctld_diag_stats.schedule_arena_alloc_bytes =
+		arena_stats->alloc_bytes;
 }
 
 /*
@@ -916,6 +937,8 @@ static void *_sched_agent(void *args)
 	int job_cnt;
 	bool full_queue;
 
+	sched_arena = xarena_create(0);
+
 	while (true) {
 		slurm_mutex_lock(&sched_mutex);
 		while (true) {
@@ -972,6 +995,8 @@ static void *_sched_agent(void *args)
 	}
 
 cleanup:
+	xarena_destroy(&sched_arena);
+
 	slurm_mutex_lock(&sched_mutex);
 	xassert(sched_alive);
 	sched_alive = false;
@@ -1020,6 +1045,7 @@ extern bool deadline_ok(job_record_t *job_ptr, const char *func)
 	}
 	if (fail_job) {
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		job_state_set(job_ptr, JOB_DEADLINE);
 		job_ptr->exit_code = 1;
 		job_ptr->state_reason = FAIL_DEADLINE;
@@ -1065,6 +1091,7 @@ extern void fill_array_reasons(job_record_t *job_ptr,
 		xfree(job_ptr->state_desc);
 		job_ptr->state_reason = reject_array_job->state_reason;
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		debug3("%s: Setting reason of array task %pJ to %s",
 		       __func__, job_ptr,
 		       job_state_reason_string(job_ptr->state_reason));
@@ -1073,7 +1100,8 @@ extern void fill_array_reasons(job_record_t *job_ptr,
 
 static job_queue_rec_t *_create_job_queue_rec(job_queue_req_t *job_queue_req)
 {
-	job_queue_rec_t *job_queue_rec = xmalloc(sizeof(*job_queue_rec));
+	job_queue_rec_t *job_queue_rec = xmalloc_arena(job_queue_req->arena,
+						       sizeof(*job_queue_rec));
 	job_queue_rec->array_task_id = job_queue_req->job_ptr->array_task_id;
 	job_queue_rec->job_id   = job_queue_req->job_ptr->job_id;
 	job_queue_rec->job_ptr  = job_queue_req->job_ptr;
@@ -1150,6 +1178,7 @@ static int _get_nodes_in_reservations(void *x, void *arg)
 static int _schedule(bool full_queue)
 {
 	list_t *job_queue = NULL;
+	job_queue_heap_t *job_heap = NULL;
 	int job_cnt = 0;
 	int error_code, i, time_limit, pend_time;
 	uint32_t job_depth = 0, array_task_id;
@@ -1162,6 +1191,7 @@ static int _schedule(bool full_queue)
 	slurmctld_lock_t job_write_lock =
 		{ READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
 	bool is_job_array_head;
+	xarena_stats_t arena_stats;
 	static time_t sched_update = 0;
 	static bool assoc_limit_stop = false;
 	static int sched_timeout = 0;
@@ -1444,7 +1474,8 @@ static int _schedule(bool full_queue)
 
 	/* Avoid resource fragmentation if important */
 	if (reduce_completing_frag) {
-		bitstr_t *eff_cg_bitmap = bit_alloc(node_record_count);
+		bitstr_t *eff_cg_bitmap = bit_alloc_arena(sched_arena,
+							  node_record_count);
 		if (job_is_completing(eff_cg_bitmap)) {
 			part_reduce_frag_t part_reduce_frag = {
 				.eff_cg_bitmap = eff_cg_bitmap,
@@ -1462,9 +1493,10 @@ static int _schedule(bool full_queue)
 	}
 
 	sched_debug("Running job scheduler %s.", full_queue ? "for full queue":"for default depth");
-	job_queue = build_job_queue(false, false);
+	job_queue = build_job_queue(false, false, sched_arena);
 	slurmctld_diag_stats.schedule_queue_len = list_count(job_queue);
-	sort_job_queue(job_queue);
+	job_heap = job_queue_heap_create(job_queue);
+	FREE_NULL_LIST(job_queue);
 
 	job_ptr = NULL;
 	wait_on_resv = false;
@@ -1475,7 +1507,7 @@ static int _schedule(bool full_queue)
 			fill_array_reasons(job_ptr, reject_array_job);
 		}
 
-		job_queue_rec = list_pop(job_queue);
+		job_queue_rec = job_queue_heap_pop(job_heap);
 		if (!job_queue_rec) {
 			_set_schedule_exit(SCHEDULE_EXIT_END);
 			break;
@@ -1494,7 +1526,7 @@ static int _schedule(bool full_queue)
 		if (!job_ptr ||
 		    !IS_JOB_PENDING(job_ptr) || /* started in other part/qos */
 		    !job_ptr->priority) { /* held from fail in other part/qos */
-			xfree(job_queue_rec);
+			xfree_arena(job_queue_rec);
 			continue;
 		}
 
@@ -1507,7 +1539,7 @@ static int _schedule(bool full_queue)
 			job_queue_rec_magnetic_resv(job_queue_rec);
 
 		if (!_job_runnable_test3(job_ptr, part_ptr)) {
-			xfree(job_queue_rec);
+			xfree_arena(job_queue_rec);
 			continue;
 		}
 
@@ -1515,7 +1547,7 @@ static int _schedule(bool full_queue)
 		job_ptr->part_ptr = part_ptr;
 		job_ptr->priority = job_queue_rec->priority;
 
-		xfree(job_queue_rec);
+		xfree_arena(job_queue_rec);
 
 		job_ptr->last_sched_eval = time(NULL);
 
@@ -1570,6 +1602,7 @@ next_task:
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_PRIORITY;
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 			}
 			if (job_ptr->part_ptr == skip_part_ptr)
 				continue;
@@ -1617,6 +1650,7 @@ next_task:
 				job_ptr->state_reason = WAIT_PRIORITY;
 				xfree(job_ptr->state_desc);
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 				sched_debug3("%pJ. State=PENDING. Reason=Priority. Priority=%u. Resv=%s.",
 					     job_ptr,
 					     job_ptr->priority,
@@ -1644,6 +1678,7 @@ next_task:
 				job_ptr->state_reason = WAIT_PRIORITY;
 				xfree(job_ptr->state_desc);
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 			} else {
 				/*
 				 * Log job can not run even though we are not
@@ -1657,6 +1692,7 @@ next_task:
 					     job_ptr->priority);
 			}
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 
 			continue;
 		} else if (wait_on_resv &&
@@ -1685,11 +1721,13 @@ next_task:
 				sched_debug("%pJ has invalid QOS", job_ptr);
 				job_fail_qos(job_ptr, __func__, false);
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
+				job_ptr->last_update = time(NULL);
 			}
 			assoc_mgr_unlock(&locks);
 		}
@@ -1752,6 +1790,7 @@ next_task:
 							   job_ptr->part_ptr->
 							   node_bitmap) ? ", REBOOTING" : "");
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			sched_debug3("%pJ. State=%s. Reason=%s. Priority=%u. Partition=%s.",
 				     job_ptr,
 				     job_state_string(job_ptr->job_state),
@@ -1772,6 +1811,7 @@ next_task:
 			 * very rare. */
 			sched_info("%pJ has invalid account", job_ptr);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			job_ptr->state_reason = FAIL_ACCOUNT;
 			xfree(job_ptr->state_desc);
 			continue;
@@ -1907,6 +1947,7 @@ skip_start:
 			job_ptr->state_reason = WAIT_FED_JOB_LOCK;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			sched_debug3("%pJ. State=%s. Reason=%s. Priority=%u. Partition=%s. Couldn't get federation job lock.",
 				     job_ptr,
 				     job_state_string(job_ptr->job_state),
@@ -1918,6 +1959,7 @@ skip_start:
 			/* job initiated */
 			sched_debug3("%pJ initiated", job_ptr);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 
 			/* Clear assumed rejected array status */
 			reject_array_job = NULL;
@@ -2003,6 +2045,7 @@ skip_start:
 			sched_info("schedule: %pJ non-runnable: %s",
 				   job_ptr, slurm_strerror(error_code));
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			job_state_set(job_ptr, JOB_PENDING);
 			job_ptr->state_reason = FAIL_BAD_CONSTRAINTS;
 			xfree(job_ptr->state_desc);
@@ -2107,7 +2150,8 @@ fail_this_part:	if (fail_by_part) {
 				 * cleared.
 				 */
 				bitstr_t *remove_nodes =
-					bit_alloc(node_record_count);
+					bit_alloc_arena(sched_arena,
+							node_record_count);
 
 				list_for_each(resv_list,
 					      _get_nodes_in_reservations,
@@ -2133,7 +2177,8 @@ fail_this_part:	if (fail_by_part) {
 		job_resv_clear_magnetic_flag(job_ptr);
 	FREE_NULL_BITMAP(avail_node_bitmap);
 	avail_node_bitmap = save_avail_node_bitmap;
-	FREE_NULL_LIST(job_queue);
+	job_queue_heap_free(job_heap);
+	xarena_reset(sched_arena, &arena_stats);
 
 	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
 	if ((slurmctld_config.server_thread_count >= 150) &&
@@ -2145,21 +2190,12 @@ fail_this_part:	if (fail_by_part) {
 	unlock_slurmctld(job_write_lock);
 	END_TIMER2(__func__);
 
-	_do_diag_stats(TIMER_DURATION_USEC());
+	_do_diag_stats(TIMER_DURATION_USEC(), &arena_stats);
 
 out:
 	return job_cnt;
 }
 
-/*
- * sort_job_queue - sort job_queue in descending priority order
- * IN/OUT job_queue - sorted job queue
- */
-extern void sort_job_queue(list_t *job_queue)
-{
-	list_sort(job_queue, sort_job_queue2);
-}
-
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
  * in order of decreasing priority then submit time and the by increasing
  * job id */
@@ -2354,6 +2390,72 @@ extern int sort_job_queue2(void *x, void *y)
 	return 0;
 }
 
+/* Return true if record at inx1 should be scheduled before record at inx2 */
+static bool _heap_before(job_queue_heap_t *heap, int inx1, int inx2)
+{
+	return (sort_job_queue2(&heap->recs[inx1], &heap->recs[inx2]) < 0);
+}
+
+static void _heap_sift_down(job_queue_heap_t *heap, int inx)
+{
+	while (true) {
+		int first = inx;
+		int left = (2 * inx) + 1;
+		int right = left + 1;
+
+		if ((left < heap->count) && _heap_before(heap, left, first))
+			first = left;
+		if ((right < heap->count) && _heap_before(heap, right, first))
+			first = right;
+		if (first == inx)
+			return;
+
+		SWAP(heap->recs[inx], heap->recs[first]);
+		inx = first;
+	}
+}
+
+extern job_queue_heap_t *job_queue_heap_create(list_t *job_queue)
+{
+	job_queue_heap_t *heap = xmalloc(sizeof(*heap));
+	job_queue_rec_t *job_queue_rec;
+
+	heap->recs = xcalloc(list_count(job_queue), sizeof(*heap->recs));
+	while ((job_queue_rec = list_pop(job_queue)))
+		heap->recs[heap->count++] = job_queue_rec;
+
+	for (int i = (heap->count / 2) - 1; i >= 0; i--)
+		_heap_sift_down(heap, i);
+
+	return heap;
+}
+
+extern job_queue_rec_t *job_queue_heap_pop(job_queue_heap_t *heap)
+{
+	job_queue_rec_t *job_queue_rec;
+
+	if (!heap || !heap->count)
+		return NULL;
+
+	job_queue_rec = heap->recs[0];
+	heap->recs[0] = heap->recs[--heap->count];
+	heap->recs[heap->count] = NULL;
+	_heap_sift_down(heap, 0);
+
+	return job_queue_rec;
+}
+
+extern void job_queue_heap_free(job_queue_heap_t *heap)
+{
+	if (!heap)
+		return;
+
+	for (int i = 0; i < heap->count; i++)
+		xfree_arena(heap->recs[i]);
+	xfree(heap->recs);
+	xfree(heap);
+}
+
 /* The environment" variable is points to one big xmalloc. In order to
  * manipulate the array for a hetjob, we need to split it into an array
  * containing multiple xmalloc variables */
@@ -2521,6 +2623,7 @@ job_failed:
 	job_ptr->state_desc = xstrdup(fail_why);
 	job_ptr->state_reason = FAIL_SYSTEM;
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	slurm_free_job_launch_msg(launch_msg_ptr);
 	/* ignore the return as job is in an unknown state anyway */
 	job_complete(&step_id, slurm_conf.slurm_user_id, false, false, 1);
@@ -3451,6 +3554,7 @@ extern int test_job_dependency(job_record_t *job_ptr, bool *was_changed)
 		job_ptr->state_reason = WAIT_NO_REASON;
 		xfree(job_ptr->state_desc);
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 	}
 
 	if (test_job_dep.or_satisfied ||
@@ -3960,6 +4064,7 @@ extern int handle_job_dependency_updates(void *object, void *arg)
 			job_ptr->state_reason = WAIT_NO_REASON;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		}
 		_depend_list2str(job_ptr, false);
 		fed_mgr_job_requeue(job_ptr);
@@ -3976,6 +4081,7 @@ extern int handle_job_dependency_updates(void *object, void *arg)
 			job_ptr->state_reason = WAIT_DEPENDENCY;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		}
 	}
 	if (slurm_conf.debug_flags & DEBUG_FLAG_DEPENDENCY)
@@ -5709,6 +5815,7 @@ extern void rebuild_job_part_list(job_record_t *job_ptr)
 	if (!job_ptr->part_ptr_list) {
 		job_ptr->partition = xstrdup(job_ptr->part_ptr->name);
 		last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
 		return;
 	}
 
@@ -5719,6 +5826,7 @@ extern void rebuild_job_part_list(job_record_t *job_ptr)
 		arg.flags |= REBUILD_PENDING;
 	list_for_each(job_ptr->part_ptr_list, _build_partition_string, &arg);
 	last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 }
 
 /* cleanup_completing()
@@ -106,10 +106,12 @@ extern void job_queue_rec_resv_list(job_queue_rec_t *job_queue_rec);
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs
  * IN backfill - true if running backfill scheduler, enforce min time limit
+ * IN arena - allocate the job_queue_rec_t records out of this arena, or NULL
  * RET the job queue
  * NOTE: the caller must call list_destroy() on RET value to free memory
  */
-extern list_t *build_job_queue(bool clear_start, bool backfill);
+extern list_t *build_job_queue(bool clear_start, bool backfill,
+			       xarena_t *arena);
 
 /* Given a scheduled job, return a pointer to it batch_job_launch_msg_t data */
 extern batch_job_launch_msg_t *build_launch_job_msg(job_record_t *job_ptr,
@@ -237,16 +239,30 @@ extern void schedule(bool full_queue);
  */
 extern void set_job_elig_time(void);
 
-/*
- * sort_job_queue - sort job_queue in descending priority order
- * IN/OUT job_queue - sorted job queue previously made by build_job_queue()
- */
-extern void sort_job_queue(list_t *job_queue);
-
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
  *	in order of decreasing priority */
 extern int sort_job_queue2(void *x, void *y);
 
+/* Binary heap of job_queue_rec_t ordered by sort_job_queue2() */
+typedef struct job_queue_heap job_queue_heap_t;
+
+/*
+ * job_queue_heap_create - order a job_queue previously made by
+ *	build_job_queue() for consumption in descending priority order.
+ *	Building the heap is linear in the queue length and each
+ *	job_queue_heap_pop() is logarithmic, so consumers that stop early
+ *	(queue depth, time limits) don't pay for sorting the whole queue.
+ * IN/OUT job_queue - records are moved out of it, leaving it empty
+ * RET heap, free with job_queue_heap_free()
+ */
+extern job_queue_heap_t *job_queue_heap_create(list_t *job_queue);
+
+/* Remove and return the highest priority record, or NULL if empty */
+extern job_queue_rec_t *job_queue_heap_pop(job_queue_heap_t *heap);
+
+/* Free a heap and any records remaining in it */
+extern void job_queue_heap_free(job_queue_heap_t *heap);
+
 /*
  * Determine if a job's dependencies are met
  * Inputs: job_ptr
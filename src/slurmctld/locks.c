@@ -40,12 +40,20 @@
 #include <errno.h>
 #include <pthread.h>
 #include <string.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
+#include "src/common/slurm_time.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
-static pthread_rwlock_t slurmctld_locks[6] = {
+typedef struct {
+	uint64_t wait_cnt;
+	uint64_t wait_time;
+	uint64_t wait_max;
+} lock_stats_t;
+
+static pthread_rwlock_t slurmctld_locks[LOCK_DATATYPE_COUNT] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
 	PTHREAD_RWLOCK_INITIALIZER,
@@ -54,6 +62,9 @@ static pthread_rwlock_t slurmctld_locks[6] = {
 	PTHREAD_RWLOCK_INITIALIZER,
 };
 
+static pthread_mutex_t lock_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static lock_stats_t lock_stats[LOCK_STATS_COUNT];
+
 #ifndef NDEBUG
 /*
  * Used to protect against double-locking within a single thread. Calling
@@ -107,40 +118,61 @@ extern bool verify_lock(lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+/*
+ * Acquire one lock, only timing the request if the lock is not immediately
+ * available so that uncontended requests don't pay for the statistics.
+ */
+static void _lock(lock_datatype_t datatype, lock_level_t level)
+{
+	pthread_rwlock_t *rwlock = &slurmctld_locks[datatype];
+	struct timeval start = { 0, 0 };
+	lock_stats_t *stats;
+	uint64_t delta;
+
+	if (level == READ_LOCK) {
+		if (!slurm_rwlock_tryrdlock(rwlock))
+			return;
+		(void) slurm_delta_tv(&start);
+		slurm_rwlock_rdlock(rwlock);
+	} else {
+		if (!slurm_rwlock_trywrlock(rwlock))
+			return;
+		(void) slurm_delta_tv(&start);
+		slurm_rwlock_wrlock(rwlock);
+	}
+	delta = slurm_delta_tv(&start);
+
+	stats = &lock_stats[(datatype * 2) + (level == WRITE_LOCK)];
+	slurm_mutex_lock(&lock_stats_mutex);
+	stats->wait_cnt++;
+	stats->wait_time += delta;
+	if (delta > stats->wait_max)
+		stats->wait_max = delta;
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
+
 /* lock_slurmctld - Issue the required lock requests in a well defined order */
 extern void lock_slurmctld(slurmctld_lock_t lock_levels)
 {
 	xassert(_store_locks(lock_levels));
 
-	if (lock_levels.conf == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[CONF_LOCK]);
-	else if (lock_levels.conf == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[CONF_LOCK]);
-
-	if (lock_levels.job == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[JOB_LOCK]);
-	else if (lock_levels.job == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[JOB_LOCK]);
-
-	if (lock_levels.node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[NODE_LOCK]);
-	else if (lock_levels.node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[NODE_LOCK]);
-
-	if (lock_levels.part == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[PART_LOCK]);
-	else if (lock_levels.part == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[PART_LOCK]);
-
-	if (lock_levels.fed == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[FED_LOCK]);
-	else if (lock_levels.fed == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[FED_LOCK]);
-
-	if (lock_levels.select_node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[SELECT_NODE_LOCK]);
-	else if (lock_levels.select_node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[SELECT_NODE_LOCK]);
+	if (lock_levels.conf)
+		_lock(CONF_LOCK, lock_levels.conf);
+
+	if (lock_levels.job)
+		_lock(JOB_LOCK, lock_levels.job);
+
+	if (lock_levels.node)
+		_lock(NODE_LOCK, lock_levels.node);
+
+	if (lock_levels.part)
+		_lock(PART_LOCK, lock_levels.part);
+
+	if (lock_levels.fed)
+		_lock(FED_LOCK, lock_levels.fed);
+
+	if (lock_levels.select_node)
+		_lock(SELECT_NODE_LOCK, lock_levels.select_node);
 }
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
@@ -210,3 +242,22 @@ int report_locks_set(void)
 	}
 	return lock_count;
 }
+
+extern void get_lock_stats(uint64_t *wait_cnt, uint64_t *wait_time,
+			   uint64_t *wait_max)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	for (int i = 0; i < LOCK_STATS_COUNT; i++) {
+		wait_cnt[i] = lock_stats[i].wait_cnt;
+		wait_time[i] = lock_stats[i].wait_time;
+		wait_max[i] = lock_stats[i].wait_max;
+	}
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
+
+extern void reset_lock_stats(void)
+{
+	slurm_mutex_lock(&lock_stats_mutex);
+	memset(lock_stats, 0, sizeof(lock_stats));
+	slurm_mutex_unlock(&lock_stats_mutex);
+}
@@ -92,6 +92,7 @@
 #define _SLURMCTLD_LOCKS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* levels of locking required for each data structure */
 typedef enum {
@@ -117,8 +118,15 @@ typedef enum {
 	PART_LOCK,
 	FED_LOCK,
 	SELECT_NODE_LOCK,
+	LOCK_DATATYPE_COUNT, /* Must be last */
 }	lock_datatype_t;
 
+/*
+ * Lock wait statistics are kept per lock_datatype_t and per level, at index
+ * ((datatype * 2) + (level == WRITE_LOCK)).
+ */
+#define LOCK_STATS_COUNT (LOCK_DATATYPE_COUNT * 2)
+
 #ifndef NDEBUG
 extern bool verify_lock(lock_datatype_t datatype, lock_level_t level);
 #endif
@@ -132,4 +140,16 @@ extern void unlock_slurmctld (slurmctld_lock_t lock_levels);
 
 extern int report_locks_set(void);
 
+/*
+ * Get lock wait statistics, only lock requests which had to block are counted
+ * OUT wait_cnt - array of LOCK_STATS_COUNT, count of blocked lock requests
+ * OUT wait_time - array of LOCK_STATS_COUNT, total usec spent blocked
+ * OUT wait_max - array of LOCK_STATS_COUNT, max usec spent blocked
+ */
+extern void get_lock_stats(uint64_t *wait_cnt, uint64_t *wait_time,
+			   uint64_t *wait_max);
+
+/* Clear lock wait statistics */
+extern void reset_lock_stats(void);
+
 #endif
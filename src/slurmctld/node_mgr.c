@@ -306,6 +306,7 @@ extern int load_all_node_state ( bool state_only )
 	hostlist_t *down_nodes = NULL;
 	bool power_save_mode = false;
 	uint16_t protocol_version = NO_VAL16;
+	DEF_TIMERS;
 
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 
@@ -313,6 +314,7 @@ extern int load_all_node_state ( bool state_only )
 		power_save_mode = true;
 
 	/* read the file */
+	START_TIMER;
 	buffer = state_save_open("node_state", &state_file);
 	if (!buffer) {
 		if ((clustername_existed == 1) && (!ignore_state_errors))
@@ -783,7 +785,8 @@ extern int load_all_node_state ( bool state_only )
 		purge_node_rec(node_state_rec);
 	}
 
-fini:	info("Recovered state of %d nodes", node_cnt);
+fini:	END_TIMER;
+	info("Recovered state of %d nodes in %s", node_cnt, TIMER_STR());
 	if (hs) {
 		char *node_names = hostset_ranged_string_xmalloc(hs);
 		info("Cleared POWER_SAVE flag from nodes %s", node_names);
@@ -2277,6 +2280,7 @@ extern void restore_node_features(int recover)
 			} else {
 				node_ptr->weight = node_ptr->config_ptr->
 						   weight;
+				node_conf_weight_changed();
 			}
 		}
 		if (xstrcmp(node_ptr->config_ptr->feature, node_ptr->features)){
@@ -4361,6 +4365,7 @@ void make_node_idle(node_record_t *node_ptr, job_record_t *job_ptr)
 	if (node_bitmap && (bit_test(node_bitmap, node_ptr->index))) {
 		/* Not a replay */
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		bit_clear(node_bitmap, node_ptr->index);
 
 		if (!IS_JOB_FINISHED(job_ptr))
@@ -1239,15 +1239,14 @@ static int _get_req_features(struct node_set *node_set_ptr, int node_set_size,
 				    (prev_node_set_ptr->flags &
 				     NODE_SET_REBOOT))
 					continue;
+				/* No inactive nodes (require reboot) */
+				if (bit_super_set(node_set_ptr[i].my_bitmap,
+						  feat_ptr->node_bitmap_active))
+					continue;
 				inactive_bitmap =
 					bit_copy(node_set_ptr[i].my_bitmap);
 				bit_and_not(inactive_bitmap,
 					    feat_ptr->node_bitmap_active);
-				if (bit_ffs(inactive_bitmap) == -1) {
-					/* No inactive nodes (require reboot) */
-					FREE_NULL_BITMAP(inactive_bitmap);
-					continue;
-				}
 				sort_again = true;
 				if (bit_equal(prev_node_set_ptr->my_bitmap,
 					      inactive_bitmap)) {
@@ -2382,6 +2381,7 @@ static int _get_resv_mpi_ports(job_record_t *job_ptr,
 			job_ptr->end_time = 0;
 			job_ptr->state_reason = WAIT_RESOURCES;
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			xfree(job_ptr->state_desc);
 			return error_code;
 		}
@@ -2451,6 +2451,7 @@ static int _get_resv_mpi_ports(job_record_t *job_ptr,
 			job_ptr->end_time = 0;
 			job_ptr->state_reason = WAIT_MPI_PORTS_BUSY;
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			xfree(job_ptr->state_desc);
 		}
 	}
@@ -2568,6 +2569,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 		debug2("%s: %s", __func__, job_ptr->state_desc);
 		job_ptr->state_reason = WAIT_ACCOUNT;
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		return ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE;
 	}
 
@@ -2589,6 +2591,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 			return ESLURM_BURST_BUFFER_WAIT; /* Fatal BB event */
 		xfree(job_ptr->state_desc);
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		if (bb == 0)
 			job_ptr->state_reason = WAIT_BURST_BUFFER_STAGING;
 		else
@@ -2678,24 +2681,29 @@ extern int select_nodes(job_node_select_t *job_node_select,
 		selected_node_cnt = req_nodes;
 
 	if (!test_only && select_bitmap && (max_powered_nodes != NO_VAL)) {
-		bitstr_t *tmp = bit_copy(select_bitmap);
 		hostlist_t *select = NULL, *need = NULL;
 		char *select_str = NULL, *need_str = NULL;
-		int32_t count, powerup_count, before_count = 0;
+		int32_t count, powerup_count, before_count;
 
 		/* selected and powered down */
-		bit_and(tmp, power_down_node_bitmap);
-		powerup_count = bit_set_count(tmp);
+		powerup_count = bit_overlap(select_bitmap,
+					    power_down_node_bitmap);
+		before_count = bit_set_count(power_up_node_bitmap);
+		/* powered up after adding selected and powered down nodes */
+		count = before_count + bit_overlap_not(select_bitmap,
+						       power_down_node_bitmap,
+						       power_up_node_bitmap);
 		if (slurm_conf.debug_flags & DEBUG_FLAG_POWER) {
+			bitstr_t *tmp = bit_copy(select_bitmap);
+
+			bit_and(tmp, power_down_node_bitmap);
 			select = bitmap2hostlist(select_bitmap);
 			select_str = slurm_hostlist_ranged_string_xmalloc(
 				select);
 			need = bitmap2hostlist(tmp);
 			need_str = slurm_hostlist_ranged_string_xmalloc(need);
-			before_count = bit_set_count(power_up_node_bitmap);
+			FREE_NULL_BITMAP(tmp);
 		}
-		bit_or(tmp, power_up_node_bitmap);
-		count = bit_set_count(tmp);
 		log_flag(POWER, "Need to power up %d nodes (%s) from (%s). powered up count before: %d after: %d",
 			 powerup_count, need_str, select_str, before_count,
 			 count);
@@ -2706,7 +2714,6 @@ extern int select_nodes(job_node_select_t *job_node_select,
 				 __func__, job_ptr);
 		}
 
-		FREE_NULL_BITMAP(tmp);
 		FREE_NULL_HOSTLIST(need);
 		FREE_NULL_HOSTLIST(select);
 		xfree(select_str);
@@ -2791,6 +2798,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 			job_ptr->state_reason = WAIT_PART_NODE_LIMIT;
 			xfree(job_ptr->state_desc);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 
 		/* Non-fatal errors for job below */
 		} else if (error_code == ESLURM_NODE_NOT_AVAIL) {
@@ -2828,6 +2836,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 			}
 			xfree(unavail_node);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 		} else if (error_code == ESLURM_RESERVATION_MAINT) {
 			error_code = ESLURM_RESERVATION_BUSY;	/* All reserved */
 			job_ptr->state_reason = WAIT_NODE_NOT_AVAIL;
@@ -2940,6 +2949,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 		job_ptr->priority = 0;
 		job_ptr->state_reason = WAIT_HELD;
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		goto cleanup;
 	}
 	if (select_g_job_begin(job_ptr) != SLURM_SUCCESS) {
@@ -2955,6 +2965,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 		job_ptr->end_time = 0;
 		job_ptr->state_reason = WAIT_RESOURCES;
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		goto cleanup;
 	}
 
@@ -2978,6 +2989,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 		job_ptr->end_time = 0;
 		job_ptr->state_reason = WAIT_RESOURCES;
 		last_job_update = now;
+		job_ptr->last_update = time(NULL);
 		goto cleanup;
 	}
 
@@ -3006,6 +3018,7 @@ extern int select_nodes(job_node_select_t *job_node_select,
 			job_ptr->state_reason = WAIT_RESOURCES;
 			job_state_set(job_ptr, JOB_PENDING);
 			last_job_update = now;
+			job_ptr->last_update = time(NULL);
 			goto cleanup;
 		}
 	}
@@ -4470,7 +4483,6 @@ static bitstr_t *_valid_features(job_record_t *job_ptr,
 	job_details_t *details_ptr = job_ptr->details;
 	bitstr_t *result_node_bitmap = NULL, *paren_node_bitmap = NULL;
 	bitstr_t *working_node_bitmap, *active_node_bitmap = NULL;
-	bitstr_t *tmp_node_bitmap = NULL;
 	list_itr_t *feat_iter;
 	job_feature_t *job_feat_ptr;
 	int last_op = FEATURE_OP_AND, paren_op = FEATURE_OP_AND;
@@ -4560,12 +4572,9 @@ static bitstr_t *_valid_features(job_record_t *job_ptr,
 				bit_set(result_node_bitmap, position);
 				if (can_reboot && reboot_bitmap &&
 				    active_node_bitmap) {
-					tmp_node_bitmap = bit_copy(config_ptr->
-								   node_bitmap);
-					bit_and_not(tmp_node_bitmap,
-						    active_node_bitmap);
-					bit_or(reboot_bitmap, tmp_node_bitmap);
-					FREE_NULL_BITMAP(tmp_node_bitmap);
+					bit_or_and_not(reboot_bitmap,
+						       config_ptr->node_bitmap,
+						       active_node_bitmap);
 				}
 			}
 			position++;
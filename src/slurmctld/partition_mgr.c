@@ -60,6 +60,7 @@
 #include "src/common/slurm_protocol_pack.h"
 #include "src/common/slurm_resource_info.h"
 #include "src/common/state_save.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xstring.h"
 
@@ -427,6 +428,7 @@ extern int load_all_part_state(uint16_t reconfig_flags)
 	buf_t *buffer;
 	char *ver_str = NULL;
 	uint16_t protocol_version = NO_VAL16;
+	DEF_TIMERS;
 
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 
@@ -437,6 +439,7 @@ extern int load_all_part_state(uint16_t reconfig_flags)
 	}
 
 	/* read the file */
+	START_TIMER;
 	buffer = state_save_open("part_state", &state_file);
 	if (!buffer) {
 		info("No partition state file (%s) to recover",
@@ -622,7 +625,8 @@ extern int load_all_part_state(uint16_t reconfig_flags)
 		part_record_delete(part_rec_state);
 	}
 
-	info("Recovered state of %d partitions", part_cnt);
+	END_TIMER;
+	info("Recovered state of %d partitions in %s", part_cnt, TIMER_STR());
 	FREE_NULL_BUFFER(buffer);
 	return error_code;
 
@@ -630,7 +634,8 @@ unpack_error:
 	if (!ignore_state_errors)
 		fatal("Incomplete partition data checkpoint file, start with '-i' to ignore this. Warning: using -i will lose the data that can't be recovered.");
 	error("Incomplete partition data checkpoint file");
-	info("Recovered state of %d partitions", part_cnt);
+	END_TIMER;
+	info("Recovered state of %d partitions in %s", part_cnt, TIMER_STR());
 	FREE_NULL_BUFFER(buffer);
 	return EFAULT;
 }
@@ -2172,6 +2177,7 @@ extern int part_policy_valid_qos(part_record_t *part_ptr,
 				job_ptr->state_desc = tmp_err;
 				job_ptr->state_reason = WAIT_QOS;
 				last_job_update = time(NULL);
+				job_ptr->last_update = time(NULL);
 			} else {
 				xfree(tmp_err);
 			}
@@ -2192,6 +2198,7 @@ extern int part_policy_valid_qos(part_record_t *part_ptr,
 				job_ptr->state_desc = tmp_err;
 				job_ptr->state_reason = WAIT_QOS;
 				last_job_update = time(NULL);
+				job_ptr->last_update = time(NULL);
 			} else {
 				xfree(tmp_err);
 			}
@@ -2219,6 +2226,7 @@ extern int part_policy_valid_qos(part_record_t *part_ptr,
 				job_ptr->state_desc = tmp_err;
 				job_ptr->state_reason = WAIT_QOS;
 				last_job_update = time(NULL);
+				job_ptr->last_update = time(NULL);
 			} else {
 				xfree(tmp_err);
 			}
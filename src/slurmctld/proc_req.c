@@ -127,6 +127,7 @@ static uint16_t rpc_type_queued[RPC_TYPE_SIZE] = { 0 };
 static uint64_t rpc_type_dropped[RPC_TYPE_SIZE] = { 0 };
 static uint16_t rpc_type_cycle_last[RPC_TYPE_SIZE] = { 0 };
 static uint16_t rpc_type_cycle_max[RPC_TYPE_SIZE] = { 0 };
+static uint64_t rpc_type_coalesced[RPC_TYPE_SIZE] = { 0 };
 #define RPC_USER_SIZE 200
 static uint32_t rpc_user_id[RPC_USER_SIZE] = { 0 };
 static uint32_t rpc_user_cnt[RPC_USER_SIZE] = { 0 };
@@ -204,6 +205,7 @@ extern void record_rpc_queue_stats(slurmctld_rpc_t *q)
 		rpc_type_dropped[i] = q->dropped;
 		rpc_type_cycle_last[i] = q->cycle_last;
 		rpc_type_cycle_max[i] = q->cycle_max;
+		rpc_type_coalesced[i] = q->coalesced;
 		break;
 	}
 	slurm_mutex_unlock(&rpc_mutex);
@@ -1439,6 +1441,7 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 {
 	DEF_TIMERS;
 	buf_t *buffer = NULL;
+	bool shared = false;
 	job_info_request_msg_t *job_info_request_msg = msg->data;
 	/* Locks: Read config job part */
 	slurmctld_lock_t job_read_lock = {
@@ -1459,10 +1462,15 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 						job_info_request_msg->show_flags,
 						msg->auth_uid, NO_VAL,
 						msg->protocol_version);
+		} else if ((buffer = rpc_queue_coalesce_get(
+				    msg, job_info_request_msg->show_flags))) {
+			shared = true;
 		} else {
 			buffer = pack_all_jobs(job_info_request_msg->show_flags,
 					       msg->auth_uid, NO_VAL,
 					       msg->protocol_version);
+			shared = rpc_queue_coalesce_add(
+				msg, job_info_request_msg->show_flags, buffer);
 		}
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(job_read_lock);
@@ -1470,7 +1478,8 @@ static void _slurm_rpc_dump_jobs(slurm_msg_t *msg)
 
 		/* send message */
 		(void) send_msg_response(msg, RESPONSE_JOB_INFO, buffer);
-		FREE_NULL_BUFFER(buffer);
+		if (!shared)
+			FREE_NULL_BUFFER(buffer);
 	}
 }
 
@@ -1688,6 +1697,7 @@ static void _slurm_rpc_dump_nodes(slurm_msg_t *msg)
 {
 	DEF_TIMERS;
 	buf_t *buffer;
+	bool shared = false;
 	node_info_request_msg_t *node_req_msg = msg->data;
 	/* Locks: Read config, read node, write select_node (reset allocated CPU
 	 * count in some select plugins), read part (for part_is_visible) */
@@ -1718,15 +1728,24 @@ static void _slurm_rpc_dump_nodes(slurm_msg_t *msg)
 		debug3("%s, no change", __func__);
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
-		buffer = pack_all_nodes(node_req_msg->show_flags,
-					msg->auth_uid, msg->protocol_version);
+		if ((buffer = rpc_queue_coalesce_get(
+			     msg, node_req_msg->show_flags))) {
+			shared = true;
+		} else {
+			buffer = pack_all_nodes(node_req_msg->show_flags,
+						msg->auth_uid,
+						msg->protocol_version);
+			shared = rpc_queue_coalesce_add(
+				msg, node_req_msg->show_flags, buffer);
+		}
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(node_write_lock);
 		END_TIMER2(__func__);
 
 		/* send message */
 		(void) send_msg_response(msg, RESPONSE_NODE_INFO, buffer);
-		FREE_NULL_BUFFER(buffer);
+		if (!shared)
+			FREE_NULL_BUFFER(buffer);
 	}
 }
 
@@ -1778,6 +1797,7 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t *msg)
 {
 	DEF_TIMERS;
 	buf_t *buffer = NULL;
+	bool shared = false;
 	part_info_request_msg_t *part_req_msg = msg->data;
 
 	/* Locks: Read configuration and partition */
@@ -1802,15 +1822,24 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t *msg)
 		debug2("%s, no change", __func__);
 		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
 	} else {
-		buffer = pack_all_part(part_req_msg->show_flags, msg->auth_uid,
-				       msg->protocol_version);
+		if ((buffer = rpc_queue_coalesce_get(
+			     msg, part_req_msg->show_flags))) {
+			shared = true;
+		} else {
+			buffer = pack_all_part(part_req_msg->show_flags,
+					       msg->auth_uid,
+					       msg->protocol_version);
+			shared = rpc_queue_coalesce_add(
+				msg, part_req_msg->show_flags, buffer);
+		}
 		if (!(msg->flags & CTLD_QUEUE_PROCESSING))
 			unlock_slurmctld(part_read_lock);
 		END_TIMER2(__func__);
 
 		/* send message */
 		(void) send_msg_response(msg, RESPONSE_PARTITION_INFO, buffer);
-		FREE_NULL_BUFFER(buffer);
+		if (!shared)
+			FREE_NULL_BUFFER(buffer);
 	}
 }
 
@@ -5585,6 +5614,7 @@ static void _clear_rpc_stats(void)
 	memset(rpc_type_dropped, 0, sizeof(rpc_type_dropped));
 	memset(rpc_type_cycle_last, 0, sizeof(rpc_type_cycle_last));
 	memset(rpc_type_cycle_max, 0, sizeof(rpc_type_cycle_max));
+	memset(rpc_type_coalesced, 0, sizeof(rpc_type_coalesced));
 	memset(rpc_user_cnt, 0, sizeof(rpc_user_cnt));
 	memset(rpc_user_id, 0, sizeof(rpc_user_id));
 	memset(rpc_user_time, 0, sizeof(rpc_user_time));
@@ -5612,6 +5642,9 @@ static void _pack_rpc_stats(buf_t *buffer, uint16_t protocol_version)
 			pack64_array(rpc_type_dropped, rpc_count, buffer);
 			pack16_array(rpc_type_cycle_last, rpc_count, buffer);
 			pack16_array(rpc_type_cycle_max, rpc_count, buffer);
+			if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION)
+				pack64_array(rpc_type_coalesced, rpc_count,
+					     buffer);
 		}
 
 		/* user_count starts at 1 as root is in index 0 */
@@ -6553,6 +6586,7 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 		.msg_type = REQUEST_JOB_INFO,
 		.func = _slurm_rpc_dump_jobs,
 		.queue_enabled = true,
+		.coalesce = true,
 		.locks = {
 			.conf = READ_LOCK,
 			.job = READ_LOCK,
@@ -6612,6 +6646,7 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 		.msg_type = REQUEST_NODE_INFO,
 		.func = _slurm_rpc_dump_nodes,
 		.queue_enabled = true,
+		.coalesce = true,
 		.locks = {
 			.conf = READ_LOCK,
 			.node = READ_LOCK,
@@ -6625,6 +6660,7 @@ slurmctld_rpc_t slurmctld_rpcs[] =
 		.msg_type = REQUEST_PARTITION_INFO,
 		.func = _slurm_rpc_dump_partitions,
 		.queue_enabled = true,
+		.coalesce = true,
 		.locks = {
 			.conf = READ_LOCK,
 			.part = READ_LOCK,
@@ -67,6 +67,7 @@ typedef struct {
 	bool shutdown;
 	bool keep_msg; /* skip freeing msg and closing connection */
 	bool rl_exempt; /* ignore this rpc for rate limiting */
+	bool coalesce; /* share packed responses within one queue cycle */
 
 	int yield_sleep; /* usec sleep between cycles when busy */
 	int interval; /* usec sleep after cycle if no longer busy */
@@ -80,12 +81,14 @@ typedef struct {
 	pthread_mutex_t mutex;
 
 	list_t *work;
+	list_t *responses; /* packed this cycle, only touched by worker */
 
 	/* Queue processing statistics */
 	uint16_t queued;
 	uint64_t dropped;
 	uint16_t cycle_last;
 	uint16_t cycle_max;
+	uint64_t coalesced; /* responses reused from earlier in a cycle */
 } slurmctld_rpc_t;
 
 extern slurmctld_rpc_t slurmctld_rpcs[];
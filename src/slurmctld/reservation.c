@@ -68,6 +68,7 @@
 #include "src/common/slurm_time.h"
 #include "src/common/state_save.h"
 #include "src/common/threadpool.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
@@ -130,6 +131,35 @@ list_t *resv_list = NULL;
 static list_t *magnetic_resv_list = NULL;
 uint32_t  top_suffix = 0;
 
+/*
+ * Time windows of all reservations, used by job_test_resv() and
+ * find_resv_end() so they need not walk all of resv_list for every job.
+ * Rebuilt lazily once reservations are added, removed or altered.
+ */
+typedef struct {
+	time_t end_relative;
+	uint32_t list_inx;	/* Position in resv_list */
+	slurmctld_resv_t *resv_ptr;
+	time_t start_relative;
+} resv_time_ent_t;
+
+typedef struct {
+	time_t advance_time;	/* Rebuild once a recurring resv ends */
+	time_t build_time;
+	time_t *end_times;	/* end_time of every resv, sorted */
+	resv_time_ent_t *ents;	/* Sorted by start_relative */
+	int ents_cnt;
+	resv_time_ent_t *float_ents; /* TIME_FLOAT, moving with time */
+	int float_cnt;
+	time_t max_boot_time;
+	int resv_cnt;
+	int size;
+	bool stale;
+} resv_time_index_t;
+
+static pthread_mutex_t resv_time_mutex = PTHREAD_MUTEX_INITIALIZER;
+static resv_time_index_t resv_time_index = { .stale = true };
+
 typedef struct constraint_slot {
 	time_t start;
 	time_t end;
@@ -170,6 +200,7 @@ static int  _generate_resv_id(void);
 static void _generate_resv_name(resv_desc_msg_t *resv_ptr);
 static int  _get_core_resrcs(slurmctld_resv_t *resv_ptr);
 static uint32_t _get_job_duration(job_record_t *job_ptr, bool reboot);
+static void _invalidate_resv_time_index(void);
 static bool _is_account_valid(char *account);
 static bool _is_resv_used(slurmctld_resv_t *resv_ptr);
 static bool _job_overlap(time_t start_time, uint64_t flags,
@@ -727,6 +758,7 @@ static void _del_resv_rec(void *x)
 	slurmctld_resv_t *resv_ptr = (slurmctld_resv_t *) x;
 
 	if (resv_ptr) {
+		_invalidate_resv_time_index();
 		/*
 		 * If shutting down magnetic_resv_list is already freed, meaning
 		 * we don't need to remove anything from it.
@@ -793,6 +825,7 @@ static void _add_resv_to_lists(slurmctld_resv_t *resv_ptr)
 	xassert(resv_list);
 	xassert(magnetic_resv_list);
 
+	_invalidate_resv_time_index();
 	list_append(resv_list, resv_ptr);
 	if (resv_ptr->flags & RESERVE_FLAG_MAGNETIC)
 		list_append(magnetic_resv_list, resv_ptr);
@@ -4068,6 +4101,14 @@ extern void resv_fini(void)
 {
 	FREE_NULL_LIST(magnetic_resv_list);
 	FREE_NULL_LIST(resv_list);
+
+	slurm_mutex_lock(&resv_time_mutex);
+	xfree(resv_time_index.end_times);
+	xfree(resv_time_index.ents);
+	xfree(resv_time_index.float_ents);
+	memset(&resv_time_index, 0, sizeof(resv_time_index));
+	resv_time_index.stale = true;
+	slurm_mutex_unlock(&resv_time_mutex);
 }
 
 static int _validate_reservation_access_update(void *x, void *y)
@@ -5618,6 +5659,7 @@ extern int load_all_resv_state(int recover)
 	buf_t *buffer;
 	slurmctld_resv_t *resv_ptr = NULL;
 	uint16_t protocol_version = NO_VAL16;
+	DEF_TIMERS;
 
 	last_resv_update = time(NULL);
 	if ((recover == 0) && resv_list) {
@@ -5629,6 +5671,7 @@ extern int load_all_resv_state(int recover)
 	_create_resv_lists(true);
 
 	/* read the file */
+	START_TIMER;
 	if (!(buffer = state_save_open("resv_state", &state_file))) {
 		if ((clustername_existed == 1) && (!ignore_state_errors))
 			fatal("No reservation state file (%s) to recover",
@@ -5670,7 +5713,9 @@ extern int load_all_resv_state(int recover)
 	}
 
 	_validate_all_reservations();
-	info("Recovered state of %d reservations", list_count(resv_list));
+	END_TIMER;
+	info("Recovered state of %d reservations in %s",
+	     list_count(resv_list), TIMER_STR());
 	FREE_NULL_BUFFER(buffer);
 	return error_code;
 
@@ -5679,7 +5724,9 @@ unpack_error:
 		fatal("Incomplete reservation data checkpoint file, start with '-i' to ignore this. Warning: using -i will lose the data that can't be recovered.");
 	error("Incomplete reservation data checkpoint file");
 	_validate_all_reservations();
-	info("Recovered state of %d reservations", list_count(resv_list));
+	END_TIMER;
+	info("Recovered state of %d reservations in %s",
+	     list_count(resv_list), TIMER_STR());
 	FREE_NULL_BUFFER(buffer);
 	return EFAULT;
 }
@@ -7657,6 +7704,171 @@ static void _get_rel_start_end(slurmctld_resv_t *resv_ptr, time_t now,
 	}
 }
 
+static void _invalidate_resv_time_index(void)
+{
+	slurm_mutex_lock(&resv_time_mutex);
+	resv_time_index.stale = true;
+	slurm_mutex_unlock(&resv_time_mutex);
+}
+
+static int _cmp_resv_time_start(const void *x, const void *y)
+{
+	const resv_time_ent_t *ent1 = x, *ent2 = y;
+
+	if (ent1->start_relative < ent2->start_relative)
+		return -1;
+	if (ent1->start_relative > ent2->start_relative)
+		return 1;
+	return 0;
+}
+
+static int _cmp_resv_time_inx(const void *x, const void *y)
+{
+	const resv_time_ent_t *ent1 = x, *ent2 = y;
+
+	if (ent1->list_inx < ent2->list_inx)
+		return -1;
+	if (ent1->list_inx > ent2->list_inx)
+		return 1;
+	return 0;
+}
+
+static int _cmp_time(const void *x, const void *y)
+{
+	const time_t *time1 = x, *time2 = y;
+
+	if (*time1 < *time2)
+		return -1;
+	if (*time1 > *time2)
+		return 1;
+	return 0;
+}
+
+/*
+ * Rebuild resv_time_index if any reservation changed since it was built.
+ * Recurring reservations are advanced here as _get_rel_start_end() would
+ * when walking resv_list. Caller must hold resv_time_mutex.
+ */
+static void _build_resv_time_index(time_t now)
+{
+	resv_time_index_t *index = &resv_time_index;
+	slurmctld_resv_t *resv_ptr;
+	list_itr_t *iter;
+	uint32_t inx = 0;
+
+	if (!index->stale && (last_resv_update < index->build_time) &&
+	    (!index->advance_time || (now < index->advance_time)) &&
+	    (index->resv_cnt == list_count(resv_list)))
+		return;
+
+	index->resv_cnt = list_count(resv_list);
+	if (index->resv_cnt > index->size) {
+		index->size = index->resv_cnt;
+		xrecalloc(index->end_times, index->size, sizeof(time_t));
+		xrecalloc(index->ents, index->size, sizeof(resv_time_ent_t));
+		xrecalloc(index->float_ents, index->size,
+			  sizeof(resv_time_ent_t));
+	}
+	index->advance_time = 0;
+	index->ents_cnt = 0;
+	index->float_cnt = 0;
+	index->max_boot_time = 0;
+
+	iter = list_iterator_create(resv_list);
+	while ((resv_ptr = list_next(iter))) {
+		resv_time_ent_t *ent;
+
+		if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT)
+			ent = &index->float_ents[index->float_cnt++];
+		else
+			ent = &index->ents[index->ents_cnt++];
+
+		ent->list_inx = inx;
+		ent->resv_ptr = resv_ptr;
+		_get_rel_start_end(resv_ptr, now, &ent->start_relative,
+				   &ent->end_relative);
+		index->end_times[inx++] = resv_ptr->end_time;
+		index->max_boot_time = MAX(index->max_boot_time,
+					   resv_ptr->boot_time);
+
+		if ((resv_ptr->flags & RESERVE_REOCCURRING) &&
+		    !(resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) &&
+		    (!index->advance_time ||
+		     (ent->end_relative < index->advance_time)))
+			index->advance_time = ent->end_relative;
+	}
+	list_iterator_destroy(iter);
+
+	qsort(index->ents, index->ents_cnt, sizeof(resv_time_ent_t),
+	      _cmp_resv_time_start);
+	qsort(index->end_times, index->resv_cnt, sizeof(time_t), _cmp_time);
+
+	/*
+	 * last_resv_update only has second resolution, so any change made
+	 * in the same second as this build triggers another one.
+	 */
+	index->build_time = time(NULL);
+	index->stale = false;
+
+	log_flag(RESERVATION, "%s: indexed %d reservations (%d floating)",
+		 __func__, index->resv_cnt, index->float_cnt);
+}
+
+/*
+ * Find reservations whose time window may overlap a job running from
+ * start_time to end_time, plus the reservation's boot_time if rebooting.
+ * Floating reservations are always included, so callers must still test
+ * each reservation's times with _get_rel_start_end().
+ * RET xmalloc'ed array of reservations in resv_list order, NULL if none
+ */
+static slurmctld_resv_t **_find_resv_time_overlap(time_t now,
+						  time_t start_time,
+						  time_t end_time, bool reboot,
+						  int *resv_cnt)
+{
+	resv_time_index_t *index = &resv_time_index;
+	resv_time_ent_t *match;
+	slurmctld_resv_t **resv_array = NULL;
+	int lo = 0, hi, match_cnt = 0;
+
+	slurm_mutex_lock(&resv_time_mutex);
+	_build_resv_time_index(now);
+
+	if (reboot)
+		end_time += index->max_boot_time;
+
+	/* Reservations starting at or after end_time can't overlap */
+	hi = index->ents_cnt;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (index->ents[mid].start_relative < end_time)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	match = xcalloc((lo + index->float_cnt + 1), sizeof(*match));
+	for (int i = 0; i < lo; i++) {
+		if (index->ents[i].end_relative > start_time)
+			match[match_cnt++] = index->ents[i];
+	}
+	for (int i = 0; i < index->float_cnt; i++)
+		match[match_cnt++] = index->float_ents[i];
+	slurm_mutex_unlock(&resv_time_mutex);
+
+	if (match_cnt) {
+		qsort(match, match_cnt, sizeof(*match), _cmp_resv_time_inx);
+		resv_array = xcalloc(match_cnt, sizeof(*resv_array));
+		for (int i = 0; i < match_cnt; i++)
+			resv_array[i] = match[i].resv_ptr;
+	}
+	xfree(match);
+
+	*resv_cnt = match_cnt;
+	return resv_array;
+}
+
 static void _addto_resv_exc(bitstr_t *core_bitmap, resv_exc_t *resv_exc_ptr)
 {
 	bitstr_t **tmp_bitstr;
@@ -7679,12 +7891,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 			 resv_exc_t *resv_exc_ptr, bool *resv_overlap,
 			 bool reboot)
 {
-	slurmctld_resv_t *resv_ptr = NULL, *res2_ptr;
+	slurmctld_resv_t *resv_ptr = NULL, *res2_ptr, **resv_array;
 	time_t job_start_time, job_end_time, job_end_time_use, lic_resv_time;
 	time_t start_relative, end_relative;
 	time_t now = time(NULL);
-	list_itr_t *iter;
-	int i, rc = SLURM_SUCCESS, rc2;
+	int i, rc = SLURM_SUCCESS, rc2, resv_cnt;
 
 	*resv_overlap = false;	/* initialize to false */
 	job_start_time = *when;
@@ -7782,8 +7993,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 		 * if there are any overlapping reservations, we need to
 		 * prevent the job from using those nodes (e.g. MAINT nodes)
 		 */
-		iter = list_iterator_create(resv_list);
-		while ((res2_ptr = list_next(iter))) {
+		resv_array = _find_resv_time_overlap(now, job_start_time,
+						      job_end_time, reboot,
+						      &resv_cnt);
+		for (int j = 0; j < resv_cnt; j++) {
+			res2_ptr = resv_array[j];
 			if (reboot)
 				job_end_time_use =
 					job_end_time + res2_ptr->boot_time;
@@ -7829,7 +8043,7 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				bit_and_not(*node_bitmap,res2_ptr->node_bitmap);
 			}
 		}
-		list_iterator_destroy(iter);
+		xfree(resv_array);
 
 		if (slurm_conf.debug_flags & DEBUG_FLAG_RESERVATION) {
 			char *nodes = bitmap2node_name(*node_bitmap);
@@ -7873,8 +8087,11 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 	for (i = 0; ; i++) {
 		lic_resv_time = (time_t) 0;
 
-		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = list_next(iter))) {
+		resv_array = _find_resv_time_overlap(now, job_start_time,
+						      job_end_time, reboot,
+						      &resv_cnt);
+		for (int j = 0; j < resv_cnt; j++) {
+			resv_ptr = resv_array[j];
 			_get_rel_start_end(
 				resv_ptr, now, &start_relative, &end_relative);
 
@@ -7985,7 +8202,7 @@ extern int job_test_resv(job_record_t *job_ptr, time_t *when,
 				continue;
 			}
 		}
-		list_iterator_destroy(iter);
+		xfree(resv_array);
 
 		if (resv_exc_ptr) {
 			free_core_array(&resv_exc_ptr->exc_cores);
@@ -8082,21 +8299,29 @@ static int _update_resv_group_uid_access_list(void *x, void *arg)
  */
 extern time_t find_resv_end(time_t start_time, int resolution)
 {
-	list_itr_t *iter;
-	slurmctld_resv_t *resv_ptr;
+	resv_time_index_t *index = &resv_time_index;
 	time_t end_time = 0;
+	int lo = 0, hi;
 
 	if (!resv_list)
 		return end_time;
 
-	iter = list_iterator_create(resv_list);
-	while ((resv_ptr = list_next(iter))) {
-		if (start_time > resv_ptr->end_time)
-			continue;
-		if ((end_time == 0) || (resv_ptr->end_time < end_time))
-			end_time = resv_ptr->end_time;
+	slurm_mutex_lock(&resv_time_mutex);
+	_build_resv_time_index(time(NULL));
+
+	/* First end_time at or after start_time */
+	hi = index->resv_cnt;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (index->end_times[mid] < start_time)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
-	list_iterator_destroy(iter);
+	if (lo < index->resv_cnt)
+		end_time = index->end_times[lo];
+	slurm_mutex_unlock(&resv_time_mutex);
 
 	/* Round-up returned time to given resolution */
 	if (resolution > 0) {
@@ -38,6 +38,7 @@
 #include <inttypes.h>
 
 #include "src/common/data.h"
+#include "src/common/pack.h"
 #include "src/common/list.h"
 #include "src/common/macros.h"
 #include "src/common/read_config.h"
@@ -52,10 +53,69 @@
 #include "src/slurmctld/job_scheduler.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/proc_req.h"
+#include "src/slurmctld/rpc_queue.h"
+#include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/state_save.h"
 
+typedef struct {
+	uint16_t show_flags;
+	uint16_t protocol_version;
+	bool privileged;
+	uid_t uid; /* only set when !privileged */
+	buf_t *buffer;
+} coalesced_resp_t;
+
 bool enabled = true;
 
+static void _free_coalesced_resp(void *x)
+{
+	coalesced_resp_t *resp = x;
+
+	FREE_NULL_BUFFER(resp->buffer);
+	xfree(resp);
+}
+
+static int _find_coalesced_resp(void *x, void *key)
+{
+	coalesced_resp_t *resp = x, *find = key;
+
+	return ((resp->show_flags == find->show_flags) &&
+		(resp->protocol_version == find->protocol_version) &&
+		(resp->privileged == find->privileged) &&
+		(resp->uid == find->uid));
+}
+
+/*
+ * Get queue that owns msg if its response may be shared with other requests
+ * in the same cycle. The worker holds the queue's locks for the whole cycle so
+ * nothing packed earlier in the cycle can be stale.
+ */
+static slurmctld_rpc_t *_coalesce_queue(slurm_msg_t *msg)
+{
+	slurmctld_rpc_t *q;
+
+	if (!(msg->flags & CTLD_QUEUE_PROCESSING))
+		return NULL;
+
+	if (!(q = find_rpc(msg->msg_type)) || !q->coalesce)
+		return NULL;
+
+	return q;
+}
+
+static void _coalesce_key(slurm_msg_t *msg, uint16_t show_flags,
+			  coalesced_resp_t *key)
+{
+	/*
+	 * Operators see everything regardless of uid, while everyone else may
+	 * have partitions, jobs or nodes hidden based on their uid.
+	 */
+	key->show_flags = show_flags;
+	key->protocol_version = msg->protocol_version;
+	key->privileged = validate_operator(msg->auth_uid);
+	key->uid = key->privileged ? 0 : msg->auth_uid;
+}
+
 static void *_rpc_queue_worker(void *arg)
 {
 	slurmctld_rpc_t *q = (slurmctld_rpc_t *) arg;
@@ -86,6 +146,8 @@ static void *_rpc_queue_worker(void *arg)
 			msg = list_dequeue(q->work);
 
 		if (!msg) {
+			/* responses are only valid while the locks are held */
+			FREE_NULL_LIST(q->responses);
 			unlock_slurmctld(q->locks);
 
 			if (processed && q->post_func)
@@ -256,6 +318,9 @@ static void _apply_config(data_t *conf, slurmctld_rpc_t *q)
 	if ((field = data_key_get(settings, "hard_drop")))
 		(void) data_get_bool_converted(field, &q->hard_drop);
 
+	if ((field = data_key_get(settings, "coalesce")))
+		(void) data_get_bool_converted(field, &q->coalesce);
+
 	if ((field = data_key_get(settings, "max_per_cycle")))
 		if (!data_get_int_converted(field, &int64_tmp))
 			q->max_per_cycle = int64_tmp;
@@ -313,10 +378,10 @@ extern void rpc_queue_init(void)
 		slurm_mutex_init(&q->mutex);
 		q->shutdown = false;
 
-		verbose("starting rpc_queue for %s: max_per_cycle=%u max_usec_per_cycle=%u max_queued=%d hard_drop=%d yield_sleep=%d interval=%d",
+		verbose("starting rpc_queue for %s: max_per_cycle=%u max_usec_per_cycle=%u max_queued=%d hard_drop=%d yield_sleep=%d interval=%d coalesce=%d",
 			q->msg_name, q->max_per_cycle, q->max_usec_per_cycle,
 			q->max_queued, q->hard_drop, q->yield_sleep,
-			q->interval);
+			q->interval, q->coalesce);
 
 		(void) snprintf(name, sizeof(name), "rpcq-%u", q->msg_type);
 		slurm_thread_create(name, &q->thread, _rpc_queue_worker, q);
@@ -350,6 +415,7 @@ extern void rpc_queue_shutdown(void)
 
 		slurm_thread_join(q->thread);
 		FREE_NULL_LIST(q->work);
+		FREE_NULL_LIST(q->responses);
 	}
 }
 
@@ -400,3 +466,47 @@ extern int rpc_enqueue(slurmctld_rpc_t *q, slurm_msg_t *msg)
 
 	return SLURM_SUCCESS;
 }
+
+extern buf_t *rpc_queue_coalesce_get(slurm_msg_t *msg, uint16_t show_flags)
+{
+	slurmctld_rpc_t *q;
+	coalesced_resp_t key, *resp;
+
+	if (!(q = _coalesce_queue(msg)) || !q->responses)
+		return NULL;
+
+	_coalesce_key(msg, show_flags, &key);
+	if (!(resp = list_find_first(q->responses, _find_coalesced_resp, &key)))
+		return NULL;
+
+	slurm_mutex_lock(&q->mutex);
+	q->coalesced++;
+	record_rpc_queue_stats(q);
+	slurm_mutex_unlock(&q->mutex);
+
+	log_flag(PROTOCOL, "%s(%s): reusing response packed for uid=%u privileged=%d show_flags=0x%x",
+		 __func__, q->msg_name, msg->auth_uid, key.privileged,
+		 show_flags);
+
+	return resp->buffer;
+}
+
+extern bool rpc_queue_coalesce_add(slurm_msg_t *msg, uint16_t show_flags,
+				   buf_t *buffer)
+{
+	slurmctld_rpc_t *q;
+	coalesced_resp_t *resp;
+
+	if (!buffer || !(q = _coalesce_queue(msg)))
+		return false;
+
+	resp = xmalloc(sizeof(*resp));
+	_coalesce_key(msg, show_flags, resp);
+	resp->buffer = buffer;
+
+	if (!q->responses)
+		q->responses = list_create(_free_coalesced_resp);
+	list_append(q->responses, resp);
+
+	return true;
+}
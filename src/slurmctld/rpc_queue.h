@@ -46,4 +46,24 @@ extern bool rpc_queue_enabled(void);
 
 extern int rpc_enqueue(slurmctld_rpc_t *q, slurm_msg_t *msg);
 
+/*
+ * Get response already packed in the current rpc_queue cycle for a request
+ * from the same visibility class (operator or uid) with the same show_flags
+ * and protocol version.
+ * IN msg - request being processed
+ * IN show_flags - show_flags of the request
+ * RET buffer owned by the rpc_queue (do not free) or NULL if none
+ */
+extern buf_t *rpc_queue_coalesce_get(slurm_msg_t *msg, uint16_t show_flags);
+
+/*
+ * Share a packed response with later requests in the current rpc_queue cycle.
+ * IN msg - request being processed
+ * IN show_flags - show_flags of the request
+ * IN buffer - packed response
+ * RET true if the rpc_queue took ownership of buffer (caller must not free)
+ */
+extern bool rpc_queue_coalesce_add(slurm_msg_t *msg, uint16_t show_flags,
+				   buf_t *buffer);
+
 #endif
@@ -191,6 +191,8 @@ typedef struct diag_stats {
 	uint32_t schedule_cycle_depth;
 	uint32_t schedule_exit[SCHEDULE_EXIT_COUNT];
 	uint32_t schedule_queue_len;
+	uint64_t schedule_arena_alloc_cnt;
+	uint64_t schedule_arena_alloc_bytes;
 
 	uint32_t jobs_submitted;
 	uint32_t jobs_started;
@@ -220,6 +222,11 @@ typedef struct diag_stats {
 	uint32_t bf_table_size;
 	uint32_t bf_table_size_sum;
 	time_t   bf_when_last_cycle;
+	uint64_t bf_arena_alloc_cnt;
+	uint64_t bf_arena_alloc_bytes;
+
+	uint64_t avail_cache_hits;
+	uint64_t avail_cache_misses;
 
 	uint32_t latency;
 } diag_stats_t;
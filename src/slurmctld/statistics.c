@@ -65,11 +65,15 @@ extern buf_t *pack_all_stat(uint16_t protocol_version)
 	int agent_count;
 	int agent_thread_count;
 	int slurmdbd_queue_size = 0;
+	acct_storage_agent_stats_t dbd_agent_stats = { 0 };
 	time_t now = time(NULL);
 
 	if (acct_storage_g_get_data(acct_db_conn, ACCT_STORAGE_INFO_AGENT_COUNT,
 				    &slurmdbd_queue_size) != SLURM_SUCCESS)
 		slurmdbd_queue_size = 0;
+	if (acct_storage_g_get_data(acct_db_conn, ACCT_STORAGE_INFO_AGENT_STATS,
+				    &dbd_agent_stats) != SLURM_SUCCESS)
+		memset(&dbd_agent_stats, 0, sizeof(dbd_agent_stats));
 
 	buffer = init_buf(BUF_SIZE);
 	if (protocol_version >= SLURM_25_11_PROTOCOL_VERSION) {
@@ -132,6 +136,35 @@ extern buf_t *pack_all_stat(uint16_t protocol_version)
 		pack32(slurmctld_diag_stats.backfilled_het_jobs, buffer);
 		pack32_array(slurmctld_diag_stats.bf_exit, BF_EXIT_COUNT,
 			     buffer);
+
+		if (protocol_version >= SLURM_26_05_PROTOCOL_VERSION) {
+			uint64_t lock_wait_cnt[LOCK_STATS_COUNT];
+			uint64_t lock_wait_time[LOCK_STATS_COUNT];
+			uint64_t lock_wait_max[LOCK_STATS_COUNT];
+
+			get_lock_stats(lock_wait_cnt, lock_wait_time,
+				       lock_wait_max);
+			pack64_array(lock_wait_cnt, LOCK_STATS_COUNT, buffer);
+			pack64_array(lock_wait_time, LOCK_STATS_COUNT, buffer);
+			pack64_array(lock_wait_max, LOCK_STATS_COUNT, buffer);
+
+			pack64(slurmctld_diag_stats.schedule_arena_alloc_cnt,
+			       buffer);
+			pack64(slurmctld_diag_stats.schedule_arena_alloc_bytes,
+			       buffer);
+			pack64(slurmctld_diag_stats.bf_arena_alloc_cnt, buffer);
+			pack64(slurmctld_diag_stats.bf_arena_alloc_bytes,
+			       buffer);
+
+			pack64(slurmctld_diag_stats.avail_cache_hits, buffer);
+			pack64(slurmctld_diag_stats.avail_cache_misses, buffer);
+
+			pack32(dbd_agent_stats.batch_cnt, buffer);
+			pack32(dbd_agent_stats.batch_max, buffer);
+			pack64(dbd_agent_stats.msg_cnt, buffer);
+			pack64(dbd_agent_stats.usec, buffer);
+			pack64(dbd_agent_stats.usec_max, buffer);
+		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack32(1, buffer); /* please remove on next version */
 
@@ -239,6 +272,11 @@ extern void reset_stats(int level)
 	memset(slurmctld_diag_stats.bf_exit, 0,
 	       sizeof(slurmctld_diag_stats.bf_exit));
 
+	slurmctld_diag_stats.avail_cache_hits = 0;
+	slurmctld_diag_stats.avail_cache_misses = 0;
+
+	reset_lock_stats();
+
 	last_proc_req_start = time(NULL);
 }
 
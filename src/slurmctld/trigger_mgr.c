@@ -59,6 +59,7 @@
 #include "src/common/slurmdbd_defs.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/state_save.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -821,10 +822,12 @@ extern void trigger_state_restore(void)
 	buf_t *buffer;
 	time_t buf_time;
 	char *ver_str = NULL;
+	DEF_TIMERS;
 
 	/* read the file */
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 
+	START_TIMER;
 	if (!(buffer = state_save_open("trigger_state", &state_file))) {
 		if ((clustername_existed == 1) && (!ignore_state_errors))
 			fatal("No trigger state file (%s) to recover",
@@ -865,7 +868,9 @@ unpack_error:
 	if (!ignore_state_errors)
 		fatal("Incomplete trigger data checkpoint file, start with '-i' to ignore this. Warning: using -i will lose the data that can't be recovered.");
 	error("Incomplete trigger data checkpoint file");
-fini:	verbose("State of %d triggers recovered", trigger_cnt);
+fini:	END_TIMER;
+	verbose("State of %d triggers recovered in %s",
+		trigger_cnt, TIMER_STR());
 	FREE_NULL_BUFFER(buffer);
 }
 
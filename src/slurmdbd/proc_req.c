@@ -2815,6 +2815,11 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 	}
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
+	/*
+	 * Records in the batch share one transaction, committed by our caller
+	 * after the last one is processed.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
 	/* START_TIMER; */
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
@@ -2839,6 +2844,7 @@ static int _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn, persist_msg_t *msg,
 			break;
 	}
 	list_iterator_destroy(itr);
+	slurmdbd_conn->in_mult_msg = false;
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -3387,12 +3393,15 @@ extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 		error("CONN:%d Security violation, %s",
 		      fd, slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->pcon->rem_port &&
+		 !slurmdbd_conn->in_mult_msg &&
 		 (!slurmdbd_conf->commit_delay ||
 		  (msg->msg_type == DBD_REGISTER_CTLD))) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
+		   Records of a DBD_SEND_MULT_MSG are committed
+		   together once the whole message is processed.
 		*/
 		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
 	}
@@ -3401,7 +3410,8 @@ extern int proc_req(void *conn, persist_msg_t *msg, buf_t **out_buffer)
 	 * only. Can't clear in p_commit() because if CommitDelay is set, we may
 	 * not send needed updates later.
 	 */
-	slurmdbd_conn->pcon->flags &= ~PERSIST_FLAG_DONT_UPDATE_CLUSTER;
+	if (!slurmdbd_conn->in_mult_msg)
+		slurmdbd_conn->pcon->flags &= ~PERSIST_FLAG_DONT_UPDATE_CLUSTER;
 
 	END_TIMER;
 
@@ -49,6 +49,7 @@ typedef struct {
 	pthread_mutex_t pcon_send_lock;
 	void *db_conn; /* database connection */
 	char *tres_str;
+	bool in_mult_msg; /* commit once after all of DBD_SEND_MULT_MSG */
 } slurmdbd_conn_t;
 
 /* Process an incoming RPC
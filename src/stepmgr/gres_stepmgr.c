@@ -167,6 +167,7 @@ static gres_job_state_t *_get_job_alloc_gres_ptr(list_t *job_gres_list_alloc,
 		gres_state_job->config_flags = gres_state_in->config_flags;
 		/* Use gres_state_node here as plugin_id might be NO_VAL */
 		gres_state_job->plugin_id = gres_state_in->plugin_id;
+		gres_state_job->ctx_inx = gres_state_in->ctx_inx;
 		gres_state_job->gres_data = gres_js;
 		gres_state_job->gres_name = xstrdup(gres_state_in->gres_name);
 		gres_state_job->state_type = GRES_STATE_TYPE_JOB;
@@ -2563,6 +2564,7 @@ static gres_step_state_t *_step_get_alloc_gres_ptr(list_t *step_gres_list_alloc,
 		gres_state_step = xmalloc(sizeof(*gres_state_step));
 		gres_state_step->config_flags = step_search_key.config_flags;
 		gres_state_step->plugin_id = step_search_key.plugin_id;
+		gres_state_step->ctx_inx = gres_state_job->ctx_inx;
 		gres_state_step->gres_data = gres_ss;
 		gres_state_step->gres_name = xstrdup(gres_state_job->gres_name);
 		gres_state_step->state_type = GRES_STATE_TYPE_STEP;
@@ -221,6 +221,7 @@ static void _build_pending_step(job_record_t *job_ptr,
 		return;
 
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	step_ptr->cpu_count	= step_specs->num_tasks;
 	step_ptr->port		= step_specs->port;
@@ -380,6 +381,7 @@ static int _finish_step_comp(void *x, void *arg)
 	_wake_pending_steps(job_ptr);
 
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	return 1;
 }
@@ -398,6 +400,7 @@ extern void delete_step_records(job_record_t *job_ptr)
 
 	remaining = list_count(job_ptr->step_list);
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	list_delete_all(job_ptr->step_list, _step_not_cleaning, &remaining);
 }
 
@@ -414,6 +417,7 @@ void delete_step_record(job_record_t *job_ptr, step_record_t *step_ptr)
 	xassert(step_ptr);
 
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 	list_delete_ptr(job_ptr->step_list, step_ptr);
 }
 
@@ -3467,6 +3471,7 @@ extern int step_create(job_record_t *job_ptr,
 		return ESLURMD_TOOMANYSTEPS;
 	}
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	step_ptr->start_time = time(NULL);
 	step_ptr->state      = JOB_RUNNING;
@@ -4536,8 +4541,10 @@ stepmgr:
 		args.mod_cnt++;
 	}
 
-	if (args.mod_cnt)
+	if (args.mod_cnt) {
 		*stepmgr_ops->last_job_update = time(NULL);
+		job_ptr->last_update = time(NULL);
+	}
 
 	return SLURM_SUCCESS;
 }
@@ -4641,6 +4648,7 @@ extern step_record_t *build_extern_step(job_record_t *job_ptr)
 	}
 
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	step_ptr->step_layout = fake_slurm_step_layout_create(
 		node_list, NULL, NULL, node_cnt, node_cnt,
@@ -4687,6 +4695,7 @@ extern step_record_t *build_batch_step(job_record_t *job_ptr_in)
 	}
 
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	host = job_ptr->batch_host;
 
@@ -4760,6 +4769,7 @@ static step_record_t *_build_interactive_step(
 		return NULL;
 	}
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	step_ptr->step_layout = fake_slurm_step_layout_create(
 		host, NULL, NULL, 1, 1, protocol_version);
@@ -4869,6 +4879,7 @@ static int _build_ext_launcher_step(step_record_t **step_rec,
 		return SLURM_ERROR;
 	}
 	*stepmgr_ops->last_job_update = time(NULL);
+	job_ptr->last_update = time(NULL);
 
 	/* We want 1 task per node. */
 	step_ptr->step_node_bitmap = nodeset;
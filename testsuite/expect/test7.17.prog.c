@@ -197,7 +197,13 @@ int main(int argc, char *argv[])
 		fatal("failure: gres_job_state_validate: %s",
 		      slurm_strerror(rc));
 
-#if SLURM_VERSION_NUMBER >= SLURM_VERSION_NUM(25,11,0)
+#if SLURM_VERSION_NUMBER >= SLURM_VERSION_NUM(26,5,0)
+	gres_node_state_log(node_ptr->gres_list, node_name);
+	gres_job_state_log(job_gres_list, job_id);
+
+	cpu_alloc = gres_job_test(job_gres_list, node_ptr->gres_list, NULL,
+				  true, 0, cpu_count - 1, job_id, node_name);
+#elif SLURM_VERSION_NUMBER >= SLURM_VERSION_NUM(25,11,0)
 	// Ticket 22718: In newer versions we should use node_ptr->gres_list
 	gres_node_state_log(node_ptr->gres_list, node_name);
 	gres_job_state_log(job_gres_list, job_id);
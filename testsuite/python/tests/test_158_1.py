@@ -0,0 +1,113 @@
+############################################################################
+# Copyright (C) SchedMD LLC.
+############################################################################
+import atf
+import pytest
+
+job_count = 20
+
+
+@pytest.fixture(scope="module", autouse=True)
+def setup():
+    atf.require_auto_config("Restarts slurmctld and reads its state files")
+    atf.require_slurm_running()
+
+
+@pytest.fixture(scope="module")
+def job_ids():
+    ids = [
+        atf.submit_job_sbatch('--hold --wrap "sleep 60"', fatal=True)
+        for i in range(job_count)
+    ]
+    assert wait_for_state_saved(), "New jobs were not saved"
+
+    return ids
+
+
+def state_file_stat(name, fmt):
+    state_save_location = atf.get_config_parameter("StateSaveLocation")
+    output = atf.run_command_output(
+        f"stat -c {fmt} {state_save_location}/{name}",
+        user=atf.properties["slurm-user"],
+        quiet=True,
+    )
+    return int(output) if output else 0
+
+
+def job_state_files():
+    return (
+        state_file_stat("job_state", "%i"),
+        state_file_stat("job_state.journal", "%s"),
+    )
+
+
+def wait_for_state_saved():
+    """Wait until the job state files stop changing between saves"""
+
+    last_state = [None]
+
+    def poll():
+        state = job_state_files()
+        settled = state == last_state[0]
+        last_state[0] = state
+        return settled
+
+    # slurmctld saves pending changes at least every 5 seconds
+    return atf.repeat_until(
+        poll, lambda settled: settled, timeout=60, poll_interval=6
+    )
+
+
+def test_journal_replay(job_ids):
+    """Verify that job changes appended to the journal are recovered"""
+
+    job_state_inode, journal_size = job_state_files()
+
+    atf.run_command(
+        f"scontrol update jobid={job_ids[0]} comment=replayed", fatal=True
+    )
+    assert atf.repeat_until(
+        lambda: state_file_stat("job_state.journal", "%s"),
+        lambda size: size > journal_size,
+    ), "A single job change should be appended to the journal"
+    assert (
+        state_file_stat("job_state", "%i") == job_state_inode
+    ), "A single job change should not rewrite job_state"
+
+    atf.cancel_jobs([job_ids[1]])
+    atf.restart_slurmctld()
+
+    assert atf.get_job_parameter(job_ids[0], "Comment") == "replayed"
+    assert atf.get_job_parameter(job_ids[1], "JobState") == "CANCELLED"
+    for job_id in job_ids[2:]:
+        assert atf.get_job_parameter(job_id, "JobState") == "PENDING"
+
+
+def test_journal_compaction(job_ids):
+    """Verify that changing most jobs rewrites job_state"""
+
+    # The first save after a restart rewrites job_state, the next one appends
+    for comment in ["restarted", "appended"]:
+        atf.run_command(
+            f"scontrol update jobid={job_ids[2]} comment={comment}", fatal=True
+        )
+        assert wait_for_state_saved(), "Job change was not saved"
+    job_state_inode, journal_size = job_state_files()
+
+    for job_id in job_ids[2:]:
+        atf.run_command(
+            f"scontrol update jobid={job_id} comment=compacted", fatal=True
+        )
+    assert atf.repeat_until(
+        lambda: state_file_stat("job_state", "%i"),
+        lambda inode: inode != job_state_inode,
+    ), "Changing most jobs should rewrite job_state"
+    assert (
+        state_file_stat("job_state.journal", "%s") < journal_size
+    ), "Rewriting job_state should start a new journal"
+
+    atf.restart_slurmctld()
+
+    assert atf.get_job_parameter(job_ids[0], "Comment") == "replayed"
+    for job_id in job_ids[2:]:
+        assert atf.get_job_parameter(job_id, "Comment") == "compacted"
@@ -0,0 +1,84 @@
+/*
+ * Report ns per operation of whole bitmap operations.
+ * Not part of "make check", build with "make bitstring-bench".
+ */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <src/common/log.h>
+#include <src/common/bitstring.h>
+#include <src/common/timers.h>
+
+/* Fill bitmap with a pseudo-random pattern with about 1 in density bits set */
+static void _fill_random(bitstr_t *b, int density)
+{
+	for (bitoff_t bit = 0; bit < bit_size(b); bit++) {
+		if (!(random() % density))
+			bit_set(b, bit);
+	}
+}
+
+static void _bench_bit_ops(void)
+{
+	for (bitoff_t nbits = 10000; nbits <= 1000000; nbits *= 10) {
+		bitstr_t *b1 = bit_alloc(nbits);
+		bitstr_t *b2 = bit_alloc(nbits);
+		int reps = 100000000 / nbits;
+		int64_t sum = 0;
+		DEF_TIMERS;
+
+		_fill_random(b1, 2);
+		_fill_random(b2, 2);
+
+		START_TIMER;
+		for (int i = 0; i < reps; i++)
+			sum += bit_set_count(b1);
+		END_TIMER;
+		info("%"PRId64" bits: bit_set_count %.1f ns/op",
+		     nbits, (TIMER_DURATION_USEC() * 1000.0) / reps);
+
+		START_TIMER;
+		for (int i = 0; i < reps; i++)
+			sum += bit_overlap(b1, b2);
+		END_TIMER;
+		info("%"PRId64" bits: bit_overlap %.1f ns/op",
+		     nbits, (TIMER_DURATION_USEC() * 1000.0) / reps);
+
+		START_TIMER;
+		for (int i = 0; i < reps; i++)
+			sum += bit_super_set(b1, b2);
+		END_TIMER;
+		info("%"PRId64" bits: bit_super_set %.1f ns/op",
+		     nbits, (TIMER_DURATION_USEC() * 1000.0) / reps);
+
+		START_TIMER;
+		for (int i = 0; i < reps; i++)
+			bit_or(b1, b2);
+		END_TIMER;
+		info("%"PRId64" bits: bit_or %.1f ns/op",
+		     nbits, (TIMER_DURATION_USEC() * 1000.0) / reps);
+
+		START_TIMER;
+		for (int i = 0; i < reps; i++)
+			bit_and(b1, b2);
+		END_TIMER;
+		info("%"PRId64" bits: bit_and %.1f ns/op",
+		     nbits, (TIMER_DURATION_USEC() * 1000.0) / reps);
+
+		if (sum <= 0)
+			error("unexpected bit count sum %"PRId64, sum);
+
+		bit_free(b1);
+		bit_free(b2);
+	}
+}
+
+int main(void)
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	log_init("bitstring-bench", log_opts, 0, NULL);
+
+	srandom(1);
+	_bench_bit_ops();
+
+	return EXIT_SUCCESS;
+}
@@ -307,6 +307,155 @@ START_TEST(test_bit_ffs_from_bit)
 }
 END_TEST
 
+/* Fill bitmap with a pseudo-random pattern with about 1 in density bits set */
+static void _fill_random(bitstr_t *b, int density)
+{
+	for (bitoff_t bit = 0; bit < bit_size(b); bit++) {
+		if (!(random() % density))
+			bit_set(b, bit);
+	}
+}
+
+/* Compare popcount based kernels with counting one bit at a time */
+START_TEST(test_bit_count_kernels)
+{
+	srandom(1);
+
+	for (bitoff_t nbits = 1; nbits <= 320; nbits++) {
+		for (int density = 1; density <= 8; density *= 2) {
+			bitstr_t *b1 = bit_alloc(nbits);
+			bitstr_t *b2 = bit_alloc(nbits);
+			int32_t set = 0, overlap = 0;
+
+			_fill_random(b1, density);
+			_fill_random(b2, density);
+
+			for (bitoff_t bit = 0; bit < nbits; bit++) {
+				if (bit_test(b1, bit)) {
+					set++;
+					if (bit_test(b2, bit))
+						overlap++;
+				}
+			}
+
+			ck_assert_int_eq(bit_set_count(b1), set);
+			ck_assert_int_eq(bit_clear_count(b1), (nbits - set));
+			ck_assert_int_eq(bit_overlap(b1, b2), overlap);
+			ck_assert_int_eq(bit_overlap_any(b1, b2), !!overlap);
+
+			/* bits beyond the size must never be counted */
+			bit_not(b1);
+			ck_assert_int_eq(bit_set_count(b1), (nbits - set));
+
+			bit_free(b1);
+			bit_free(b2);
+		}
+	}
+}
+END_TEST
+
+/* Compare fused operations with the same operations on temporary bitmaps */
+START_TEST(test_bit_fused_ops)
+{
+	srandom(2);
+
+	for (bitoff_t nbits = 1; nbits <= 200; nbits++) {
+		bitstr_t *b1 = bit_alloc(nbits);
+		bitstr_t *b2 = bit_alloc(nbits);
+		bitstr_t *b3 = bit_alloc(nbits);
+		bitstr_t *dest = bit_alloc(nbits);
+		bitstr_t *tmp;
+		int32_t start = random() % nbits;
+		int32_t end = start + (random() % (nbits - start + 1));
+
+		_fill_random(b1, 2);
+		_fill_random(b2, 2);
+		_fill_random(b3, 3);
+		/* leave bits beyond the size set in b3 */
+		bit_not(b3);
+
+		tmp = bit_copy(b1);
+		bit_and(tmp, b2);
+		bit_and_not(tmp, b3);
+		ck_assert_int_eq(bit_overlap_not(b1, b2, b3),
+				 bit_set_count(tmp));
+		ck_assert_int_eq(bit_overlap_not_any(b1, b2, b3),
+				 (bit_ffs(tmp) != -1));
+		FREE_NULL_BITMAP(tmp);
+
+		tmp = bit_copy(b1);
+		bit_and_not(tmp, b3);
+		ck_assert_int_eq(bit_set_count_range_not(b1, b3, start, end),
+				 bit_set_count_range(tmp, start, end));
+
+		bit_copybits_and_not(dest, b1, b3);
+		ck_assert(bit_equal(dest, tmp));
+		FREE_NULL_BITMAP(tmp);
+
+		tmp = bit_copy(b2);
+		bit_and_not(tmp, b3);
+		bit_or(tmp, b1);
+		bit_copybits(dest, b1);
+		bit_or_and_not(dest, b2, b3);
+		ck_assert(bit_equal(dest, tmp));
+		FREE_NULL_BITMAP(tmp);
+
+		bit_free(b1);
+		bit_free(b2);
+		bit_free(b3);
+		bit_free(dest);
+	}
+}
+END_TEST
+
+START_TEST(test_bit_arena)
+{
+	xarena_t *arena = xarena_create(0);
+	xarena_stats_t stats;
+	bitstr_t *b1, *b2, *b3;
+
+	for (int cycle = 0; cycle < 3; cycle++) {
+		b1 = bit_alloc_arena(arena, 100);
+		ck_assert(xarena_item(b1));
+		ck_assert_int_eq(bit_size(b1), 100);
+		ck_assert_int_eq(bit_set_count(b1), 0);
+		bit_nset(b1, 10, 19);
+
+		b2 = bit_copy_arena(arena, b1);
+		ck_assert(xarena_item(b2));
+		ck_assert(bit_equal(b1, b2));
+
+		/* larger than a chunk */
+		b3 = bit_alloc_arena(arena, (XARENA_CHUNK_MIN * 8) + 1);
+		bit_set(b3, XARENA_CHUNK_MIN * 8);
+		ck_assert_int_eq(bit_set_count(b3), 1);
+
+		/* growing moves the bitmap to the heap */
+		bit_realloc(b2, 1000);
+		ck_assert(!xarena_item(b2));
+		ck_assert_int_eq(bit_set_count(b2), 10);
+		FREE_NULL_BITMAP(b2);
+
+		/* released with the arena */
+		FREE_NULL_BITMAP(b1);
+		ck_assert(!b1);
+
+		xarena_reset(arena, &stats);
+		ck_assert_int_eq(stats.alloc_cnt, 3);
+		ck_assert(stats.alloc_bytes >=
+			  ((XARENA_CHUNK_MIN + 2 * sizeof(bitstr_t))));
+	}
+
+	/* NULL arena falls back to the heap */
+	b1 = bit_alloc_arena(NULL, 100);
+	ck_assert(!xarena_item(b1));
+	FREE_NULL_BITMAP(b1);
+
+	xarena_destroy(&arena);
+	ck_assert(!arena);
+}
+END_TEST
+
 int main(void)
 {
 	int number_failed;
@@ -328,6 +477,9 @@ int main(void)
 	tcase_add_test(tc_core, test_bit_overlap);
 	tcase_add_test(tc_core, test_bit_set_count_range);
 	tcase_add_test(tc_core, test_bit_ffs_from_bit);
+	tcase_add_test(tc_core, test_bit_count_kernels);
+	tcase_add_test(tc_core, test_bit_fused_ops);
+	tcase_add_test(tc_core, test_bit_arena);
 
 	suite_add_tcase(s, tc_core);
 
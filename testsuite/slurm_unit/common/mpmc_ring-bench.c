@@ -0,0 +1,181 @@
+/*****************************************************************************\
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Report throughput and queueing latency of mpmc_ring against list_t under
+ * contention. Not part of "make check", build with "make mpmc_ring-bench".
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "src/common/list.h"
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
+#include "src/common/slurm_time.h"
+#include "src/common/threadpool.h"
+#include "src/common/timers.h"
+#include "src/common/xmalloc.h"
+
+#define BENCH_RING_SIZE 256
+#define BENCH_ITEMS_PER_THREAD 10000
+#define BENCH_MAX_THREADS 128
+
+typedef struct {
+	timespec_t enqueued;
+} bench_item_t;
+
+typedef struct {
+	mpmc_ring_t *ring; /* NULL to use list instead */
+	list_t *list;
+	pthread_barrier_t *start;
+	int count;
+	bench_item_t *items;
+	uint64_t *latency; /* nanoseconds for each popped item */
+} bench_args_t;
+
+/*
+ * Each thread acts like a conmgr worker that queues work and then runs the
+ * oldest queued work. Latency is the time an item spent queued.
+ */
+static void *_bench_worker(void *arg)
+{
+	bench_args_t *args = arg;
+
+	/* start all threads at once to maximize contention */
+	(void) pthread_barrier_wait(args->start);
+
+	for (int i = 0; i < args->count; i++) {
+		bench_item_t *item = &args->items[i];
+		timespec_t delay;
+
+		item->enqueued = timespec_now();
+
+		if (args->ring) {
+			while (!mpmc_ring_push(args->ring, item))
+				sched_yield();
+			while (!(item = mpmc_ring_pop(args->ring)))
+				sched_yield();
+		} else {
+			list_append(args->list, item);
+			while (!(item = list_pop(args->list)))
+				sched_yield();
+		}
+
+		delay = timespec_rem(timespec_now(), item->enqueued);
+		args->latency[i] = ((delay.tv_sec * NSEC_IN_SEC) +
+				    delay.tv_nsec);
+	}
+
+	return NULL;
+}
+
+static int _cmp_uint64(const void *x, const void *y)
+{
+	uint64_t a = *(uint64_t *) x, b = *(uint64_t *) y;
+
+	return (a > b) - (a < b);
+}
+
+static void _bench(const char *name, bool use_ring, int thread_count)
+{
+	DEF_TIMERS;
+	const int per_thread = BENCH_ITEMS_PER_THREAD;
+	const int total = (per_thread * thread_count);
+	pthread_barrier_t start;
+	mpmc_ring_t *ring = NULL;
+	list_t *list = NULL;
+	pthread_t *threads = xcalloc(thread_count, sizeof(*threads));
+	bench_args_t *args = xcalloc(thread_count, sizeof(*args));
+	bench_item_t *items = xcalloc(total, sizeof(*items));
+	uint64_t *latency = xcalloc(total, sizeof(*latency));
+	uint64_t usec;
+
+	if (use_ring)
+		ring = mpmc_ring_create(BENCH_RING_SIZE);
+	else
+		list = list_create(NULL);
+
+	if (pthread_barrier_init(&start, NULL, thread_count))
+		fatal("%s: pthread_barrier_init() failed", __func__);
+
+	for (int i = 0; i < thread_count; i++)
+		args[i] = (bench_args_t) {
+			.ring = ring,
+			.list = list,
+			.start = &start,
+			.count = per_thread,
+			.items = &items[i * per_thread],
+			.latency = &latency[i * per_thread],
+		};
+
+	START_TIMER;
+	for (int i = 0; i < thread_count; i++)
+		slurm_thread_create(NULL, &threads[i], _bench_worker,
+				    &args[i]);
+	for (int i = 0; i < thread_count; i++)
+		slurm_thread_join(threads[i]);
+	END_TIMER;
+
+	usec = MAX(TIMER_DURATION_USEC(), 1);
+	qsort(latency, total, sizeof(*latency), _cmp_uint64);
+
+	info("%s threads=%d items=%d in %s (%.0f items/sec) latency p50=%"PRIu64"ns p99=%"PRIu64"ns p99.9=%"PRIu64"ns max=%"PRIu64"ns",
+	     name, thread_count, total, TIMER_STR(),
+	     ((double) total * USEC_IN_SEC) / usec, latency[total / 2],
+	     latency[(total / 100) * 99], latency[(total / 1000) * 999],
+	     latency[total - 1]);
+
+	(void) pthread_barrier_destroy(&start);
+	FREE_NULL_MPMC_RING(ring);
+	FREE_NULL_LIST(list);
+	xfree(latency);
+	xfree(items);
+	xfree(args);
+	xfree(threads);
+}
+
+int main(void)
+{
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+	log_init("mpmc_ring-bench", log_opts, 0, NULL);
+
+	for (int threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2) {
+		_bench("mpmc_ring", true, threads);
+		_bench("list", false, threads);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+/*****************************************************************************\
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <check.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/mpmc_ring.h"
+#include "src/common/read_config.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/threadpool.h"
+#include "src/common/xmalloc.h"
+
+#define BASIC_RING_SIZE 16
+#define STRESS_RING_SIZE 1024
+#define STRESS_ITEMS 100000
+
+typedef struct {
+	mpmc_ring_t *ring;
+	int id;
+	int count;
+	uint64_t *seen;
+	pthread_mutex_t *seen_mutex;
+} stress_args_t;
+
+START_TEST(test_basic)
+{
+	mpmc_ring_t *ring = mpmc_ring_create(BASIC_RING_SIZE - 1);
+	uintptr_t i;
+
+	ck_assert(mpmc_ring_size(ring) == BASIC_RING_SIZE);
+	ck_assert(mpmc_ring_count(ring) == 0);
+	ck_assert(mpmc_ring_pop(ring) == NULL);
+	ck_assert(mpmc_ring_count(NULL) == 0);
+
+	/* wrap around several times and check ordering */
+	for (int lap = 0; lap < 4; lap++) {
+		for (i = 1; i <= BASIC_RING_SIZE; i++)
+			ck_assert(mpmc_ring_push(ring, (void *) i));
+
+		ck_assert(!mpmc_ring_push(ring, (void *) i));
+		ck_assert(mpmc_ring_count(ring) == BASIC_RING_SIZE);
+
+		for (i = 1; i <= BASIC_RING_SIZE; i++)
+			ck_assert(mpmc_ring_pop(ring) == (void *) i);
+
+		ck_assert(mpmc_ring_pop(ring) == NULL);
+		ck_assert(mpmc_ring_count(ring) == 0);
+	}
+
+	FREE_NULL_MPMC_RING(ring);
+	ck_assert(ring == NULL);
+}
+END_TEST
+
+static void *_stress_producer(void *arg)
+{
+	stress_args_t *args = arg;
+
+	for (int i = 0; i < args->count; i++) {
+		/* encode producer and sequence in pointer, never 0 */
+		uintptr_t value = ((((uintptr_t) args->id) << 32) | (i + 1));
+
+		while (!mpmc_ring_push(args->ring, (void *) value))
+			sched_yield();
+	}
+
+	return NULL;
+}
+
+static void *_stress_consumer(void *arg)
+{
+	stress_args_t *args = arg;
+	uint64_t *last = xcalloc(args->id, sizeof(*last));
+	int popped = 0;
+
+	while (popped < args->count) {
+		uintptr_t value = (uintptr_t) mpmc_ring_pop(args->ring);
+		uint32_t producer, seq;
+
+		if (!value) {
+			sched_yield();
+			continue;
+		}
+
+		producer = (value >> 32);
+		seq = (value & 0xffffffff);
+
+		/* each producer's items must be seen in order */
+		ck_assert(producer < args->id);
+		ck_assert(seq > last[producer]);
+		last[producer] = seq;
+
+		slurm_mutex_lock(args->seen_mutex);
+		args->seen[producer]++;
+		slurm_mutex_unlock(args->seen_mutex);
+
+		popped++;
+	}
+
+	xfree(last);
+	return NULL;
+}
+
+START_TEST(test_stress)
+{
+	static const int producers = 4, consumers = 4;
+	mpmc_ring_t *ring = mpmc_ring_create(STRESS_RING_SIZE);
+	pthread_mutex_t seen_mutex = PTHREAD_MUTEX_INITIALIZER;
+	uint64_t seen[4] = { 0 };
+	pthread_t threads[8];
+	stress_args_t args[8];
+
+	for (int i = 0; i < producers; i++) {
+		args[i] = (stress_args_t) {
+			.ring = ring,
+			.id = i,
+			.count = STRESS_ITEMS,
+		};
+		slurm_thread_create(NULL, &threads[i], _stress_producer,
+				    &args[i]);
+	}
+
+	for (int i = producers; i < (producers + consumers); i++) {
+		args[i] = (stress_args_t) {
+			.ring = ring,
+			/* consumers use id as producer count */
+			.id = producers,
+			.count = STRESS_ITEMS,
+			.seen = seen,
+			.seen_mutex = &seen_mutex,
+		};
+		slurm_thread_create(NULL, &threads[i], _stress_consumer,
+				    &args[i]);
+	}
+
+	for (int i = 0; i < (producers + consumers); i++)
+		slurm_thread_join(threads[i]);
+
+	for (int i = 0; i < producers; i++)
+		ck_assert(seen[i] == STRESS_ITEMS);
+	ck_assert(mpmc_ring_pop(ring) == NULL);
+
+	FREE_NULL_MPMC_RING(ring);
+}
+END_TEST
+
+Suite *suite_mpmc_ring(void)
+{
+	Suite *s = suite_create("mpmc_ring");
+	TCase *tc_core = tcase_create("mpmc_ring");
+
+	tcase_set_timeout(tc_core, 60);
+	tcase_add_test(tc_core, test_basic);
+	tcase_add_test(tc_core, test_stress);
+
+	suite_add_tcase(s, tc_core);
+	return s;
+}
+
+int main(void)
+{
+	int number_failed;
+	enum print_output po = CK_ENV;
+	enum fork_status fs = CK_FORK_GETENV;
+	SRunner *sr = NULL;
+	const char *debug_env = getenv("SLURM_DEBUG");
+	const char *debug_flags_env = getenv("SLURM_DEBUG_FLAGS");
+
+	log_options_t log_opts = LOG_OPTS_INITIALIZER;
+
+	if (debug_env)
+		log_opts.stderr_level = log_string2num(debug_env);
+	if (debug_flags_env)
+		debug_str2flags(debug_flags_env, &slurm_conf.debug_flags);
+
+	log_init("mpmc_ring-test", log_opts, 0, NULL);
+
+	if (log_opts.stderr_level >= LOG_LEVEL_DEBUG) {
+		/* automatically be gdb friendly when debug logging */
+		po = CK_VERBOSE;
+		fs = CK_NOFORK;
+	}
+
+	sr = srunner_create(suite_mpmc_ring());
+	srunner_set_fork_status(sr, fs);
+	srunner_run_all(sr, po);
+	number_failed = srunner_ntests_failed(sr);
+	srunner_free(sr);
+
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
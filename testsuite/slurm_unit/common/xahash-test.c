@@ -38,10 +38,14 @@
 #include "src/common/macros.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/timers.h"
 #include "src/common/xahash.h"
+#include "src/common/xmalloc.h"
 
 #define FIXED_STATE_ENTRIES 1024
 #define FIXED_STATE_OVERCOMMIT_ENTRIES 512
+#define DYNAMIC_STATE_ENTRIES 100000
+#define LOOKUP_MASS_ENTRIES 1000000
 #define KEY_SIZE sizeof(void *)
 
 #define GLOBAL_STATE_MAGIC 0xeae0eef0
@@ -281,6 +285,172 @@ START_TEST(test_fixed_mass)
 }
 END_TEST
 
+START_TEST(test_dynamic_basic)
+{
+	xahash_table_t *ht;
+	global_state_t *gs;
+	state_t *s, *f;
+
+	ht = xahash_new_table(_hash, _match, _on_insert, _on_free,
+			      sizeof(global_state_t), sizeof(state_t), 0);
+
+	ck_assert_msg(ht != NULL, "hashtable created");
+
+	gs = xahash_get_state_ptr(ht);
+	*gs = (global_state_t) {
+		.magic = GLOBAL_STATE_MAGIC,
+	};
+
+	/* verify we don't find anything in an empty table */
+	ck_assert(!xahash_find_entry(ht, NULL, KEY_SIZE));
+	ck_assert(!xahash_find_entry(ht, &ht, KEY_SIZE));
+	ck_assert(!xahash_free_entry(ht, &ht, KEY_SIZE));
+	ck_assert(xahash_foreach_entry(ht, _foreach, NULL) == 0);
+
+	s = xahash_insert_entry(ht, &s, KEY_SIZE);
+	ck_assert(s->magic == STATE_MAGIC);
+	ck_assert(s->key == &s);
+	s->caller_magic = STATE_CALLER_MAGIC;
+
+	/* duplicate insert returns existing entry */
+	f = xahash_insert_entry(ht, &s, KEY_SIZE);
+	ck_assert(f->caller_magic == STATE_CALLER_MAGIC);
+	ck_assert(xahash_foreach_entry(ht, _foreach, NULL) == 1);
+
+	f = xahash_find_entry(ht, &s, KEY_SIZE);
+	ck_assert(f != NULL);
+	ck_assert(f->key == &s);
+	ck_assert(f->caller_magic == STATE_CALLER_MAGIC);
+	ck_assert(!xahash_find_entry(ht, &ht, KEY_SIZE));
+
+	ck_assert(xahash_free_entry(ht, &s, KEY_SIZE));
+	ck_assert(!xahash_free_entry(ht, &s, KEY_SIZE));
+	ck_assert(!xahash_find_entry(ht, &s, KEY_SIZE));
+
+	ck_assert(gs == xahash_get_state_ptr(ht));
+	ck_assert(gs->magic == GLOBAL_STATE_MAGIC);
+
+	FREE_NULL_XAHASH_TABLE(ht);
+}
+END_TEST
+
+START_TEST(test_dynamic_mass)
+{
+	global_state_t *gs;
+	xahash_table_t *ht;
+	/* entries move as the table grows so use keys[] for keys instead */
+	void **keys = xcalloc(DYNAMIC_STATE_ENTRIES, sizeof(*keys));
+
+	ht = xahash_new_table(_hash, _match, _on_insert, _on_free,
+			      sizeof(global_state_t), sizeof(state_t), 0);
+	gs = xahash_get_state_ptr(ht);
+	*gs = (global_state_t) {
+		.magic = GLOBAL_STATE_MAGIC,
+	};
+
+	/* insert all entries while table grows */
+	for (int i = 0; i < DYNAMIC_STATE_ENTRIES; i++) {
+		state_t *f = xahash_insert_entry(ht, &keys[i], KEY_SIZE);
+
+		ck_assert(f->magic == STATE_MAGIC);
+		ck_assert(f->key == &keys[i]);
+		ck_assert(f->caller_magic == 0);
+		f->caller_magic = i;
+	}
+
+	ck_assert(xahash_foreach_entry(ht, _foreach, NULL) ==
+		  DYNAMIC_STATE_ENTRIES);
+
+	/* verify all entries and blobs */
+	for (int i = 0; i < DYNAMIC_STATE_ENTRIES; i++) {
+		state_t *f = xahash_find_entry(ht, &keys[i], KEY_SIZE);
+
+		ck_assert(f != NULL);
+		ck_assert(f->magic == STATE_MAGIC);
+		ck_assert(f->key == &keys[i]);
+		ck_assert(f->caller_magic == i);
+	}
+
+	/* remove every other entry to shift probe sequences */
+	for (int i = 0; i < DYNAMIC_STATE_ENTRIES; i += 2) {
+		ck_assert(xahash_free_entry(ht, &keys[i], KEY_SIZE));
+		ck_assert(!xahash_find_entry(ht, &keys[i], KEY_SIZE));
+	}
+
+	for (int i = 0; i < DYNAMIC_STATE_ENTRIES; i++) {
+		state_t *f = xahash_find_entry(ht, &keys[i], KEY_SIZE);
+
+		if (i % 2) {
+			ck_assert(f != NULL);
+			ck_assert(f->key == &keys[i]);
+			ck_assert(f->caller_magic == i);
+		} else {
+			ck_assert(f == NULL);
+		}
+	}
+
+	ck_assert(xahash_foreach_entry(ht, _foreach, NULL) ==
+		  (DYNAMIC_STATE_ENTRIES / 2));
+
+	/* remove and verify all entries removed */
+	for (int i = 1; i < DYNAMIC_STATE_ENTRIES; i += 2) {
+		ck_assert(xahash_free_entry(ht, &keys[i], KEY_SIZE));
+		ck_assert(!xahash_find_entry(ht, &keys[i], KEY_SIZE));
+	}
+
+	ck_assert(xahash_foreach_entry(ht, _foreach, NULL) == 0);
+
+	ck_assert(gs == xahash_get_state_ptr(ht));
+	ck_assert(gs->magic == GLOBAL_STATE_MAGIC);
+
+	FREE_NULL_XAHASH_TABLE(ht);
+	xfree(keys);
+}
+END_TEST
+
+static xahash_hash_t _id_hash(const void *key, const size_t key_bytes,
+			      void *state)
+{
+	return *(const uint32_t *) key;
+}
+
+static bool _id_match(void *entry, const void *key, const size_t key_bytes,
+		      void *state)
+{
+	return (*(uint32_t *) entry == *(const uint32_t *) key);
+}
+
+static void _id_on_insert(void *entry, const void *key, const size_t key_bytes,
+			  void *state)
+{
+	*(uint32_t *) entry = *(const uint32_t *) key;
+}
+
+/* Report lookup rate of sequential IDs (e.g. job ids) in a dynamic table */
+START_TEST(test_dynamic_lookup_mass)
+{
+	xahash_table_t *ht;
+	uint32_t found = 0;
+
+	ht = xahash_new_table(_id_hash, _id_match, _id_on_insert, NULL, 0,
+			      sizeof(uint32_t), 0);
+
+	for (uint32_t id = 1; id <= LOOKUP_MASS_ENTRIES; id++)
+		xahash_insert_entry(ht, &id, sizeof(id));
+
+	for (uint32_t id = 1; id <= LOOKUP_MASS_ENTRIES; id++) {
+		uint32_t *entry = xahash_find_entry(ht, &id, sizeof(id));
+
+		if (entry && (*entry == id))
+			found++;
+	}
+
+	ck_assert(found == LOOKUP_MASS_ENTRIES);
+
+	FREE_NULL_XAHASH_TABLE(ht);
+}
+END_TEST
+
 Suite *suite_xahash(void)
 {
 	Suite *s = suite_create("xahash");
@@ -288,6 +458,9 @@ Suite *suite_xahash(void)
 
 	tcase_add_test(tc_core, test_fixed_basic);
 	tcase_add_test(tc_core, test_fixed_mass);
+	tcase_add_test(tc_core, test_dynamic_basic);
+	tcase_add_test(tc_core, test_dynamic_mass);
+	tcase_add_test(tc_core, test_dynamic_lookup_mass);
 
 	suite_add_tcase(s, tc_core);
 	return s;